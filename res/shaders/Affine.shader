@@ -0,0 +1,32 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_TexCoord;
+// per-instance Affine2D, one row per attribute
+layout(location = 2) in vec3 a_Row0;
+layout(location = 3) in vec3 a_Row1;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_ViewProj;
+void main()
+{
+   vec3 p = vec3(a_Position, 1.0);
+   gl_Position = u_ViewProj * vec4(dot(a_Row0, p), dot(a_Row1, p), 0.0, 1.0);
+   v_TexCoord = a_TexCoord;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+
+void main()
+{
+  color = texture(u_Texture, v_TexCoord);
+}
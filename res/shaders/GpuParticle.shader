@@ -0,0 +1,47 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+layout(location = 2) in float a_Age;
+layout(location = 3) in float a_Lifetime;
+
+out vec4 v_Color;
+
+uniform mat4 u_ViewProj;
+uniform vec4 u_StartColor;
+uniform vec4 u_EndColor;
+uniform float u_StartSize;
+uniform float u_EndSize;
+// pixels per world unit
+uniform float u_PixelScale;
+
+void main()
+{
+  if (a_Age >= a_Lifetime)
+  {
+    // outside the clip volume, culled before rasterization
+    gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+    gl_PointSize = 1.0;
+    v_Color = vec4(0.0);
+    return;
+  }
+
+  float t = a_Age / a_Lifetime;
+  v_Color = mix(u_StartColor, u_EndColor, t);
+  gl_PointSize = max(2.0 * mix(u_StartSize, u_EndSize, t) * u_PixelScale, 1.0);
+  gl_Position = u_ViewProj * vec4(a_Position, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+  // soft round particle
+  float falloff = 1.0 - smoothstep(0.5, 1.0, length(gl_PointCoord * 2.0 - 1.0));
+  color = vec4(v_Color.rgb, v_Color.a * falloff);
+}
@@ -0,0 +1,77 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec2 a_Velocity;
+layout(location = 2) in float a_Age;
+layout(location = 3) in float a_Lifetime;
+
+// captured by transform feedback, in GpuParticle order
+out vec2 v_Position;
+out vec2 v_Velocity;
+out float v_Age;
+out float v_Lifetime;
+
+// must match GpuParticleSystem::SpawnBatch
+struct SpawnBatch
+{
+  uvec4 Range;     // first slot, count, seed
+  vec4 Area;       // position, half extent
+  vec4 Velocity;   // direction, spread, speed min, speed max
+  vec4 Lifetime;   // min, max
+};
+
+layout(std140) uniform SpawnBuffer
+{
+  SpawnBatch u_SpawnBatches[16];
+};
+
+uniform int u_SpawnBatchCount;
+uniform int u_Capacity;
+uniform float u_DeltaTime;
+uniform float u_Damping;
+uniform vec2 u_Gravity;
+
+uint Hash(uint x)
+{
+  // PCG output permutation
+  uint state = x * 747796405u + 2891336453u;
+  uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+float Random(inout uint state)
+{
+  state = Hash(state);
+  return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+void main()
+{
+  uint slot = uint(gl_VertexID);
+  uint capacity = uint(u_Capacity);
+  for (int i = 0; i < u_SpawnBatchCount; i++)
+  {
+    SpawnBatch batch = u_SpawnBatches[i];
+    if ((slot + capacity - batch.Range.x) % capacity >= batch.Range.y)
+      continue;
+
+    uint state = slot ^ batch.Range.z;
+    vec2 offset = vec2(Random(state), Random(state)) * 2.0 - 1.0;
+    float angle = batch.Velocity.x + (Random(state) * 2.0 - 1.0) * batch.Velocity.y;
+    float speed = mix(batch.Velocity.z, batch.Velocity.w, Random(state));
+    // spread births over the frame so fast emitters don't pulse
+    float age = Random(state) * u_DeltaTime;
+
+    v_Velocity = vec2(cos(angle), sin(angle)) * speed;
+    v_Position = batch.Area.xy + offset * batch.Area.zw + v_Velocity * age;
+    v_Age = age;
+    v_Lifetime = mix(batch.Lifetime.x, batch.Lifetime.y, Random(state));
+    return;
+  }
+
+  v_Velocity = a_Velocity * u_Damping + u_Gravity * u_DeltaTime;
+  v_Position = a_Position + v_Velocity * u_DeltaTime;
+  v_Age = a_Age + u_DeltaTime;
+  v_Lifetime = a_Lifetime;
+}
@@ -0,0 +1,31 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+// per draw: instanced with the command's base instance, or constant values
+// when drawing one mesh at a time
+layout(location = 1) in vec4 a_Transform;
+layout(location = 2) in vec4 a_Color;
+
+out vec4 v_Color;
+
+uniform mat4 u_ViewProj;
+void main()
+{
+   float c = cos(a_Transform.w), s = sin(a_Transform.w);
+   vec2 p = mat2(c, s, -s, c) * (a_Position * a_Transform.z) + a_Transform.xy;
+   gl_Position = u_ViewProj * vec4(p, 0.0, 1.0);
+   v_Color = a_Color;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+  color = v_Color;
+}
@@ -0,0 +1,35 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in float a_Size;
+layout(location = 2) in vec4 a_Color;
+
+out vec4 v_Color;
+out vec2 v_Local;
+
+uniform mat4 u_ViewProj;
+
+const vec2 c_Corners[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+void main()
+{
+  v_Local = c_Corners[gl_VertexID];
+  v_Color = a_Color;
+  gl_Position = u_ViewProj * vec4(a_Position + v_Local * a_Size, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_Local;
+
+void main()
+{
+  // soft round particle
+  float falloff = 1.0 - smoothstep(0.5, 1.0, length(v_Local));
+  color = vec4(v_Color.rgb, v_Color.a * falloff);
+}
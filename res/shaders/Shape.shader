@@ -0,0 +1,111 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec2 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec4 a_Params;
+// position of the next element; locations 4 and 5 are its unused colour and params
+layout(location = 3) in vec2 a_Next;
+
+out vec4 v_Color;
+out vec2 v_Local;
+flat out int v_Type;
+flat out vec2 v_HalfSize;
+flat out vec2 v_Shape;
+
+uniform mat4 u_ViewProj;
+uniform vec2 u_ViewportSize;
+
+const vec2 c_Corners[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+void main()
+{
+  int type = int(a_Params.x);
+  vec2 center = a_Position;
+  vec2 halfSize = vec2(0.0);
+  vec2 axis = vec2(1.0, 0.0);
+  // x: stroke or line width, y: corner radius
+  vec2 shape = a_Params.yz;
+  if (type == 1)
+  {
+    // segment: a box around both round caps, along the segment
+    vec2 delta = a_Next - a_Position;
+    float len = length(delta);
+    axis = len > 0.0 ? delta / len : vec2(1.0, 0.0);
+    center = (a_Position + a_Next) * 0.5;
+    halfSize = vec2(len * 0.5, 0.0);
+  }
+  else if (type == 2)
+  {
+    halfSize = vec2(a_Next.x);
+  }
+  else if (type == 3)
+  {
+    halfSize = a_Next;
+    axis = vec2(cos(a_Params.w), sin(a_Params.w));
+  }
+
+  v_Color = a_Color;
+  v_Type = type;
+  v_HalfSize = halfSize;
+  v_Shape = shape;
+  if (type == 0)
+  {
+    // closes the previous shape; nothing to draw
+    v_Local = vec2(0.0);
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+    return;
+  }
+
+  // world units per pixel, assuming an orthographic view
+  vec2 pixel = 2.0 / (u_ViewportSize * vec2(length(u_ViewProj[0].xy), length(u_ViewProj[1].xy)));
+  float margin = max(pixel.x, pixel.y) + (type == 1 ? shape.x * 0.5 : 0.0);
+  vec2 local = c_Corners[gl_VertexID] * (halfSize + margin);
+  vec2 world = center + axis * local.x + vec2(-axis.y, axis.x) * local.y;
+
+  v_Local = local;
+  gl_Position = u_ViewProj * vec4(world, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_Local;
+flat in int v_Type;
+flat in vec2 v_HalfSize;
+flat in vec2 v_Shape;
+
+void main()
+{
+  // signed distance to the outline in world units, negative inside
+  float distance;
+  if (v_Type == 1)
+  {
+    vec2 q = vec2(max(abs(v_Local.x) - v_HalfSize.x, 0.0), v_Local.y);
+    distance = length(q) - v_Shape.x * 0.5;
+  }
+  else if (v_Type == 2)
+  {
+    distance = length(v_Local) - v_HalfSize.x;
+  }
+  else
+  {
+    float radius = min(v_Shape.y, min(v_HalfSize.x, v_HalfSize.y));
+    vec2 q = abs(v_Local) - v_HalfSize + radius;
+    distance = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+  }
+
+  // strokes run along the inside of circles and rects
+  if (v_Type != 1 && v_Shape.x > 0.0)
+    distance = abs(distance + v_Shape.x * 0.5) - v_Shape.x * 0.5;
+
+  // one pixel wide edge
+  float pixel = length(fwidth(v_Local)) * 0.70710678;
+  float coverage = clamp(0.5 - distance / pixel, 0.0, 1.0);
+  if (coverage <= 0.0)
+    discard;
+  color = vec4(v_Color.rgb, v_Color.a * coverage);
+}
@@ -0,0 +1,44 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in float a_TexIndex;
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+out float v_TexIndex;
+
+uniform mat4 u_ViewProj;
+void main()
+{
+   gl_Position = u_ViewProj * a_Position;
+
+   v_Color = a_Color;
+   v_TexCoord = a_TexCoord;
+   v_TexIndex = a_TexIndex;
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+in float v_TexIndex;
+
+uniform sampler2D u_Textures[16];
+
+void main()
+{
+  // slots from 16 up hold distance fields (text): alpha is the distance to
+  // the outline, 0.5 on it, antialiased over one screen pixel
+  int idx = int(v_TexIndex);
+  bool distanceField = idx >= 16;
+  vec4 texColor = texture(u_Textures[distanceField ? idx - 16 : idx], v_TexCoord);
+  float width = max(fwidth(texColor.a) * 0.5, 0.001);
+  float coverage = smoothstep(0.5 - width, 0.5 + width, texColor.a);
+  color = distanceField ? vec4(v_Color.rgb, v_Color.a * coverage) : texColor * v_Color;
+}
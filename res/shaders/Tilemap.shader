@@ -0,0 +1,48 @@
+#shader vertex
+
+#version 330 core
+layout(location = 0) in float a_Cell;
+layout(location = 1) in float a_Tile;
+
+out vec2 v_TexCoord;
+
+uniform mat4 u_ViewProj;
+// in tiles, so neighbouring chunks meet at exactly the same positions
+uniform vec2 u_ChunkOrigin;
+uniform float u_ChunkSize;
+uniform float u_TileSize;
+// columns, rows
+uniform vec2 u_TilesetSize;
+// half a texel in tileset UV, keeps filtering from bleeding into the next tile
+uniform vec2 u_TexelInset;
+
+const vec2 c_Corners[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main()
+{
+  vec2 corner = c_Corners[gl_VertexID];
+  vec2 cell = vec2(mod(a_Cell, u_ChunkSize), floor(a_Cell / u_ChunkSize));
+
+  // tiles count from the top left of the tileset, UVs from the bottom left
+  float index = a_Tile - 1.0;
+  vec2 tile = vec2(mod(index, u_TilesetSize.x), u_TilesetSize.y - 1.0 - floor(index / u_TilesetSize.x));
+  vec2 uvMin = tile / u_TilesetSize + u_TexelInset;
+  vec2 uvMax = (tile + 1.0) / u_TilesetSize - u_TexelInset;
+  v_TexCoord = mix(uvMin, uvMax, corner);
+
+  gl_Position = u_ViewProj * vec4((u_ChunkOrigin + cell + corner) * u_TileSize, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Tileset;
+
+void main()
+{
+  color = texture(u_Tileset, v_TexCoord);
+}
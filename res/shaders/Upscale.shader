@@ -0,0 +1,77 @@
+#shader vertex
+
+#version 330 core
+out vec2 v_TexCoord;
+
+// one triangle covering the screen
+void main()
+{
+   vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+   v_TexCoord = p;
+   gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Source;
+// the rendered part of the source, in uv
+uniform vec2 u_UVScale;
+uniform vec2 u_TexelSize;
+// 0 bilinear, 1 Catmull-Rom
+uniform int u_Filter;
+
+// clamped to the rendered part, which is the only valid data
+vec3 Tap(vec2 uv)
+{
+  return texture(u_Source, min(uv, u_UVScale - 0.5 * u_TexelSize)).rgb;
+}
+
+// 9 bilinear taps instead of 16 point taps, by folding the two middle weights
+vec3 SampleCatmullRom(vec2 uv)
+{
+  vec2 samplePos = uv / u_TexelSize;
+  vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+  vec2 f = samplePos - texPos1;
+
+  vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+  vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+  vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+  vec2 w3 = f * f * (-0.5 + 0.5 * f);
+  vec2 w12 = w1 + w2;
+
+  vec2 pos0 = (texPos1 - 1.0) * u_TexelSize;
+  vec2 pos3 = (texPos1 + 2.0) * u_TexelSize;
+  vec2 pos12 = (texPos1 + w2 / w12) * u_TexelSize;
+
+  vec3 result =
+    Tap(vec2(pos0.x, pos0.y)) * w0.x * w0.y +
+    Tap(vec2(pos12.x, pos0.y)) * w12.x * w0.y +
+    Tap(vec2(pos3.x, pos0.y)) * w3.x * w0.y +
+    Tap(vec2(pos0.x, pos12.y)) * w0.x * w12.y +
+    Tap(vec2(pos12.x, pos12.y)) * w12.x * w12.y +
+    Tap(vec2(pos3.x, pos12.y)) * w3.x * w12.y +
+    Tap(vec2(pos0.x, pos3.y)) * w0.x * w3.y +
+    Tap(vec2(pos12.x, pos3.y)) * w12.x * w3.y +
+    Tap(vec2(pos3.x, pos3.y)) * w3.x * w3.y;
+
+  // the negative lobes overshoot at hard edges; stay within the nearest texels
+  vec3 a = Tap(texPos1 * u_TexelSize);
+  vec3 b = Tap((texPos1 + vec2(1.0, 0.0)) * u_TexelSize);
+  vec3 c = Tap((texPos1 + vec2(0.0, 1.0)) * u_TexelSize);
+  vec3 d = Tap((texPos1 + vec2(1.0, 1.0)) * u_TexelSize);
+  return clamp(result, min(min(a, b), min(c, d)), max(max(a, b), max(c, d)));
+}
+
+void main()
+{
+  vec2 uv = v_TexCoord * u_UVScale;
+  if (u_Filter == 1)
+    color = vec4(SampleCatmullRom(uv), 1.0);
+  else
+    color = vec4(Tap(uv), 1.0);
+}
@@ -0,0 +1,35 @@
+#include "Affine2D.h"
+
+Affine2D Affine2D::Inverse() const
+{
+  float invDet = 1.0f / Determinant();
+  float a = Row1.y * invDet, b = -Row0.y * invDet;
+  float c = -Row1.x * invDet, d = Row0.x * invDet;
+  return Affine2D({ a, b, -(a * Row0.z + b * Row1.z) }, { c, d, -(c * Row0.z + d * Row1.z) });
+}
+
+glm::mat4 Affine2D::ToMat4() const
+{
+  glm::mat4 result(1.0f);
+  result[0][0] = Row0.x; result[1][0] = Row0.y; result[3][0] = Row0.z;
+  result[0][1] = Row1.x; result[1][1] = Row1.y; result[3][1] = Row1.z;
+  return result;
+}
+
+void Affine2D::TransformPoints(const Affine2D& transform, const glm::vec2* points, glm::vec2* out, unsigned int count)
+{
+  const float a = transform.Row0.x, b = transform.Row0.y, tx = transform.Row0.z;
+  const float c = transform.Row1.x, d = transform.Row1.y, ty = transform.Row1.z;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    float x = points[i].x, y = points[i].y;
+    out[i].x = a * x + b * y + tx;
+    out[i].y = c * x + d * y + ty;
+  }
+}
+
+void Affine2D::Compose(const Affine2D& parent, const Affine2D* locals, Affine2D* out, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    out[i] = parent * locals[i];
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "glm/glm.hpp"
+
+// 2D affine transform stored as the top two rows of a 3x3 matrix:
+//   | Row0.x Row0.y Row0.z |   x' = Row0.x * x + Row0.y * y + Row0.z
+//   | Row1.x Row1.y Row1.z |   y' = Row1.x * x + Row1.y * y + Row1.z
+// 24 bytes instead of the 64 of a glm::mat4, and the rows can be fed to a
+// shader as two vec3 per-instance attributes (see res/shaders/Affine.shader).
+struct Affine2D
+{
+  glm::vec3 Row0;
+  glm::vec3 Row1;
+
+  Affine2D() : Row0(1.0f, 0.0f, 0.0f), Row1(0.0f, 1.0f, 0.0f) {}
+  Affine2D(const glm::vec3& row0, const glm::vec3& row1) : Row0(row0), Row1(row1) {}
+
+  static Affine2D Identity() { return Affine2D(); }
+  static Affine2D Translation(const glm::vec2& offset)
+  {
+    return Affine2D({ 1.0f, 0.0f, offset.x }, { 0.0f, 1.0f, offset.y });
+  }
+  static Affine2D Rotation(float radians)
+  {
+    float c = glm::cos(radians), s = glm::sin(radians);
+    return Affine2D({ c, -s, 0.0f }, { s, c, 0.0f });
+  }
+  static Affine2D Scale(const glm::vec2& scale)
+  {
+    return Affine2D({ scale.x, 0.0f, 0.0f }, { 0.0f, scale.y, 0.0f });
+  }
+  // Translation(position) * Rotation(radians) * Scale(scale) without the two
+  // multiplies.
+  static Affine2D TRS(const glm::vec2& position, float radians, const glm::vec2& scale)
+  {
+    float c = glm::cos(radians), s = glm::sin(radians);
+    return Affine2D({ c * scale.x, -s * scale.y, position.x }, { s * scale.x, c * scale.y, position.y });
+  }
+
+  glm::vec2 TransformPoint(const glm::vec2& p) const
+  {
+    return { Row0.x * p.x + Row0.y * p.y + Row0.z, Row1.x * p.x + Row1.y * p.y + Row1.z };
+  }
+  glm::vec2 TransformVector(const glm::vec2& v) const
+  {
+    return { Row0.x * v.x + Row0.y * v.y, Row1.x * v.x + Row1.y * v.y };
+  }
+
+  // this * other: other is applied first
+  Affine2D operator*(const Affine2D& other) const
+  {
+    return Affine2D(
+      { Row0.x * other.Row0.x + Row0.y * other.Row1.x,
+        Row0.x * other.Row0.y + Row0.y * other.Row1.y,
+        Row0.x * other.Row0.z + Row0.y * other.Row1.z + Row0.z },
+      { Row1.x * other.Row0.x + Row1.y * other.Row1.x,
+        Row1.x * other.Row0.y + Row1.y * other.Row1.y,
+        Row1.x * other.Row0.z + Row1.y * other.Row1.z + Row1.z });
+  }
+  Affine2D& operator*=(const Affine2D& other) { return *this = *this * other; }
+
+  float Determinant() const { return Row0.x * Row1.y - Row0.y * Row1.x; }
+  // Undefined for singular transforms (zero scale).
+  Affine2D Inverse() const;
+  // For handing the transform to code that still wants a 4x4 matrix.
+  glm::mat4 ToMat4() const;
+
+  // Batched variants, written as plain loops over contiguous arrays so the
+  // compiler can vectorise them. out may alias the input.
+  static void TransformPoints(const Affine2D& transform, const glm::vec2* points, glm::vec2* out, unsigned int count);
+  static void Compose(const Affine2D& parent, const Affine2D* locals, Affine2D* out, unsigned int count);
+};
+
+static_assert(sizeof(Affine2D) == 6 * sizeof(float), "Affine2D must stay tightly packed for use as vertex data");
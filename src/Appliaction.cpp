@@ -1,6 +1,7 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 
@@ -10,6 +11,18 @@
 #include "Shader.h"
 #include "Renderer.h"
 #include "Texture.h"
+#include "FrameClock.h"
+#include "FrameAllocator.h"
+#include "GLCapabilities.h"
+#include "VertexFormat.h"
+#include "RenderTargetPool.h"
+#include "PostEffects.h"
+#include "DynamicResolution.h"
+#include "FrameCapture.h"
+#include "RegressionRunner.h"
+#include "RenderThread.h"
+#include "ImGuiDrawSnapshot.h"
+#include "JobSystem.h"
 #include "vendor/glm/glm.hpp"
 #include "vendor/glm/matrix.hpp"
 #include "Vendor/glm/ext/matrix_clip_space.hpp"
@@ -19,9 +32,26 @@
 #include "tests/Texture2D.h"
 #include "tests/TestClearColor.h"
 #include "tests/TestBatchRender.h"
+#include "tests/TestStress.h"
+#include "tests/TestJobSystem.h"
+#include "tests/TestSpriteTransform.h"
+#include "tests/TestGeometryPool.h"
+#include "tests/TestMultiDrawIndirect.h"
+#include "tests/TestSpatialCulling.h"
+#include "tests/TestRenderTargets.h"
+#include "tests/TestText.h"
+#include "tests/TestShapes.h"
+#include "tests/TestParticles.h"
+#include "tests/TestGpuParticles.h"
+#include "tests/TestTilemap.h"
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-int main();
+int main(int argc, char** argv);
 void processInput(GLFWwindow* window);
+void showFrameTiming(FrameClock& clock);
+void showRenderThread(RenderThread& renderThread, bool& useRenderThread);
+void showPostProcess(PostProcessStack& postProcess);
+void showDynamicResolution(DynamicResolution& dynamicResolution);
+void showFrameCapture(FrameCapture& frameCapture);
 
 
 // settings
@@ -30,8 +60,11 @@ const unsigned int SCR_HEIGHT = 600;
 
 
 
-int main()
+int main(int argc, char** argv)
 {
+  RegressionOptions regressionOptions;
+  bool regression = RegressionRunner::ParseArguments(argc, argv, regressionOptions);
+
   // glfw: initialize and configure
   // ------------------------------
   glfwInit();
@@ -42,6 +75,9 @@ int main()
 #ifdef __APPLE__
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+  // regression runs render into a fixed size back buffer nobody needs to see
+  if (regression)
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
 
   // glfw window creation
   // --------------------
@@ -59,7 +95,7 @@ int main()
   * Ĭ£Ϊ0
   * Ϊ1ÿ֡һ
   **/
-  glfwSwapInterval(1);
+  glfwSwapInterval(regression ? 0 : 1);
 
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
@@ -70,6 +106,11 @@ int main()
     std::cout << "Failed to initialize GLAD" << std::endl;
     return -1;
   }
+  GLCapabilities::Initialize((GLADloadproc)glfwGetProcAddress);
+
+  int framebufferWidth, framebufferHeight;
+  glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+  RenderTargetPool::Get().OnWindowResize(framebufferWidth, framebufferHeight);
 
 
 
@@ -91,6 +132,8 @@ int main()
    **/
   GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
+  JobSystem::Initialize();
+
   Renderer renderer;
 
   ImGui::CreateContext();
@@ -108,58 +151,156 @@ int main()
   testMenu->RegisterTest<test::TestClearColor>("Clear Color");
   testMenu->RegisterTest<test::Texture2D>("Texture 2D");
   testMenu->RegisterTest<test::TestBatchRender>("BatchRender");
-
+  testMenu->RegisterTest<test::TestStressSprites>("Stress: Sprites");
+  testMenu->RegisterTest<test::TestStressTextureSwitch>("Stress: Texture Switching");
+  testMenu->RegisterTest<test::TestStressUniforms>("Stress: Uniform Uploads");
+  testMenu->RegisterTest<test::TestStressSmallDraws>("Stress: Small Draws");
+  testMenu->RegisterTest<test::TestStressMeshSwitch>("Stress: Mesh Switching");
+  testMenu->RegisterTest<test::TestStressOverdraw>("Stress: Overdraw");
+  testMenu->RegisterTest<test::TestJobSystem>("Job System Scaling");
+  testMenu->RegisterTest<test::TestSpriteTransform>("SIMD Sprite Transform");
+  testMenu->RegisterTest<test::TestGeometryPool>("Geometry Pool");
+  testMenu->RegisterTest<test::TestMultiDrawIndirect>("Stress: Multi-Draw Indirect");
+  testMenu->RegisterTest<test::TestSpatialCulling>("Spatial Culling");
+  testMenu->RegisterTest<test::TestRenderTargets>("Render Targets");
+  testMenu->RegisterTest<test::TestText>("SDF Text");
+  testMenu->RegisterTest<test::TestShapes>("Vector Shapes");
+  testMenu->RegisterTest<test::TestParticles>("Stress: Particles");
+  testMenu->RegisterTest<test::TestGpuParticles>("Stress: GPU Particles");
+  testMenu->RegisterTest<test::TestTilemap>("Tilemap");
+
+  FrameClock& clock = FrameClock::Get();
+  RenderThread renderThread(window);
+  bool useRenderThread = false;
+  // the render thread draws the UI of frame N while frame N+1 is built
+  ImGuiDrawSnapshot imguiSnapshots[RenderThread::MaxFramesInFlight + 1];
+
+  int exitCode = 0;
+  if (regression)
   {
-  //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-
-  // render loop
-  // -----------
-  while (!glfwWindowShouldClose(window))
+    RegressionRunner runner(window, regressionOptions);
+    exitCode = runner.Run(*testMenu) == 0 ? 0 : 1;
+    delete testMenu;
+    VertexFormat::ClearCache();
+    RenderTargetPool::Get().Clear();
+  }
+  else
   {
-    // input
-    // -----
-    processInput(window);
-
-    //glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-    renderer.Clear();
-
-
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
-    if (currentTest)
+    //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+    PostProcessStack postProcess;
+    postProcess.AddEffect(std::make_unique<BloomEffect>());
+    postProcess.AddEffect(std::make_unique<TonemapEffect>());
+    postProcess.AddEffect(std::make_unique<ColorGradeEffect>());
+    postProcess.AddEffect(std::make_unique<VignetteEffect>());
+    DynamicResolution dynamicResolution;
+    FrameCapture frameCapture;
+
+    // render loop
+    // -----------
+    while (!glfwWindowShouldClose(window))
     {
-      currentTest->OnUpdate(.0f);
-      currentTest->OnRender();
-
-      ImGui::Begin("Test");
+      // input
+      // -----
+      processInput(window);
 
-      if (currentTest != testMenu && ImGui::Button("<-"))
+      // the GL context can only change threads between frames
+      if (useRenderThread != renderThread.IsRunning())
       {
-        delete currentTest;
-        currentTest = testMenu;
+        if (useRenderThread)
+          renderThread.Start();
+        else
+          renderThread.Stop();
       }
-      currentTest->OnImGuiRender();
-      ImGui::End();
-    }
+      bool threaded = renderThread.IsRunning();
+      // the arena recycled here belongs to a frame the render thread has finished
+      BufferedFrameAllocator::Get().BeginFrame(threaded ? renderThread.GetRecordingIndex() : 0);
+
+      //glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+      Renderer::Submit([&renderer]() {
+        Renderer::ResetStats();
+        RenderTargetPool::Get().BeginFrame();
+        renderer.Clear();
+      });
+
+
+      // the OpenGL backend only touches GL here to create its device objects,
+      // which already happened on the first (single threaded) frame
+      if (!threaded)
+        ImGui_ImplOpenGL3_NewFrame();
+      ImGui_ImplGlfw_NewFrame();
+      ImGui::NewFrame();
+      float deltaTime = clock.Tick();
+      test::Test* finishedTest = nullptr;
+      if (currentTest)
+      {
+        while (clock.StepFixed())
+          currentTest->OnFixedUpdate(clock.GetFixedDeltaTime());
+        currentTest->OnUpdate(deltaTime);
+
+        float alpha = clock.GetAlpha();
+        postProcess.BeginScene();
+        dynamicResolution.BeginScene();
+        if (threaded && !currentTest->SupportsRenderThread())
+          Renderer::SubmitAndWait([currentTest, alpha]() { currentTest->OnRender(alpha); });
+        else
+          currentTest->OnRender(alpha);
+        dynamicResolution.EndScene();
+        postProcess.EndScene();
+        frameCapture.CaptureFrame();
+
+        ImGui::Begin("Test");
+
+        if (currentTest != testMenu && ImGui::Button("<-"))
+        {
+          // commands recorded this frame may still reference it
+          finishedTest = currentTest;
+          currentTest = testMenu;
+        }
+        currentTest->OnImGuiRender();
+        ImGui::End();
+      }
+      showFrameTiming(clock);
+      showRenderThread(renderThread, useRenderThread);
+      showPostProcess(postProcess);
+      showDynamicResolution(dynamicResolution);
+      showFrameCapture(frameCapture);
 
 
 
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+      ImGui::Render();
+      if (threaded)
+      {
+        ImGuiDrawSnapshot& snapshot = imguiSnapshots[renderThread.GetRecordingIndex()];
+        snapshot.Capture(ImGui::GetDrawData());
+        Renderer::Submit([&snapshot]() { ImGui_ImplOpenGL3_RenderDrawData(snapshot.GetDrawData()); });
 
-    // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
-    // -------------------------------------------------------------------------------
-    glfwSwapBuffers(window);
-    glfwPollEvents();
-  }
-  delete currentTest;
-  if (currentTest != testMenu)
-  {
-    delete testMenu;
+        // swapping happens on the render thread once it has executed the frame
+        renderThread.EndFrame();
+      }
+      else
+      {
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        // glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
+        // -------------------------------------------------------------------------------
+        glfwSwapBuffers(window);
+      }
+      glfwPollEvents();
+
+      if (finishedTest)
+        Renderer::SubmitAndWait([finishedTest]() { delete finishedTest; });
+    }
+    renderThread.Stop();
+    delete currentTest;
+    if (currentTest != testMenu)
+    {
+      delete testMenu;
+    }
+    VertexFormat::ClearCache();
+    RenderTargetPool::Get().Clear();
   }
-}
 
   // glfw: terminate, clearing all previously allocated GLFW resources.
   // ------------------------------------------------------------------
@@ -168,9 +309,11 @@ int main()
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
 
+  JobSystem::Shutdown();
+
   glfwDestroyWindow(window);
   glfwTerminate();
-  return 0;
+  return exitCode;
 }
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
@@ -181,11 +324,164 @@ void processInput(GLFWwindow* window)
     glfwSetWindowShouldClose(window, true);
 }
 
+// frame time history plus the fixed-step settings
+// ---------------------------------------------------------------------------------------------
+void showFrameTiming(FrameClock& clock)
+{
+  ImGui::Begin("Frame Timing");
+
+  char overlay[64];
+  snprintf(overlay, sizeof(overlay), "avg %.2f ms  max %.2f ms", clock.GetAverageFrameTime(), clock.GetMaxFrameTime());
+  ImGui::PlotLines("##frametimes", clock.GetHistory(), FrameClock::HistorySize, clock.GetHistoryOffset(),
+    overlay, 0.0f, 50.0f, ImVec2(0, 60));
+
+  float rate = clock.GetFixedRate();
+  if (ImGui::SliderFloat("Fixed rate (Hz)", &rate, 10.0f, 240.0f, "%.0f"))
+    clock.SetFixedRate(rate);
+  int maxSteps = clock.GetMaxStepsPerFrame();
+  if (ImGui::SliderInt("Max steps/frame", &maxSteps, 1, 32))
+    clock.SetMaxStepsPerFrame(maxSteps);
+
+  ImGui::Text("Steps this frame: %d  alpha: %.2f", clock.GetStepsThisFrame(), clock.GetAlpha());
+  ImGui::Text("Dropped steps: %u", clock.GetDroppedSteps());
+
+  BufferedFrameAllocator& frameAllocator = BufferedFrameAllocator::Get();
+  const FrameAllocator& arena = frameAllocator.GetCurrent();
+  ImGui::Text("Frame arena: %.1f / %.1f KB, high water %.1f KB", arena.GetUsed() / 1024.0f, arena.GetCapacity() / 1024.0f,
+    frameAllocator.GetHighWaterMark() / 1024.0f);
+  if (arena.GetOverflowBlocks())
+    ImGui::Text("Frame arena overflowed into %u heap blocks", arena.GetOverflowBlocks());
+  ImGui::End();
+}
+
+// toggles the dedicated render thread and shows how the two threads overlap
+// ---------------------------------------------------------------------------------------------
+void showRenderThread(RenderThread& renderThread, bool& useRenderThread)
+{
+  ImGui::Begin("Render Thread");
+  ImGui::Checkbox("Render on a dedicated thread", &useRenderThread);
+
+  int framesInFlight = renderThread.GetFramesInFlight();
+  if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, RenderThread::MaxFramesInFlight))
+    renderThread.SetFramesInFlight(framesInFlight);
+
+  if (renderThread.IsRunning())
+  {
+    ImGui::Text("Render thread: %.2f ms/frame", renderThread.GetRenderTime());
+    ImGui::Text("Main thread waited: %.2f ms", renderThread.GetWaitTime());
+  }
+  ImGui::End();
+}
+
+// effect order, parameters and how many fullscreen passes they cost
+// ---------------------------------------------------------------------------------------------
+void showPostProcess(PostProcessStack& postProcess)
+{
+  ImGui::Begin("Post Processing");
+  bool enabled = postProcess.IsEnabled();
+  if (ImGui::Checkbox("Enabled", &enabled))
+    postProcess.SetEnabled(enabled);
+  ImGui::SameLine();
+  bool fusion = postProcess.IsFusing();
+  if (ImGui::Checkbox("Fuse per-pixel effects", &fusion))
+    postProcess.SetFusion(fusion);
+
+  for (size_t i = 0; i < postProcess.GetEffectCount(); i++)
+  {
+    PostEffect& effect = postProcess.GetEffect(i);
+    ImGui::PushID((int)i);
+    ImGui::Separator();
+    ImGui::Checkbox(effect.GetName(), &effect.Enabled);
+    ImGui::SameLine();
+    if (ImGui::ArrowButton("up", ImGuiDir_Up))
+      postProcess.MoveEffect(i, i - 1);
+    ImGui::SameLine();
+    if (ImGui::ArrowButton("down", ImGuiDir_Down))
+      postProcess.MoveEffect(i, i + 1);
+    for (PostEffectParam& param : effect.GetParams())
+      ImGui::SliderFloat(param.Name, &param.Value, param.Min, param.Max);
+    ImGui::PopID();
+  }
+
+  ImGui::Separator();
+  ImGui::Text("Full resolution passes: %u", postProcess.GetPassCount());
+  ImGui::End();
+}
+
+// scale controller settings, and what it currently picks
+// ---------------------------------------------------------------------------------------------
+void showDynamicResolution(DynamicResolution& dynamicResolution)
+{
+  ImGui::Begin("Dynamic Resolution");
+  bool enabled = dynamicResolution.IsEnabled();
+  if (ImGui::Checkbox("Enabled", &enabled))
+    dynamicResolution.SetEnabled(enabled);
+
+  DynamicResolution::Settings& settings = dynamicResolution.GetSettings();
+  ImGui::Checkbox("Adapt to GPU time", &settings.Adaptive);
+  if (settings.Adaptive)
+  {
+    ImGui::SliderFloat("Target GPU ms", &settings.TargetTime, 1.0f, 33.0f, "%.1f");
+    ImGui::SliderFloat("Min scale", &settings.MinScale, 0.25f, 1.0f, "%.2f");
+    ImGui::SliderFloat("Max scale", &settings.MaxScale, settings.MinScale, 1.0f, "%.2f");
+  }
+  else
+  {
+    ImGui::SliderFloat("Scale", &settings.ManualScale, 0.25f, 1.0f, "%.2f");
+  }
+  int filter = (int)settings.Filter;
+  if (ImGui::Combo("Upscale filter", &filter, "Bilinear\0Catmull-Rom\0"))
+    settings.Filter = (UpscaleFilter)filter;
+
+  if (enabled)
+  {
+    float gpuTime = dynamicResolution.GetGpuTime();
+    ImGui::Separator();
+    ImGui::Text("Scale: %.2f (%d x %d)", dynamicResolution.GetScale(), dynamicResolution.GetRenderWidth(), dynamicResolution.GetRenderHeight());
+    ImGui::Text("Scene GPU time: %.2f ms", gpuTime);
+    ImGui::Text("Headroom: %+.2f ms (%+.0f%%)", settings.TargetTime - gpuTime, 100.0f * (settings.TargetTime - gpuTime) / settings.TargetTime);
+  }
+  ImGui::End();
+}
+
+// screenshots and Y4M recording of the scene (without the UI)
+// ---------------------------------------------------------------------------------------------
+void showFrameCapture(FrameCapture& frameCapture)
+{
+  static int screenshotIndex = 0, recordingIndex = 0;
+  char path[64];
+
+  ImGui::Begin("Frame Capture");
+  if (ImGui::Button("Screenshot"))
+  {
+    snprintf(path, sizeof(path), "screenshot_%03d.png", screenshotIndex++);
+    frameCapture.RequestScreenshot(path);
+  }
+  ImGui::SameLine();
+  if (!frameCapture.IsRecording() && ImGui::Button("Record"))
+  {
+    snprintf(path, sizeof(path), "capture_%03d.y4m", recordingIndex++);
+    frameCapture.StartRecording(path, 60);
+  }
+  else if (frameCapture.IsRecording() && ImGui::Button("Stop"))
+  {
+    frameCapture.StopRecording();
+  }
+
+  ImGui::Text("Captured: %u  dropped: %u  queued: %u", frameCapture.GetCapturedFrames(), frameCapture.GetDroppedFrames(),
+    frameCapture.GetQueuedFrames());
+  ImGui::Text("Readback latency: %.1f frames, encode: %.2f ms", frameCapture.GetReadbackLatency(), frameCapture.GetEncodeTime());
+  ImGui::End();
+}
+
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
 // ---------------------------------------------------------------------------------------------
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
   // make sure the viewport matches the new window dimensions; note that width and 
   // height will be significantly larger than specified on retina displays.
-  glViewport(0, 0, width, height);
+  Renderer::Submit([=]() {
+    glViewport(0, 0, width, height);
+    RenderTargetPool::Get().OnWindowResize(width, height);
+  });
 }
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "BatchRenderer.h"
+#include "JobSystem.h"
+#include "SpriteTransform.h"
+#include "FrameAllocator.h"
+
+#include <algorithm>
+#include <cfloat>
+
+static const glm::vec2 s_QuadPositions[4] = {
+  { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f }
+};
+
+static const glm::vec2 s_QuadTexCoords[4] = {
+  { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+};
+
+// Transposes a block of sprites to SoA, runs the SIMD transform kernel on it
+// and writes the resulting quads.
+static void WriteSpriteVertices(QuadVertex* vertices, const Sprite* sprites, unsigned int count)
+{
+  const unsigned int BlockSize = 256;
+  float positionX[BlockSize], positionY[BlockSize], scaleX[BlockSize], scaleY[BlockSize], rotation[BlockSize], pivot[BlockSize];
+  float cornersX[4][BlockSize], cornersY[4][BlockSize];
+  for (unsigned int i = 0; i < BlockSize; i++)
+    pivot[i] = 0.5f;
+
+  SpriteTransformInput in = { positionX, positionY, scaleX, scaleY, rotation, pivot, pivot };
+  SpriteTransformOutput out = { { cornersX[0], cornersX[1], cornersX[2], cornersX[3] }, { cornersY[0], cornersY[1], cornersY[2], cornersY[3] } };
+
+  for (unsigned int first = 0; first < count; first += BlockSize)
+  {
+    unsigned int blockCount = count - first < BlockSize ? count - first : BlockSize;
+    const Sprite* block = sprites + first;
+    for (unsigned int i = 0; i < blockCount; i++)
+    {
+      positionX[i] = block[i].Position.x;
+      positionY[i] = block[i].Position.y;
+      scaleX[i] = block[i].Size.x;
+      scaleY[i] = block[i].Size.y;
+      rotation[i] = block[i].Rotation;
+    }
+
+    SpriteTransform::Transform(in, blockCount, out);
+
+    QuadVertex* vertex = vertices + first * 4;
+    for (unsigned int i = 0; i < blockCount; i++)
+    {
+      for (int corner = 0; corner < 4; corner++, vertex++)
+      {
+        vertex->Position = { cornersX[corner][i], cornersY[corner][i], 0.0f };
+        vertex->Color = block[i].Color;
+        vertex->TexCoord = s_QuadTexCoords[corner];
+        vertex->TexIndex = block[i].TextureSlot;
+      }
+    }
+  }
+}
+
+void GetSpriteBounds(const Sprite& sprite, glm::vec2& min, glm::vec2& max)
+{
+  float c = glm::abs(glm::cos(sprite.Rotation)), s = glm::abs(glm::sin(sprite.Rotation));
+  glm::vec2 halfExtent = 0.5f * glm::vec2(sprite.Size.x * c + sprite.Size.y * s, sprite.Size.x * s + sprite.Size.y * c);
+  min = sprite.Position - halfExtent;
+  max = sprite.Position + halfExtent;
+}
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads)
+  : m_MaxQuads(maxQuads), m_QuadCount(0), m_TextureSlots{}, m_TextureSlotCount(1), m_ViewProj(1.0f),
+  m_Culling(true), m_ViewMin(-1.0f), m_ViewMax(1.0f)
+{
+  m_Vertices.resize(m_MaxQuads * 4);
+
+  m_VAO = std::make_unique<VertexArray>();
+  m_VertexBuffer = std::make_unique<VertexBuffer>(m_MaxQuads * 4 * (unsigned int)sizeof(QuadVertex));
+  m_VAO->AddBuffer<QuadVertex>(*m_VertexBuffer);
+
+  std::vector<unsigned int> indices = GenerateQuadIndices(m_MaxQuads);
+  m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+  m_SpriteVAO = std::make_unique<VertexArray>();
+  m_SpriteVertexBuffer = std::make_unique<VertexBuffer>(MaxSpritesPerBatch * 4 * (unsigned int)sizeof(QuadVertex));
+  m_SpriteVAO->AddBuffer<QuadVertex>(*m_SpriteVertexBuffer);
+  indices = GenerateQuadIndices(MaxSpritesPerBatch);
+  m_SpriteIndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+  m_Shader = std::make_unique<Shader>("res/shaders/Sprite.shader");
+  m_Shader->Bind();
+  int samplers[MaxTextureSlots];
+  for (unsigned int i = 0; i < MaxTextureSlots; i++)
+    samplers[i] = i;
+  m_Shader->SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+
+  m_ShapeVAO = std::make_unique<VertexArray>();
+  m_ShapeBuffer = std::make_unique<VertexBuffer>(MaxShapeElements * (unsigned int)sizeof(ShapeElement));
+  // the second binding reads the same stream one element ahead
+  m_ShapeVAO->AddBuffer<ShapeElement>(*m_ShapeBuffer, 1);
+  m_ShapeVAO->AddBuffer<ShapeElement>(*m_ShapeBuffer, 1, (unsigned int)sizeof(ShapeElement));
+  indices = GenerateQuadIndices(1);
+  m_ShapeIndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+  m_ShapeShader = std::make_unique<Shader>("res/shaders/Shape.shader");
+  m_ShapeElements.reserve(MaxShapeElements);
+
+  unsigned int white = 0xffffffff;
+  m_WhiteTexture = std::make_unique<Texture>(1, 1, &white);
+  m_TextureSlots[0] = m_WhiteTexture.get();
+}
+
+BatchRenderer::~BatchRenderer()
+{
+}
+
+void BatchRenderer::Begin(const glm::mat4& viewProj)
+{
+  m_ViewProj = viewProj;
+  m_QuadCount = 0;
+  m_TextureSlotCount = 1;
+  m_ShapeElements.clear();
+  m_CullStats = BatchCullStats();
+
+  // unproject the clip-space corners; exact for the 2D orthographic views used here
+  glm::mat4 inverse = glm::inverse(viewProj);
+  m_ViewMin = glm::vec2(FLT_MAX);
+  m_ViewMax = glm::vec2(-FLT_MAX);
+  for (int i = 0; i < 4; i++)
+  {
+    glm::vec4 corner = inverse * glm::vec4(s_QuadPositions[i] * 2.0f, 0.0f, 1.0f);
+    glm::vec2 world = glm::vec2(corner) / corner.w;
+    m_ViewMin = glm::min(m_ViewMin, world);
+    m_ViewMax = glm::max(m_ViewMax, world);
+  }
+}
+
+void BatchRenderer::End()
+{
+  Flush();
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
+{
+  DrawQuad(position, size, 0.0f, color, nullptr);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color, const Texture* texture)
+{
+  DrawQuad(Affine2D::TRS(position, rotation, size), color, texture);
+}
+
+void BatchRenderer::DrawQuad(const Affine2D& transform, const glm::vec4& color, const Texture* texture)
+{
+  glm::vec2 corners[4];
+  for (int i = 0; i < 4; i++)
+    corners[i] = transform.TransformPoint(s_QuadPositions[i]);
+  AddQuad(corners, s_QuadTexCoords, color, texture);
+}
+
+void BatchRenderer::DrawString(Font& font, const std::string& text, const glm::vec2& position, float size, const glm::vec4& color)
+{
+  m_GlyphQuads.clear();
+  font.LayoutText(text, position, size, m_GlyphQuads);
+
+  for (const GlyphQuad& glyph : m_GlyphQuads)
+  {
+    glm::vec2 corners[4] = { glyph.Min, { glyph.Max.x, glyph.Min.y }, glyph.Max, { glyph.Min.x, glyph.Max.y } };
+    glm::vec2 texCoords[4] = { glyph.UVMin, { glyph.UVMax.x, glyph.UVMin.y }, glyph.UVMax, { glyph.UVMin.x, glyph.UVMax.y } };
+    AddQuad(corners, texCoords, color, &font.GetAtlas(), true);
+  }
+}
+
+void BatchRenderer::AddQuad(const glm::vec2* corners, const glm::vec2* texCoords, const glm::vec4& color, const Texture* texture,
+  bool distanceField)
+{
+  if (m_Culling)
+  {
+    glm::vec2 min = glm::min(glm::min(corners[0], corners[1]), glm::min(corners[2], corners[3]));
+    glm::vec2 max = glm::max(glm::max(corners[0], corners[1]), glm::max(corners[2], corners[3]));
+    if (max.x < m_ViewMin.x || min.x > m_ViewMax.x || max.y < m_ViewMin.y || min.y > m_ViewMax.y)
+    {
+      m_CullStats.Culled++;
+      return;
+    }
+  }
+  m_CullStats.Visible++;
+
+  if (!m_ShapeElements.empty())
+    FlushShapes();
+  if (m_QuadCount == m_MaxQuads)
+    Flush();
+
+  float texIndex = GetTextureSlot(texture);
+  // the shader reads slots past MaxTextureSlots as distance fields
+  if (distanceField)
+    texIndex += MaxTextureSlots;
+
+  QuadVertex* vertex = &m_Vertices[m_QuadCount * 4];
+  for (int i = 0; i < 4; i++)
+  {
+    vertex[i].Position = glm::vec3(corners[i], 0.0f);
+    vertex[i].Color = color;
+    vertex[i].TexCoord = texCoords[i];
+    vertex[i].TexIndex = texIndex;
+  }
+  m_QuadCount++;
+}
+
+void BatchRenderer::DrawLine(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color)
+{
+  glm::vec2 halfWidth(width * 0.5f);
+  if (!IsShapeVisible(glm::min(from, to) - halfWidth, glm::max(from, to) + halfWidth))
+    return;
+
+  ShapeElement* elements = AllocateShapes(2);
+  elements[0] = { from, color, glm::vec4((float)ShapeType::Segment, width, 0.0f, 0.0f) };
+  elements[1] = { to, color, glm::vec4(0.0f) };
+}
+
+void BatchRenderer::DrawCircle(const glm::vec2& center, float radius, const glm::vec4& color, float stroke)
+{
+  if (!IsShapeVisible(center - radius, center + radius))
+    return;
+
+  ShapeElement* elements = AllocateShapes(2);
+  elements[0] = { center, color, glm::vec4((float)ShapeType::Circle, stroke, 0.0f, 0.0f) };
+  elements[1] = { glm::vec2(radius, 0.0f), color, glm::vec4(0.0f) };
+}
+
+void BatchRenderer::DrawRect(const glm::vec2& center, const glm::vec2& size, const glm::vec4& color, float cornerRadius,
+  float stroke, float rotation)
+{
+  float c = glm::abs(glm::cos(rotation)), s = glm::abs(glm::sin(rotation));
+  glm::vec2 halfExtent = 0.5f * glm::vec2(size.x * c + size.y * s, size.x * s + size.y * c);
+  if (!IsShapeVisible(center - halfExtent, center + halfExtent))
+    return;
+
+  ShapeElement* elements = AllocateShapes(2);
+  elements[0] = { center, color, glm::vec4((float)ShapeType::Rect, stroke, cornerRadius, rotation) };
+  elements[1] = { size * 0.5f, color, glm::vec4(0.0f) };
+}
+
+void BatchRenderer::DrawPolyline(const glm::vec2* points, unsigned int count, float width, const glm::vec4& color, bool closed)
+{
+  if (count < 2)
+    return;
+
+  glm::vec2 min(FLT_MAX), max(-FLT_MAX);
+  for (unsigned int i = 0; i < count; i++)
+  {
+    min = glm::min(min, points[i]);
+    max = glm::max(max, points[i]);
+  }
+  glm::vec2 halfWidth(width * 0.5f);
+  if (!IsShapeVisible(min - halfWidth, max + halfWidth))
+    return;
+
+  // long polylines continue in the next batch from the point this one ended on
+  glm::vec4 params((float)ShapeType::Segment, width, 0.0f, 0.0f);
+  unsigned int total = closed ? count + 1 : count;
+  for (unsigned int first = 0; first + 1 < total;)
+  {
+    unsigned int chunk = total - first < MaxShapeElements ? total - first : MaxShapeElements;
+    ShapeElement* elements = AllocateShapes(chunk);
+    for (unsigned int i = 0; i < chunk; i++)
+      elements[i] = { points[(first + i) % count], color, params };
+    elements[chunk - 1].Params = glm::vec4(0.0f);
+    first += chunk - 1;
+  }
+}
+
+bool BatchRenderer::IsShapeVisible(const glm::vec2& min, const glm::vec2& max)
+{
+  if (m_Culling && (max.x < m_ViewMin.x || min.x > m_ViewMax.x || max.y < m_ViewMin.y || min.y > m_ViewMax.y))
+  {
+    m_CullStats.Culled++;
+    return false;
+  }
+  m_CullStats.Visible++;
+  return true;
+}
+
+ShapeElement* BatchRenderer::AllocateShapes(unsigned int count)
+{
+  if (m_QuadCount)
+    FlushQuads();
+  if (m_ShapeElements.size() + count > MaxShapeElements)
+    FlushShapes();
+
+  size_t first = m_ShapeElements.size();
+  m_ShapeElements.resize(first + count);
+  return &m_ShapeElements[first];
+}
+
+void BatchRenderer::DrawSprites(const Sprite* sprites, unsigned int count, const Texture* const* textures, unsigned int textureCount)
+{
+  // keep the draw order of anything queued through DrawQuad
+  Flush();
+  m_CullStats.Visible += count;
+
+  std::array<const Texture*, MaxTextureSlots> slots{};
+  slots[0] = m_WhiteTexture.get();
+  if (textureCount > MaxTextureSlots - 1)
+    textureCount = MaxTextureSlots - 1;
+  for (unsigned int i = 0; i < textureCount; i++)
+    slots[i + 1] = textures[i];
+
+  if (Renderer::IsRenderThreadRunning())
+  {
+    const Sprite* copy = BufferedFrameAllocator::Get().GetCurrent().Copy(sprites, count);
+    Renderer::Submit([this, copy, count, slots, textureCount, viewProj = m_ViewProj]() {
+      DrawSpriteBatches(copy, count, slots, textureCount + 1, viewProj);
+    });
+  }
+  else
+  {
+    DrawSpriteBatches(sprites, count, slots, textureCount + 1, m_ViewProj);
+  }
+}
+
+void BatchRenderer::DrawSprites(const Sprite* sprites, const SpatialGrid& index, const Texture* const* textures, unsigned int textureCount)
+{
+  m_VisibleIndices.clear();
+  index.Query(m_ViewMin, m_ViewMax, m_VisibleIndices);
+  // cell order changes as sprites move between cells; keep the caller's order
+  // so overlapping sprites don't flicker
+  std::sort(m_VisibleIndices.begin(), m_VisibleIndices.end());
+
+  m_VisibleSprites.resize(m_VisibleIndices.size());
+  for (size_t i = 0; i < m_VisibleIndices.size(); i++)
+    m_VisibleSprites[i] = sprites[m_VisibleIndices[i]];
+
+  m_CullStats.Culled += index.GetProxyCount() - (unsigned int)m_VisibleSprites.size();
+  DrawSprites(m_VisibleSprites.data(), (unsigned int)m_VisibleSprites.size(), textures, textureCount);
+}
+
+void BatchRenderer::DrawSpriteBatches(const Sprite* sprites, unsigned int count, const std::array<const Texture*, MaxTextureSlots>& textures,
+  unsigned int textureCount, const glm::mat4& viewProj)
+{
+  for (unsigned int i = 0; i < textureCount; i++)
+    textures[i]->Bind(i);
+
+  m_Shader->Bind();
+  m_Shader->SetUniformMat4f("u_ViewProj", viewProj);
+
+  Renderer renderer;
+  for (unsigned int first = 0; first < count; first += MaxSpritesPerBatch)
+  {
+    unsigned int batchCount = count - first < MaxSpritesPerBatch ? count - first : MaxSpritesPerBatch;
+    const Sprite* batch = sprites + first;
+
+    // the GL thread only maps, waits and draws; the workers fill disjoint ranges
+    QuadVertex* vertices = (QuadVertex*)m_SpriteVertexBuffer->Map(batchCount * 4 * sizeof(QuadVertex));
+    JobSystem::ParallelFor(batchCount, 2048, [vertices, batch](unsigned int begin, unsigned int end) {
+      WriteSpriteVertices(vertices + begin * 4, batch + begin, end - begin);
+    });
+    m_SpriteVertexBuffer->Unmap();
+
+    renderer.Draw(*m_SpriteVAO, *m_SpriteIndexBuffer, *m_Shader, batchCount * 6);
+  }
+}
+
+float BatchRenderer::GetTextureSlot(const Texture* texture)
+{
+  if (!texture)
+    return 0.0f;
+
+  for (unsigned int i = 1; i < m_TextureSlotCount; i++)
+  {
+    if (m_TextureSlots[i] == texture)
+      return (float)i;
+  }
+
+  if (m_TextureSlotCount == MaxTextureSlots)
+    Flush();
+
+  m_TextureSlots[m_TextureSlotCount] = texture;
+  return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::Flush()
+{
+  // at most one of them has anything queued
+  FlushQuads();
+  FlushShapes();
+}
+
+void BatchRenderer::FlushQuads()
+{
+  if (m_QuadCount == 0)
+    return;
+
+  if (Renderer::IsRenderThreadRunning())
+  {
+    // m_Vertices is refilled before the render thread gets to this batch
+    const QuadVertex* vertices = BufferedFrameAllocator::Get().GetCurrent().Copy(m_Vertices.data(), m_QuadCount * 4);
+    Renderer::Submit([this, vertices, quadCount = m_QuadCount, textures = m_TextureSlots,
+      textureCount = m_TextureSlotCount, viewProj = m_ViewProj]() {
+      DrawBatch(vertices, quadCount, textures, textureCount, viewProj);
+    });
+  }
+  else
+  {
+    DrawBatch(m_Vertices.data(), m_QuadCount, m_TextureSlots, m_TextureSlotCount, m_ViewProj);
+  }
+
+  m_QuadCount = 0;
+  m_TextureSlotCount = 1;
+}
+
+void BatchRenderer::DrawBatch(const QuadVertex* vertices, unsigned int quadCount, const std::array<const Texture*, MaxTextureSlots>& textures,
+  unsigned int textureCount, const glm::mat4& viewProj)
+{
+  m_VertexBuffer->SetData(vertices, quadCount * 4 * sizeof(QuadVertex));
+
+  for (unsigned int i = 0; i < textureCount; i++)
+    textures[i]->Bind(i);
+
+  m_Shader->Bind();
+  m_Shader->SetUniformMat4f("u_ViewProj", viewProj);
+
+  Renderer renderer;
+  renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader, quadCount * 6);
+}
+
+void BatchRenderer::FlushShapes()
+{
+  if (m_ShapeElements.empty())
+    return;
+
+  unsigned int count = (unsigned int)m_ShapeElements.size();
+  if (Renderer::IsRenderThreadRunning())
+  {
+    const ShapeElement* elements = BufferedFrameAllocator::Get().GetCurrent().Copy(m_ShapeElements.data(), count);
+    Renderer::Submit([this, elements, count, viewProj = m_ViewProj]() {
+      DrawShapeBatch(elements, count, viewProj);
+    });
+  }
+  else
+  {
+    DrawShapeBatch(m_ShapeElements.data(), count, m_ViewProj);
+  }
+  m_ShapeElements.clear();
+}
+
+void BatchRenderer::DrawShapeBatch(const ShapeElement* elements, unsigned int count, const glm::mat4& viewProj)
+{
+  m_ShapeBuffer->SetData(elements, count * sizeof(ShapeElement));
+
+  // the vertex shader pads every shape by a pixel for the antialiased edge
+  int viewport[4];
+  GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+  m_ShapeShader->Bind();
+  m_ShapeShader->SetUniformMat4f("u_ViewProj", viewProj);
+  m_ShapeShader->SetUniform2f("u_ViewportSize", (float)viewport[2], (float)viewport[3]);
+
+  // the last element only ends the shape before it
+  Renderer renderer;
+  renderer.DrawInstanced(*m_ShapeVAO, *m_ShapeIndexBuffer, *m_ShapeShader, count - 1);
+}
+
+std::vector<unsigned int> BatchRenderer::GenerateQuadIndices(unsigned int quadCount)
+{
+  std::vector<unsigned int> indices(quadCount * 6);
+  unsigned int offset = 0;
+  for (unsigned int i = 0; i < indices.size(); i += 6)
+  {
+    indices[i + 0] = offset + 0;
+    indices[i + 1] = offset + 1;
+    indices[i + 2] = offset + 2;
+
+    indices[i + 3] = offset + 2;
+    indices[i + 4] = offset + 3;
+    indices[i + 5] = offset + 0;
+
+    offset += 4;
+  }
+  return indices;
+}
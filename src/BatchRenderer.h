@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexBuffer.h"
+#include "Texture.h"
+#include "Affine2D.h"
+#include "SpatialGrid.h"
+#include "Font.h"
+#include "glm/glm.hpp"
+
+struct QuadVertex
+{
+  glm::vec3 Position;
+  glm::vec4 Color;
+  glm::vec2 TexCoord;
+  float TexIndex;
+};
+VERTEX_LAYOUT(QuadVertex, Position, Color, TexCoord, TexIndex);
+
+enum class ShapeType { None = 0, Segment, Circle, Rect };
+
+// One entry of the shape stream. Instance i draws element i and reads the
+// position of element i + 1 as its second point: the end of a segment, the
+// radius of a circle (x) or the half size of a rect. A polyline is one
+// element per point, so its segments are built in the vertex shader; the
+// element closing a shape has ShapeType::None and draws nothing.
+struct ShapeElement
+{
+  glm::vec2 Position;
+  glm::vec4 Color;
+  // x: ShapeType, y: line width or stroke width (0 fills), z: corner radius, w: rotation
+  glm::vec4 Params;
+};
+VERTEX_LAYOUT(ShapeElement, Position, Color, Params);
+
+struct Sprite
+{
+  glm::vec2 Position;
+  glm::vec2 Size;
+  float Rotation;
+  // 0 is untextured, n samples the n-th texture passed to DrawSprites
+  float TextureSlot;
+  glm::vec4 Color;
+};
+
+// World-space box around the rotated sprite.
+void GetSpriteBounds(const Sprite& sprite, glm::vec2& min, glm::vec2& max);
+
+struct BatchCullStats
+{
+  unsigned int Visible = 0;
+  unsigned int Culled = 0;
+};
+
+// Collects quads into one dynamic vertex buffer and draws them with as few
+// draw calls as possible. A batch is flushed when it is full or when it runs
+// out of texture slots.
+//
+// Lines, circles, rounded rects and polylines are evaluated as distance
+// fields in the fragment shader and antialiased there. They are instanced
+// from one element stream; consecutive shapes share a draw call and switching
+// between shapes and quads starts a new batch, so draw order is kept.
+//
+// Quads entirely outside the view rect of Begin() are dropped before their
+// vertices are written; large sprite lists should go through a SpatialGrid so
+// that off-screen sprites are never even visited.
+class BatchRenderer
+{
+public:
+  static const unsigned int MaxTextureSlots = 16;
+  static const unsigned int MaxSpritesPerBatch = 1 << 16;
+  static const unsigned int MaxShapeElements = 1 << 16;
+
+  BatchRenderer(unsigned int maxQuads = 20000);
+  ~BatchRenderer();
+
+  void Begin(const glm::mat4& viewProj);
+  void End();
+
+  void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+  void DrawQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color, const Texture* texture = nullptr);
+  // The transform maps the unit quad centred on the origin.
+  void DrawQuad(const Affine2D& transform, const glm::vec4& color, const Texture* texture = nullptr);
+  // Glyph quads sampling the font's distance field atlas; text shares batches
+  // with every other quad. position is the start of the baseline, size the
+  // font's pixel height in world units. Not named DrawText, which <windows.h>
+  // redefines.
+  void DrawString(Font& font, const std::string& text, const glm::vec2& position, float size, const glm::vec4& color);
+
+  // Round capped; width in world units.
+  void DrawLine(const glm::vec2& from, const glm::vec2& to, float width, const glm::vec4& color);
+  // A stroke width of 0 fills the shape; strokes lie inside the outline.
+  void DrawCircle(const glm::vec2& center, float radius, const glm::vec4& color, float stroke = 0.0f);
+  void DrawRect(const glm::vec2& center, const glm::vec2& size, const glm::vec4& color, float cornerRadius = 0.0f,
+    float stroke = 0.0f, float rotation = 0.0f);
+  // Segments are round capped, so joins are round as well; translucent
+  // polylines blend twice where segments overlap.
+  void DrawPolyline(const glm::vec2* points, unsigned int count, float width, const glm::vec4& color, bool closed = false);
+  // Bulk path for large sprite lists: vertices are generated by the job
+  // system straight into a mapped vertex buffer, each job writing its own
+  // range. Up to MaxTextureSlots - 1 textures.
+  void DrawSprites(const Sprite* sprites, unsigned int count, const Texture* const* textures = nullptr, unsigned int textureCount = 0);
+  // Draws the sprites the index reports inside the view rect. The index's
+  // user data are indices into sprites.
+  void DrawSprites(const Sprite* sprites, const SpatialGrid& index, const Texture* const* textures = nullptr, unsigned int textureCount = 0);
+
+  // Per-quad view culling in DrawQuad, on by default.
+  void SetCulling(bool culling) { m_Culling = culling; }
+  inline bool IsCulling() const { return m_Culling; }
+  // World-space rect covered by the current view projection.
+  inline const glm::vec2& GetViewMin() const { return m_ViewMin; }
+  inline const glm::vec2& GetViewMax() const { return m_ViewMax; }
+  // Counted since Begin().
+  inline const BatchCullStats& GetCullStats() const { return m_CullStats; }
+
+  inline unsigned int GetMaxQuads() const { return m_MaxQuads; }
+
+  static std::vector<unsigned int> GenerateQuadIndices(unsigned int quadCount);
+private:
+  void Flush();
+  void FlushQuads();
+  void FlushShapes();
+  void DrawShapeBatch(const ShapeElement* elements, unsigned int count, const glm::mat4& viewProj);
+  // Reserves count elements of the shape stream, flushing first if they don't fit.
+  ShapeElement* AllocateShapes(unsigned int count);
+  bool IsShapeVisible(const glm::vec2& min, const glm::vec2& max);
+  void DrawSpriteBatches(const Sprite* sprites, unsigned int count, const std::array<const Texture*, MaxTextureSlots>& textures,
+    unsigned int textureCount, const glm::mat4& viewProj);
+  void DrawBatch(const QuadVertex* vertices, unsigned int quadCount, const std::array<const Texture*, MaxTextureSlots>& textures,
+    unsigned int textureCount, const glm::mat4& viewProj);
+  float GetTextureSlot(const Texture* texture);
+  // distanceField selects the SDF path of the sprite shader for this quad
+  void AddQuad(const glm::vec2* corners, const glm::vec2* texCoords, const glm::vec4& color, const Texture* texture,
+    bool distanceField = false);
+
+  unsigned int m_MaxQuads;
+  std::unique_ptr<VertexArray> m_VAO;
+  std::unique_ptr<VertexBuffer> m_VertexBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<Shader> m_Shader;
+  std::unique_ptr<Texture> m_WhiteTexture;
+
+  std::unique_ptr<VertexArray> m_SpriteVAO;
+  std::unique_ptr<VertexBuffer> m_SpriteVertexBuffer;
+  std::unique_ptr<IndexBuffer> m_SpriteIndexBuffer;
+
+  std::vector<QuadVertex> m_Vertices;
+  unsigned int m_QuadCount;
+
+  std::array<const Texture*, MaxTextureSlots> m_TextureSlots;
+  unsigned int m_TextureSlotCount;
+
+  glm::mat4 m_ViewProj;
+
+  bool m_Culling;
+  glm::vec2 m_ViewMin, m_ViewMax;
+  BatchCullStats m_CullStats;
+  std::vector<unsigned int> m_VisibleIndices;
+  std::vector<Sprite> m_VisibleSprites;
+  std::vector<GlyphQuad> m_GlyphQuads;
+
+  std::unique_ptr<VertexArray> m_ShapeVAO;
+  std::unique_ptr<VertexBuffer> m_ShapeBuffer;
+  std::unique_ptr<IndexBuffer> m_ShapeIndexBuffer;
+  std::unique_ptr<Shader> m_ShapeShader;
+  std::vector<ShapeElement> m_ShapeElements;
+};
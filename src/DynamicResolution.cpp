@@ -0,0 +1,100 @@
+#include "DynamicResolution.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+
+#include <cmath>
+
+// ignore errors below this, and move at most MaxStep per measurement since
+// results arrive a few frames late
+static const float s_Deadband = 0.02f;
+static const float s_MaxStep = 0.05f;
+
+DynamicResolution::DynamicResolution()
+  : m_Enabled(false), m_SceneActive(false), m_Scale(1.0f), m_GpuTime(0.0f), m_RenderWidth(0), m_RenderHeight(0),
+  m_UpscaleShader("res/shaders/Upscale.shader"), m_Target(nullptr), m_PreviousFramebuffer(0), m_PreviousViewport{},
+  m_CurrentScale(1.0f)
+{
+}
+
+DynamicResolution::~DynamicResolution()
+{
+}
+
+void DynamicResolution::BeginScene()
+{
+  m_SceneActive = m_Enabled;
+  if (!m_SceneActive)
+    return;
+
+  Renderer::Submit([this, settings = m_Settings]() {
+    float gpuTime;
+    if (m_Timer.Poll(gpuTime))
+    {
+      m_GpuTime = gpuTime;
+      if (settings.Adaptive)
+        UpdateScale(settings, gpuTime);
+    }
+    // the limits only bound the controller; a manual scale is used as is
+    if (settings.Adaptive)
+      m_CurrentScale = glm::clamp(m_CurrentScale, settings.MinScale, settings.MaxScale);
+    else
+      m_CurrentScale = settings.ManualScale;
+
+    GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_PreviousFramebuffer));
+    GLCall(glGetIntegerv(GL_VIEWPORT, m_PreviousViewport));
+
+    FramebufferSpec spec;
+    spec.ColorFormat = FramebufferFormat::RGBA16F;
+    m_Target = &RenderTargetPool::Get().AcquireWindowSized(spec);
+    int width = glm::max(1, (int)(m_Target->GetWidth() * m_CurrentScale));
+    int height = glm::max(1, (int)(m_Target->GetHeight() * m_CurrentScale));
+    m_Scale = m_CurrentScale;
+    m_RenderWidth = width;
+    m_RenderHeight = height;
+
+    m_Timer.Begin();
+    m_Target->Bind();
+    GLCall(glViewport(0, 0, width, height));
+  });
+}
+
+void DynamicResolution::EndScene()
+{
+  if (!m_SceneActive)
+    return;
+  m_SceneActive = false;
+
+  Renderer::Submit([this, settings = m_Settings]() {
+    Upscale(settings);
+    m_Timer.End();
+    m_Target = nullptr;
+  });
+}
+
+void DynamicResolution::UpdateScale(const Settings& settings, float gpuTime)
+{
+  float ideal = m_CurrentScale * std::sqrt(settings.TargetTime / glm::max(gpuTime, 0.01f));
+  float error = ideal - m_CurrentScale;
+  if (std::abs(error) < s_Deadband)
+    return;
+  m_CurrentScale += glm::clamp(error, -s_MaxStep, s_MaxStep);
+}
+
+void DynamicResolution::Upscale(const Settings& settings)
+{
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_PreviousFramebuffer));
+  GLCall(glViewport(m_PreviousViewport[0], m_PreviousViewport[1], m_PreviousViewport[2], m_PreviousViewport[3]));
+  GLCall(glDisable(GL_BLEND));
+
+  float texelWidth = 1.0f / m_Target->GetWidth(), texelHeight = 1.0f / m_Target->GetHeight();
+  m_UpscaleShader.Bind();
+  m_Target->BindColorTexture(0);
+  m_UpscaleShader.SetUniform1i("u_Source", 0);
+  m_UpscaleShader.SetUniform2f("u_UVScale", m_RenderWidth * texelWidth, m_RenderHeight * texelHeight);
+  m_UpscaleShader.SetUniform2f("u_TexelSize", texelWidth, texelHeight);
+  m_UpscaleShader.SetUniform1i("u_Filter", (unsigned int)settings.Filter);
+
+  Renderer renderer;
+  renderer.DrawArrays(m_EmptyVAO, m_UpscaleShader, 3);
+  GLCall(glEnable(GL_BLEND));
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+
+#include "GpuTimer.h"
+#include "Shader.h"
+#include "VertexArray.h"
+
+class Framebuffer;
+
+enum class UpscaleFilter
+{
+  Bilinear,
+  // Catmull-Rom, clamped to the nearest 2x2 source texels to avoid ringing
+  CatmullRom
+};
+
+// Renders the scene into the lower left part of a window-sized target and
+// upscales it into whatever framebuffer was bound before BeginScene() (the
+// window, or the post-processing scene target). The scale follows GPU timer
+// queries around the scene, aiming at a target GPU time: cost goes with the
+// pixel count, so the scale that would just hit the target is
+// scale * sqrt(target / measured).
+//
+// The target never changes size with the scale, so adapting allocates nothing.
+// BeginScene/EndScene and the settings are main thread; the GL work goes
+// through Renderer::Submit.
+class DynamicResolution
+{
+public:
+  DynamicResolution();
+  ~DynamicResolution();
+
+  void BeginScene();
+  void EndScene();
+
+  inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+  inline bool IsEnabled() const { return m_Enabled; }
+
+  struct Settings
+  {
+    // off: ManualScale is used as is
+    bool Adaptive = true;
+    float TargetTime = 8.0f;
+    float MinScale = 0.4f;
+    float MaxScale = 1.0f;
+    float ManualScale = 0.75f;
+    UpscaleFilter Filter = UpscaleFilter::CatmullRom;
+  };
+  inline Settings& GetSettings() { return m_Settings; }
+
+  // Latest values from the GL thread.
+  inline float GetScale() const { return m_Scale; }
+  inline float GetGpuTime() const { return m_GpuTime; }
+  inline int GetRenderWidth() const { return m_RenderWidth; }
+  inline int GetRenderHeight() const { return m_RenderHeight; }
+private:
+  void UpdateScale(const Settings& settings, float gpuTime);
+  void Upscale(const Settings& settings);
+
+  bool m_Enabled;
+  bool m_SceneActive;
+  Settings m_Settings;
+
+  std::atomic<float> m_Scale;
+  std::atomic<float> m_GpuTime;
+  std::atomic<int> m_RenderWidth, m_RenderHeight;
+
+  // GL thread only
+  GpuTimer m_Timer;
+  Shader m_UpscaleShader;
+  VertexArray m_EmptyVAO;
+  Framebuffer* m_Target;
+  int m_PreviousFramebuffer;
+  int m_PreviousViewport[4];
+  float m_CurrentScale;
+};
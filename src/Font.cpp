@@ -0,0 +1,337 @@
+#include "Font.h"
+#include "Renderer.h"
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+// private copies of the stb implementations; imgui_draw.cpp compiles its own
+// static ones, so neither sees the other's symbols
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "imgui/imstb_truetype.h"
+
+struct Font::FontInfo
+{
+  stbtt_fontinfo Info;
+};
+
+struct Font::Page
+{
+  stbrp_context Context;
+  std::vector<stbrp_node> Nodes;
+  unsigned long long LastUsed = 0;
+  unsigned int GlyphCount = 0;
+};
+
+static int DecodeUtf8(const char*& text, const char* end)
+{
+  unsigned char c = (unsigned char)*text++;
+  if (c < 0x80)
+    return c;
+  int extra = c >= 0xf0 ? 3 : c >= 0xe0 ? 2 : c >= 0xc0 ? 1 : 0;
+  if (extra == 0)
+    return 0xfffd;
+  int codepoint = c & (0x3f >> extra);
+  for (; extra && text < end && ((unsigned char)*text & 0xc0) == 0x80; extra--)
+    codepoint = (codepoint << 6) | ((unsigned char)*text++ & 0x3f);
+  return extra ? 0xfffd : codepoint;
+}
+
+Font::Font(const std::string& path, float glyphSize, int padding)
+  : m_Valid(false)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (file)
+    m_Data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  if (m_Data.empty())
+    std::cout << "Failed to load font: " << path << std::endl;
+  Initialize(glyphSize, padding);
+}
+
+Font::Font(const void* data, size_t size, float glyphSize, int padding)
+  : m_Valid(false), m_Data((const unsigned char*)data, (const unsigned char*)data + size)
+{
+  Initialize(glyphSize, padding);
+}
+
+Font::~Font()
+{
+}
+
+void Font::Initialize(float glyphSize, int padding)
+{
+  m_GlyphSize = glyphSize;
+  m_Padding = padding;
+  m_Scale = 0.0f;
+  m_Ascent = 0.8f;
+  m_LineGap = 1.0f;
+  m_Info = std::make_unique<FontInfo>();
+
+  m_Pages.resize(PageCount);
+  for (Page& page : m_Pages)
+  {
+    page.Nodes.resize(AtlasSize);
+    stbrp_init_target(&page.Context, AtlasSize, PageHeight, page.Nodes.data(), (int)page.Nodes.size());
+  }
+  m_Atlas = std::make_unique<Texture>(AtlasSize, AtlasSize, nullptr);
+
+  if (m_Data.empty())
+    return;
+  int offset = stbtt_GetFontOffsetForIndex(m_Data.data(), 0);
+  if (offset < 0 || !stbtt_InitFont(&m_Info->Info, m_Data.data(), offset))
+  {
+    std::cout << "Failed to parse font data" << std::endl;
+    return;
+  }
+
+  m_Scale = stbtt_ScaleForPixelHeight(&m_Info->Info, glyphSize);
+  int ascent, descent, lineGap;
+  stbtt_GetFontVMetrics(&m_Info->Info, &ascent, &descent, &lineGap);
+  float height = (float)(ascent - descent);
+  m_Ascent = ascent / height;
+  m_LineGap = (height + lineGap) / height;
+  m_Valid = true;
+}
+
+int Font::FindGlyphIndex(int codepoint) const
+{
+  int index = stbtt_FindGlyphIndex(&m_Info->Info, codepoint);
+  if (index == 0 && codepoint != ' ')
+    index = stbtt_FindGlyphIndex(&m_Info->Info, '?');
+  return index;
+}
+
+const GlyphMetrics& Font::GetMetrics(int codepoint)
+{
+  auto it = m_Metrics.find(codepoint);
+  if (it != m_Metrics.end())
+    return it->second;
+
+  GlyphMetrics& metrics = m_Metrics[codepoint];
+  if (!m_Valid)
+    return metrics;
+
+  int glyph = FindGlyphIndex(codepoint);
+  int advance, leftBearing;
+  stbtt_GetGlyphHMetrics(&m_Info->Info, glyph, &advance, &leftBearing);
+  metrics.Advance = advance * m_Scale;
+
+  // same box stbtt_GetGlyphSDF rasterizes, grown by the padding
+  int x0, y0, x1, y1;
+  stbtt_GetGlyphBitmapBox(&m_Info->Info, glyph, m_Scale, m_Scale, &x0, &y0, &x1, &y1);
+  metrics.Visible = x1 > x0 && y1 > y0;
+  if (metrics.Visible)
+  {
+    metrics.Offset = glm::vec2((float)(x0 - m_Padding), (float)-(y1 + m_Padding));
+    metrics.Size = glm::vec2((float)(x1 - x0 + 2 * m_Padding), (float)(y1 - y0 + 2 * m_Padding));
+  }
+  return metrics;
+}
+
+float Font::GetKerning(int first, int second)
+{
+  unsigned long long key = ((unsigned long long)(unsigned int)first << 32) | (unsigned int)second;
+  auto it = m_Kerning.find(key);
+  if (it != m_Kerning.end())
+    return it->second;
+
+  float kerning = 0.0f;
+  if (m_Valid)
+    kerning = stbtt_GetGlyphKernAdvance(&m_Info->Info, FindGlyphIndex(first), FindGlyphIndex(second)) * m_Scale;
+  m_Kerning[key] = kerning;
+  return kerning;
+}
+
+bool Font::GetGlyphUV(int codepoint, glm::vec2& uvMin, glm::vec2& uvMax)
+{
+  auto it = m_Resident.find(codepoint);
+  if (it == m_Resident.end())
+  {
+    AtlasGlyph glyph;
+    if (!Rasterize(codepoint, glyph))
+      return false;
+    it = m_Resident.emplace(codepoint, glyph).first;
+  }
+
+  m_Pages[it->second.Page].LastUsed = FrameClock::Get().GetFrameIndex();
+  uvMin = it->second.UVMin;
+  uvMax = it->second.UVMax;
+  return true;
+}
+
+bool Font::Rasterize(int codepoint, AtlasGlyph& glyph)
+{
+  if (!m_Valid)
+    return false;
+
+  int width, height, xoff, yoff;
+  unsigned char* field = stbtt_GetGlyphSDF(&m_Info->Info, m_Scale, FindGlyphIndex(codepoint), m_Padding, 128,
+    128.0f / m_Padding, &width, &height, &xoff, &yoff);
+  if (!field)
+    return false;
+
+  // a cleared border keeps filtering from picking up texels of whatever the
+  // neighbouring rect held before an eviction
+  int x, y, page;
+  if (!Pack(width + 2, height + 2, x, y, page))
+  {
+    stbtt_FreeSDF(field, nullptr);
+    m_Stats.DroppedGlyphs++;
+    return false;
+  }
+
+  std::vector<unsigned char> pixels((size_t)(width + 2) * (height + 2) * 4, 0);
+  for (int row = 0; row < height; row++)
+  {
+    unsigned char* out = &pixels[((size_t)(row + 1) * (width + 2) + 1) * 4];
+    for (int column = 0; column < width; column++, out += 4)
+    {
+      out[0] = out[1] = out[2] = 255;
+      out[3] = field[row * width + column];
+    }
+  }
+  stbtt_FreeSDF(field, nullptr);
+
+  // rows go up the texture in bitmap order, so the top of the glyph has the smaller v
+  int atlasY = page * PageHeight + y;
+  glyph.Page = page;
+  glyph.UVMin = glm::vec2((float)(x + 1), (float)(atlasY + 1 + height)) / (float)AtlasSize;
+  glyph.UVMax = glm::vec2((float)(x + 1 + width), (float)(atlasY + 1)) / (float)AtlasSize;
+
+  Texture* atlas = m_Atlas.get();
+  Renderer::Submit([atlas, x, atlasY, width, height, pixels = std::move(pixels)]() {
+    atlas->SetData(x, atlasY, width + 2, height + 2, pixels.data());
+  });
+
+  m_Pages[page].GlyphCount++;
+  m_Stats.RasterizedGlyphs++;
+  m_Stats.ResidentGlyphs++;
+  return true;
+}
+
+bool Font::Pack(int width, int height, int& x, int& y, int& page)
+{
+  stbrp_rect rect = {};
+  rect.w = width;
+  rect.h = height;
+  for (int i = 0; i < PageCount; i++)
+  {
+    stbrp_pack_rects(&m_Pages[i].Context, &rect, 1);
+    if (rect.was_packed)
+    {
+      x = rect.x;
+      y = rect.y;
+      page = i;
+      return true;
+    }
+  }
+
+  unsigned long long frame = FrameClock::Get().GetFrameIndex();
+  int oldest = -1;
+  for (int i = 0; i < PageCount; i++)
+  {
+    if (m_Pages[i].LastUsed < frame && (oldest < 0 || m_Pages[i].LastUsed < m_Pages[oldest].LastUsed))
+      oldest = i;
+  }
+  if (oldest < 0)
+    return false;
+
+  EvictPage(oldest);
+  stbrp_pack_rects(&m_Pages[oldest].Context, &rect, 1);
+  if (!rect.was_packed)
+    return false;
+  x = rect.x;
+  y = rect.y;
+  page = oldest;
+  return true;
+}
+
+void Font::EvictPage(int page)
+{
+  for (auto it = m_Resident.begin(); it != m_Resident.end();)
+  {
+    if (it->second.Page == page)
+      it = m_Resident.erase(it);
+    else
+      ++it;
+  }
+
+  Page& evicted = m_Pages[page];
+  m_Stats.ResidentGlyphs -= evicted.GlyphCount;
+  m_Stats.EvictedPages++;
+  evicted.GlyphCount = 0;
+  evicted.LastUsed = 0;
+  stbrp_init_target(&evicted.Context, AtlasSize, PageHeight, evicted.Nodes.data(), (int)evicted.Nodes.size());
+}
+
+void Font::LayoutText(const std::string& text, const glm::vec2& position, float size, std::vector<GlyphQuad>& quads)
+{
+  if (!m_Valid)
+    return;
+
+  float scale = size / m_GlyphSize;
+  glm::vec2 pen = position;
+  int previous = 0;
+  const char* it = text.data();
+  const char* end = it + text.size();
+  while (it < end)
+  {
+    int codepoint = DecodeUtf8(it, end);
+    if (codepoint == '\n')
+    {
+      pen.x = position.x;
+      pen.y -= GetLineHeight(size);
+      previous = 0;
+      continue;
+    }
+    if (previous)
+      pen.x += GetKerning(previous, codepoint) * scale;
+
+    const GlyphMetrics& metrics = GetMetrics(codepoint);
+    GlyphQuad quad;
+    if (metrics.Visible && GetGlyphUV(codepoint, quad.UVMin, quad.UVMax))
+    {
+      quad.Min = pen + metrics.Offset * scale;
+      quad.Max = quad.Min + metrics.Size * scale;
+      quads.push_back(quad);
+    }
+    pen.x += metrics.Advance * scale;
+    previous = codepoint;
+  }
+}
+
+glm::vec2 Font::MeasureText(const std::string& text, float size)
+{
+  if (!m_Valid)
+    return glm::vec2(0.0f);
+
+  float scale = size / m_GlyphSize;
+  float width = 0.0f, lineWidth = 0.0f;
+  int lines = 1;
+  int previous = 0;
+  const char* it = text.data();
+  const char* end = it + text.size();
+  while (it < end)
+  {
+    int codepoint = DecodeUtf8(it, end);
+    if (codepoint == '\n')
+    {
+      width = std::max(width, lineWidth);
+      lineWidth = 0.0f;
+      lines++;
+      previous = 0;
+      continue;
+    }
+    if (previous)
+      lineWidth += GetKerning(previous, codepoint) * scale;
+    lineWidth += GetMetrics(codepoint).Advance * scale;
+    previous = codepoint;
+  }
+  width = std::max(width, lineWidth);
+  return glm::vec2(width, size + (lines - 1) * GetLineHeight(size));
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Texture.h"
+#include "glm/glm.hpp"
+
+// Pen-relative metrics at the font's glyph size, y up.
+struct GlyphMetrics
+{
+  float Advance = 0.0f;
+  // quad of the distance field around the outline, relative to the pen on the baseline
+  glm::vec2 Offset = glm::vec2(0.0f);
+  glm::vec2 Size = glm::vec2(0.0f);
+  // false for whitespace and glyphs without an outline
+  bool Visible = false;
+};
+
+// One laid out glyph, in the coordinates passed to LayoutText.
+struct GlyphQuad
+{
+  glm::vec2 Min, Max;
+  glm::vec2 UVMin, UVMax;
+};
+
+struct FontAtlasStats
+{
+  unsigned int ResidentGlyphs = 0;
+  unsigned int RasterizedGlyphs = 0;
+  unsigned int EvictedPages = 0;
+  // glyphs skipped because every page was in use this frame
+  unsigned int DroppedGlyphs = 0;
+};
+
+// TrueType font rendered through signed distance fields, so one rasterized
+// size stays sharp from small labels to large headings.
+//
+// Glyphs are rasterized on first use into an atlas texture split into
+// horizontal pages, each packed with stb_rect_pack. When no page has room,
+// the least recently used page is cleared and its glyphs are rasterized again
+// the next time they are drawn. Pages used in the current frame are never
+// evicted, so quads already queued keep their texels.
+//
+// Main thread only; atlas uploads go through Renderer::Submit.
+class Font
+{
+public:
+  static constexpr int AtlasSize = 1024;
+  static constexpr int PageCount = 8;
+  static constexpr int PageHeight = AtlasSize / PageCount;
+
+  // glyphSize is the pixel height of the rasterized glyphs, padding the
+  // distance in pixels the field extends past the outline
+  Font(const std::string& path, float glyphSize = 48.0f, int padding = 6);
+  Font(const void* data, size_t size, float glyphSize = 48.0f, int padding = 6);
+  ~Font();
+
+  Font(const Font&) = delete;
+  Font& operator=(const Font&) = delete;
+
+  inline bool IsValid() const { return m_Valid; }
+
+  const GlyphMetrics& GetMetrics(int codepoint);
+  // Horizontal adjustment between two codepoints at the glyph size.
+  float GetKerning(int first, int second);
+  // Makes the glyph resident and returns its atlas rect. Returns false when
+  // the glyph has no outline or the atlas has no room for it this frame.
+  bool GetGlyphUV(int codepoint, glm::vec2& uvMin, glm::vec2& uvMax);
+
+  // Appends a quad per visible glyph. position is the start of the first
+  // baseline, size the font's pixel height in the same units. '\n' starts a
+  // new line.
+  void LayoutText(const std::string& text, const glm::vec2& position, float size, std::vector<GlyphQuad>& quads);
+  glm::vec2 MeasureText(const std::string& text, float size);
+
+  inline float GetLineHeight(float size) const { return size * m_LineGap; }
+  inline float GetAscent(float size) const { return size * m_Ascent; }
+  inline float GetGlyphSize() const { return m_GlyphSize; }
+
+  inline const Texture& GetAtlas() const { return *m_Atlas; }
+  inline const FontAtlasStats& GetStats() const { return m_Stats; }
+private:
+  struct AtlasGlyph
+  {
+    glm::vec2 UVMin, UVMax;
+    int Page;
+  };
+  struct Page;
+
+  void Initialize(float glyphSize, int padding);
+  int FindGlyphIndex(int codepoint) const;
+  bool Rasterize(int codepoint, AtlasGlyph& glyph);
+  bool Pack(int width, int height, int& x, int& y, int& page);
+  void EvictPage(int page);
+
+  bool m_Valid;
+  std::vector<unsigned char> m_Data;
+  // stbtt_fontinfo, kept out of the header
+  struct FontInfo;
+  std::unique_ptr<FontInfo> m_Info;
+
+  float m_GlyphSize;
+  int m_Padding;
+  float m_Scale;
+  // per unit of glyph size
+  float m_Ascent, m_LineGap;
+
+  std::unique_ptr<Texture> m_Atlas;
+  std::vector<Page> m_Pages;
+
+  std::unordered_map<int, GlyphMetrics> m_Metrics;
+  std::unordered_map<unsigned long long, float> m_Kerning;
+  std::unordered_map<int, AtlasGlyph> m_Resident;
+  FontAtlasStats m_Stats;
+};
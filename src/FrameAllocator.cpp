@@ -0,0 +1,135 @@
+#include "FrameAllocator.h"
+
+#include <cstdint>
+#include <cstdlib>
+
+static size_t AlignUp(size_t value, size_t alignment)
+{
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameAllocator::FrameAllocator(size_t capacity)
+  : m_Capacity(capacity), m_HighWaterMark(0)
+{
+  m_Blocks.push_back(CreateBlock(capacity));
+  m_Current = m_Blocks.back();
+}
+
+FrameAllocator::~FrameAllocator()
+{
+  FreeBlocks();
+}
+
+FrameAllocator::Block* FrameAllocator::CreateBlock(size_t size)
+{
+  Block* block = new Block;
+  block->Data = (char*)std::malloc(size);
+  block->Size = size;
+  block->Offset = 0;
+  return block;
+}
+
+void FrameAllocator::FreeBlocks()
+{
+  for (Block* block : m_Blocks)
+  {
+    std::free(block->Data);
+    delete block;
+  }
+  m_Blocks.clear();
+}
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+  while (true)
+  {
+    Block* block = m_Current.load(std::memory_order_acquire);
+    uintptr_t base = (uintptr_t)block->Data;
+    size_t offset = block->Offset.load(std::memory_order_relaxed);
+    size_t begin, end;
+    do
+    {
+      begin = AlignUp(base + offset, alignment) - base;
+      end = begin + size;
+    } while (end <= block->Size && !block->Offset.compare_exchange_weak(offset, end, std::memory_order_relaxed));
+
+    if (end <= block->Size)
+      return block->Data + begin;
+
+    // slow path: the first thread to get here adds a block, the others retry in it
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Current.load(std::memory_order_relaxed) == block)
+    {
+      size_t blockSize = m_Blocks.back()->Size * 2;
+      if (blockSize < size + alignment)
+        blockSize = size + alignment;
+      m_Blocks.push_back(CreateBlock(blockSize));
+      m_Current.store(m_Blocks.back(), std::memory_order_release);
+    }
+  }
+}
+
+void FrameAllocator::Reset()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  size_t used = 0;
+  for (Block* block : m_Blocks)
+    used += block->Offset;
+  if (used > m_HighWaterMark)
+    m_HighWaterMark = used;
+
+  if (m_Blocks.size() > 1)
+  {
+    // grow once to fit the whole frame, with some headroom for alignment
+    m_Capacity = AlignUp(m_HighWaterMark + m_HighWaterMark / 4, 64 * 1024);
+    FreeBlocks();
+    m_Blocks.push_back(CreateBlock(m_Capacity));
+  }
+  m_Blocks.back()->Offset = 0;
+  m_Current = m_Blocks.back();
+}
+
+size_t FrameAllocator::GetUsed() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  size_t used = 0;
+  for (Block* block : m_Blocks)
+    used += block->Offset;
+  return used;
+}
+
+unsigned int FrameAllocator::GetOverflowBlocks() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return (unsigned int)m_Blocks.size() - 1;
+}
+
+BufferedFrameAllocator::BufferedFrameAllocator(size_t capacityPerFrame)
+  : m_Current(0)
+{
+  for (unsigned int i = 0; i < BufferCount; i++)
+    m_Arenas[i] = std::make_unique<FrameAllocator>(capacityPerFrame);
+}
+
+BufferedFrameAllocator& BufferedFrameAllocator::Get()
+{
+  static BufferedFrameAllocator allocator(4 * 1024 * 1024);
+  return allocator;
+}
+
+void BufferedFrameAllocator::BeginFrame(unsigned int index)
+{
+  m_Current = index;
+  m_Arenas[index]->Reset();
+}
+
+size_t BufferedFrameAllocator::GetHighWaterMark() const
+{
+  size_t highWaterMark = 0;
+  for (unsigned int i = 0; i < BufferCount; i++)
+  {
+    if (m_Arenas[i]->GetHighWaterMark() > highWaterMark)
+      highWaterMark = m_Arenas[i]->GetHighWaterMark();
+  }
+  return highWaterMark;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "RenderThread.h"
+
+// Linear (bump) arena for data that only lives for one frame: copies of
+// vertices handed to the render thread, temporary arrays, sort keys...
+// Allocation is a single compare-exchange, so jobs can allocate from it
+// concurrently; nothing is freed individually, Reset() drops everything.
+//
+// When a frame needs more than the arena holds, an extra block is taken
+// from the heap. The next Reset() folds all blocks into one big enough for
+// the high-water mark, so after a few frames of warm-up the frame loop does
+// not touch the general-purpose heap at all.
+class FrameAllocator
+{
+public:
+  FrameAllocator(size_t capacity);
+  ~FrameAllocator();
+
+  FrameAllocator(const FrameAllocator&) = delete;
+  FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  // Uninitialised storage for count objects; use for trivially destructible
+  // types only, destructors never run.
+  template<typename T>
+  T* AllocateArray(size_t count)
+  {
+    return (T*)Allocate(count * sizeof(T), alignof(T));
+  }
+
+  template<typename T>
+  T* Copy(const T* data, size_t count)
+  {
+    T* result = AllocateArray<T>(count);
+    std::copy(data, data + count, result);
+    return result;
+  }
+
+  // Must not race with Allocate(): call it once the frame's data is dead.
+  void Reset();
+
+  size_t GetUsed() const;
+  inline size_t GetCapacity() const { return m_Capacity; }
+  // Largest GetUsed() seen at a Reset().
+  inline size_t GetHighWaterMark() const { return m_HighWaterMark; }
+  // Heap blocks that had to be added since the last Reset(); 0 in steady state.
+  unsigned int GetOverflowBlocks() const;
+private:
+  struct Block
+  {
+    char* Data;
+    size_t Size;
+    std::atomic<size_t> Offset;
+  };
+
+  Block* CreateBlock(size_t size);
+  void FreeBlocks();
+
+  std::atomic<Block*> m_Current;
+  std::vector<Block*> m_Blocks;
+  mutable std::mutex m_Mutex;
+  size_t m_Capacity;
+  size_t m_HighWaterMark;
+};
+
+// One FrameAllocator per frame the render thread can lag behind, indexed like
+// the render thread's command lists. Data allocated while recording frame N
+// stays valid until its arena comes round again, i.e. until the render
+// thread has finished frame N.
+class BufferedFrameAllocator
+{
+public:
+  static const unsigned int BufferCount = RenderThread::MaxFramesInFlight + 1;
+
+  BufferedFrameAllocator(size_t capacityPerFrame);
+
+  static BufferedFrameAllocator& Get();
+
+  // Call at the start of a frame, before anything allocates, with
+  // RenderThread::GetRecordingIndex() (or 0 when single threaded).
+  void BeginFrame(unsigned int index);
+
+  inline FrameAllocator& GetCurrent() { return *m_Arenas[m_Current]; }
+  inline const FrameAllocator& GetArena(unsigned int index) const { return *m_Arenas[index]; }
+  size_t GetHighWaterMark() const;
+private:
+  std::unique_ptr<FrameAllocator> m_Arenas[BufferCount];
+  unsigned int m_Current;
+};
+
+// Adapter so standard containers can live in a frame arena:
+//   std::vector<int, FrameStlAllocator<int>> keys(FrameStlAllocator<int>(arena));
+// deallocate() is a no-op; memory comes back on the arena's Reset().
+template<typename T>
+class FrameStlAllocator
+{
+public:
+  typedef T value_type;
+
+  FrameStlAllocator(FrameAllocator& allocator) : m_Allocator(&allocator) {}
+  template<typename U>
+  FrameStlAllocator(const FrameStlAllocator<U>& other) : m_Allocator(other.GetAllocator()) {}
+
+  T* allocate(size_t count) { return (T*)m_Allocator->Allocate(count * sizeof(T), alignof(T)); }
+  void deallocate(T*, size_t) {}
+
+  inline FrameAllocator* GetAllocator() const { return m_Allocator; }
+
+  template<typename U>
+  bool operator==(const FrameStlAllocator<U>& other) const { return m_Allocator == other.GetAllocator(); }
+  template<typename U>
+  bool operator!=(const FrameStlAllocator<U>& other) const { return m_Allocator != other.GetAllocator(); }
+private:
+  FrameAllocator* m_Allocator;
+};
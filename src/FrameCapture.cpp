@@ -0,0 +1,222 @@
+#include "FrameCapture.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+#include "ImageWriter.h"
+
+#include <chrono>
+#include <cstring>
+
+FrameCapture::FrameCapture()
+  : m_Recording(false), m_StopPending(false), m_Issued(0), m_Collected(0), m_Frame(0), m_Quit(false),
+  m_CapturedFrames(0), m_DroppedFrames(0), m_QueuedFrames(0), m_ReadbackLatency(0.0f), m_EncodeTime(0.0f)
+{
+  for (Slot& slot : m_Slots)
+    GLCall(glGenBuffers(1, &slot.Buffer));
+  m_Encoder = std::thread(&FrameCapture::EncoderMain, this);
+}
+
+FrameCapture::~FrameCapture()
+{
+  // the GL context is back on this thread by now
+  Collect(true);
+  Job close;
+  close.CloseVideo = true;
+  PushJob(std::move(close));
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Quit = true;
+  }
+  m_Condition.notify_all();
+  m_Encoder.join();
+
+  for (Slot& slot : m_Slots)
+    glDeleteBuffers(1, &slot.Buffer);
+}
+
+void FrameCapture::RequestScreenshot(const std::string& path)
+{
+  m_Next.ScreenshotPath = path;
+}
+
+void FrameCapture::StartRecording(const std::string& path, int framesPerSecond)
+{
+  m_Next.VideoPath = path;
+  m_Next.FramesPerSecond = framesPerSecond;
+  m_Recording = true;
+}
+
+void FrameCapture::StopRecording()
+{
+  if (!m_Recording)
+    return;
+  m_Recording = false;
+  m_StopPending = true;
+}
+
+void FrameCapture::CaptureFrame()
+{
+  Request request;
+  request.ScreenshotPath = std::move(m_Next.ScreenshotPath);
+  m_Next.ScreenshotPath.clear();
+  if (m_Recording)
+  {
+    request.VideoPath = m_Next.VideoPath;
+    request.FramesPerSecond = m_Next.FramesPerSecond;
+  }
+  request.StopVideo = m_StopPending;
+  m_StopPending = false;
+
+  Renderer::Submit([this, request = std::move(request)]() {
+    m_Frame++;
+    Collect(false);
+    if (request.StopVideo)
+    {
+      // everything recorded so far has to reach the file before it closes
+      Collect(true);
+      Job close;
+      close.CloseVideo = true;
+      PushJob(std::move(close));
+    }
+    if (!request.ScreenshotPath.empty() || !request.VideoPath.empty())
+      Readback(request);
+  });
+}
+
+void FrameCapture::Readback(const Request& request)
+{
+  if (m_Issued - m_Collected == RingSize)
+  {
+    // the GPU is more than RingSize frames behind
+    if (request.ScreenshotPath.empty())
+    {
+      m_DroppedFrames++;
+      return;
+    }
+    Collect(true);
+  }
+
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  Slot& slot = m_Slots[m_Issued % RingSize];
+  slot.Width = pool.GetWindowWidth();
+  slot.Height = pool.GetWindowHeight();
+  slot.Frame = m_Frame;
+  slot.Source = request;
+
+  size_t size = (size_t)slot.Width * slot.Height * 4;
+  GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer));
+  if (slot.Size != size)
+  {
+    GLCall(glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ));
+    slot.Size = size;
+  }
+  GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, 0));
+  GLCall(glReadBuffer(GL_BACK));
+  GLCall(glReadPixels(0, 0, slot.Width, slot.Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+  GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+  slot.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  m_Issued++;
+}
+
+void FrameCapture::Collect(bool wait)
+{
+  while (m_Collected < m_Issued)
+  {
+    Slot& slot = m_Slots[m_Collected % RingSize];
+    GLenum status = glClientWaitSync(slot.Fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+      break;
+    glDeleteSync(slot.Fence);
+    slot.Fence = nullptr;
+    m_Collected++;
+
+    bool screenshot = !slot.Source.ScreenshotPath.empty();
+    if (!screenshot && m_QueuedFrames >= MaxQueuedFrames)
+    {
+      m_DroppedFrames++;
+      continue;
+    }
+
+    Job job;
+    job.ScreenshotPath = slot.Source.ScreenshotPath;
+    job.VideoPath = slot.Source.VideoPath;
+    job.FramesPerSecond = slot.Source.FramesPerSecond;
+    job.Width = slot.Width;
+    job.Height = slot.Height;
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (!m_FreePixels.empty())
+      {
+        job.Pixels = std::move(m_FreePixels.back());
+        m_FreePixels.pop_back();
+      }
+    }
+    job.Pixels.resize(slot.Size);
+
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.Buffer));
+    void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.Size, GL_MAP_READ_BIT);
+    if (pixels)
+    {
+      std::memcpy(job.Pixels.data(), pixels, slot.Size);
+      GLCall(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    }
+    GLCall(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+
+    m_ReadbackLatency = m_ReadbackLatency * 0.9f + (m_Frame - slot.Frame) * 0.1f;
+    m_CapturedFrames++;
+    PushJob(std::move(job));
+  }
+}
+
+void FrameCapture::PushJob(Job&& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Jobs.push_back(std::move(job));
+    m_QueuedFrames = (unsigned int)m_Jobs.size();
+  }
+  m_Condition.notify_all();
+}
+
+void FrameCapture::EncoderMain()
+{
+  Y4MWriter video;
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_Condition.wait(lock, [this] { return !m_Jobs.empty() || m_Quit; });
+    if (m_Jobs.empty())
+      break;
+
+    Job job = std::move(m_Jobs.front());
+    m_Jobs.pop_front();
+    lock.unlock();
+
+    auto start = std::chrono::steady_clock::now();
+    if (job.CloseVideo)
+      video.Close();
+
+    if (!job.ScreenshotPath.empty() && !ImageWriter::WritePng(job.ScreenshotPath, job.Width, job.Height, job.Pixels.data()))
+      std::cout << "Failed to write screenshot " << job.ScreenshotPath << std::endl;
+
+    if (!job.VideoPath.empty())
+    {
+      if (video.IsOpen() && video.GetPath() != job.VideoPath)
+        video.Close();
+      if (!video.IsOpen() && !video.Open(job.VideoPath, job.Width, job.Height, job.FramesPerSecond))
+        std::cout << "Failed to open " << job.VideoPath << std::endl;
+      // Y4M can't change size mid-stream
+      if (job.Width == video.GetWidth() && job.Height == video.GetHeight())
+        video.WriteFrame(job.Pixels.data());
+      else
+        m_DroppedFrames++;
+    }
+    float encodeTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    lock.lock();
+    if (!job.Pixels.empty())
+      m_FreePixels.push_back(std::move(job.Pixels));
+    m_QueuedFrames = (unsigned int)m_Jobs.size();
+    m_EncodeTime = encodeTime;
+  }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Screenshots (PNG) and continuous recording (Y4M) of the window without
+// stalling the GPU. glReadPixels goes into a ring of pixel pack buffers with a
+// fence each; a buffer is mapped once its fence has signalled, normally a
+// couple of frames later, and the pixels are handed to an encoder thread that
+// does the conversion and file writing.
+//
+// If the ring or the encoder queue is full, video frames are dropped rather
+// than waiting, so recording never perturbs the frame time much; screenshots
+// are never dropped.
+//
+// Requests are made on the main thread; CaptureFrame() records the readback
+// through Renderer::Submit.
+class FrameCapture
+{
+public:
+  static const unsigned int RingSize = 3;
+  static const unsigned int MaxQueuedFrames = 8;
+
+  FrameCapture();
+  ~FrameCapture();
+
+  FrameCapture(const FrameCapture&) = delete;
+  FrameCapture& operator=(const FrameCapture&) = delete;
+
+  void RequestScreenshot(const std::string& path);
+  void StartRecording(const std::string& path, int framesPerSecond = 60);
+  void StopRecording();
+  inline bool IsRecording() const { return m_Recording; }
+
+  // Call once per frame once the image to capture is in the back buffer
+  // (after the scene, before the UI).
+  void CaptureFrame();
+
+  inline unsigned int GetCapturedFrames() const { return m_CapturedFrames; }
+  inline unsigned int GetDroppedFrames() const { return m_DroppedFrames; }
+  inline unsigned int GetQueuedFrames() const { return m_QueuedFrames; }
+  // Frames between glReadPixels and the map, averaged.
+  inline float GetReadbackLatency() const { return m_ReadbackLatency; }
+  inline float GetEncodeTime() const { return m_EncodeTime; }
+private:
+  struct Request
+  {
+    std::string ScreenshotPath;
+    std::string VideoPath;
+    int FramesPerSecond = 60;
+    bool StopVideo = false;
+  };
+
+  struct Slot
+  {
+    unsigned int Buffer = 0;
+    size_t Size = 0;
+    GLsync Fence = nullptr;
+    int Width = 0, Height = 0;
+    unsigned int Frame = 0;
+    Request Source;
+  };
+
+  struct Job
+  {
+    std::string ScreenshotPath;
+    std::string VideoPath;
+    int FramesPerSecond = 60;
+    bool CloseVideo = false;
+    int Width = 0, Height = 0;
+    std::vector<unsigned char> Pixels;
+  };
+
+  // GL thread
+  void Readback(const Request& request);
+  void Collect(bool wait);
+  // encoder thread
+  void EncoderMain();
+  void PushJob(Job&& job);
+
+  // main thread
+  bool m_Recording;
+  bool m_StopPending;
+  Request m_Next;
+
+  // GL thread
+  Slot m_Slots[RingSize];
+  unsigned int m_Issued;
+  unsigned int m_Collected;
+  unsigned int m_Frame;
+
+  std::thread m_Encoder;
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  std::deque<Job> m_Jobs;
+  std::vector<std::vector<unsigned char>> m_FreePixels;
+  bool m_Quit;
+
+  std::atomic<unsigned int> m_CapturedFrames;
+  std::atomic<unsigned int> m_DroppedFrames;
+  std::atomic<unsigned int> m_QueuedFrames;
+  std::atomic<float> m_ReadbackLatency;
+  std::atomic<float> m_EncodeTime;
+};
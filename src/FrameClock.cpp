@@ -0,0 +1,86 @@
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float FrameClock::MaxDeltaTime = 0.25f;
+
+FrameClock::FrameClock()
+  : m_LastTick(std::chrono::steady_clock::now()), m_Time(0.0), m_Accumulator(0.0),
+  m_DeltaTime(0.0f), m_FixedDeltaTime(1.0f / 60.0f), m_MaxStepsPerFrame(8), m_StepsThisFrame(0),
+  m_DroppedSteps(0), m_FrameIndex(0), m_History{}, m_HistoryOffset(0), m_HistoryCount(0)
+{
+}
+
+FrameClock& FrameClock::Get()
+{
+  static FrameClock clock;
+  return clock;
+}
+
+float FrameClock::Tick()
+{
+  auto now = std::chrono::steady_clock::now();
+  double elapsed = std::chrono::duration<double>(now - m_LastTick).count();
+  m_LastTick = now;
+
+  m_History[m_HistoryOffset] = (float)(elapsed * 1000.0);
+  m_HistoryOffset = (m_HistoryOffset + 1) % HistorySize;
+  m_HistoryCount = std::min(m_HistoryCount + 1, (int)HistorySize);
+
+  m_DeltaTime = std::min((float)elapsed, MaxDeltaTime);
+  m_Time += m_DeltaTime;
+  m_Accumulator += m_DeltaTime;
+  m_StepsThisFrame = 0;
+  m_FrameIndex++;
+  return m_DeltaTime;
+}
+
+bool FrameClock::StepFixed()
+{
+  if (m_Accumulator < m_FixedDeltaTime)
+    return false;
+
+  if (m_StepsThisFrame == m_MaxStepsPerFrame)
+  {
+    // spiral of death: the simulation can't keep up, so drop the backlog
+    // instead of running ever more steps next frame
+    double steps = std::floor(m_Accumulator / m_FixedDeltaTime);
+    m_DroppedSteps += (unsigned int)steps;
+    m_Accumulator -= steps * m_FixedDeltaTime;
+    return false;
+  }
+
+  m_Accumulator -= m_FixedDeltaTime;
+  m_StepsThisFrame++;
+  return true;
+}
+
+void FrameClock::SetFixedRate(float hz)
+{
+  m_FixedDeltaTime = 1.0f / std::max(hz, 1.0f);
+}
+
+void FrameClock::SetMaxStepsPerFrame(int steps)
+{
+  m_MaxStepsPerFrame = std::max(steps, 1);
+}
+
+float FrameClock::GetAverageFrameTime() const
+{
+  if (m_HistoryCount == 0)
+    return 0.0f;
+
+  float sum = 0.0f;
+  for (int i = 0; i < m_HistoryCount; i++)
+    sum += m_History[i];
+  return sum / m_HistoryCount;
+}
+
+float FrameClock::GetMaxFrameTime() const
+{
+  float result = 0.0f;
+  for (int i = 0; i < m_HistoryCount; i++)
+    result = std::max(result, m_History[i]);
+  return result;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+
+// High resolution frame clock with a fixed-step accumulator.
+//
+//   float dt = clock.Tick();
+//   while (clock.StepFixed())
+//     OnFixedUpdate(clock.GetFixedDeltaTime());
+//   OnUpdate(dt);
+//   OnRender(clock.GetAlpha());
+class FrameClock
+{
+public:
+  static const int HistorySize = 240;
+
+  FrameClock();
+
+  static FrameClock& Get();
+
+  // Starts a new frame and returns its delta time in seconds, clamped to
+  // MaxDeltaTime so a stall (breakpoint, window drag) can't flood the fixed steps.
+  float Tick();
+  // Consumes one fixed step from the accumulator. Returns false once the
+  // accumulator is drained or MaxStepsPerFrame steps ran this frame.
+  bool StepFixed();
+
+  void SetFixedRate(float hz);
+  void SetMaxStepsPerFrame(int steps);
+
+  inline float GetDeltaTime() const { return m_DeltaTime; }
+  inline double GetTime() const { return m_Time; }
+  inline unsigned long long GetFrameIndex() const { return m_FrameIndex; }
+
+  inline float GetFixedRate() const { return 1.0f / m_FixedDeltaTime; }
+  inline float GetFixedDeltaTime() const { return m_FixedDeltaTime; }
+  inline int GetMaxStepsPerFrame() const { return m_MaxStepsPerFrame; }
+  inline int GetStepsThisFrame() const { return m_StepsThisFrame; }
+  inline unsigned int GetDroppedSteps() const { return m_DroppedSteps; }
+  // Fraction of a fixed step left in the accumulator, for render interpolation.
+  inline float GetAlpha() const { return (float)(m_Accumulator / m_FixedDeltaTime); }
+
+  // Rolling frame time history in milliseconds (unclamped). The oldest sample
+  // is at GetHistoryOffset(), matching ImGui::PlotLines' values_offset.
+  inline const float* GetHistory() const { return m_History; }
+  inline int GetHistoryOffset() const { return m_HistoryOffset; }
+  float GetAverageFrameTime() const;
+  float GetMaxFrameTime() const;
+private:
+  static const float MaxDeltaTime;
+
+  std::chrono::steady_clock::time_point m_LastTick;
+  double m_Time;
+  double m_Accumulator;
+  float m_DeltaTime;
+  float m_FixedDeltaTime;
+  int m_MaxStepsPerFrame;
+  int m_StepsThisFrame;
+  unsigned int m_DroppedSteps;
+  unsigned long long m_FrameIndex;
+
+  float m_History[HistorySize];
+  int m_HistoryOffset;
+  int m_HistoryCount;
+};
@@ -0,0 +1,188 @@
+#include "Framebuffer.h"
+#include "Renderer.h"
+
+#include <iostream>
+
+static GLenum GetInternalFormat(FramebufferFormat format)
+{
+  switch (format)
+  {
+  case FramebufferFormat::RGBA8:           return GL_RGBA8;
+  case FramebufferFormat::RGBA16F:         return GL_RGBA16F;
+  case FramebufferFormat::R11G11B10F:      return GL_R11F_G11F_B10F;
+  case FramebufferFormat::Depth24Stencil8: return GL_DEPTH24_STENCIL8;
+  case FramebufferFormat::Depth32F:        return GL_DEPTH_COMPONENT32F;
+  default:                                 return GL_NONE;
+  }
+}
+
+unsigned int Framebuffer::GetBytesPerPixel(FramebufferFormat format)
+{
+  switch (format)
+  {
+  case FramebufferFormat::RGBA16F: return 8;
+  case FramebufferFormat::None:    return 0;
+  default:                         return 4;
+  }
+}
+
+Framebuffer::Framebuffer(const FramebufferSpec& spec)
+  : m_Spec(spec), m_RendererID(0), m_ColorAttachment(0), m_DepthAttachment(0)
+{
+  Create();
+}
+
+Framebuffer::~Framebuffer()
+{
+  Destroy();
+}
+
+Framebuffer::Framebuffer(Framebuffer&& other) noexcept
+  : m_Spec(other.m_Spec), m_RendererID(other.m_RendererID), m_ColorAttachment(other.m_ColorAttachment),
+  m_DepthAttachment(other.m_DepthAttachment)
+{
+  other.m_RendererID = 0;
+  other.m_ColorAttachment = 0;
+  other.m_DepthAttachment = 0;
+}
+
+Framebuffer& Framebuffer::operator=(Framebuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    Destroy();
+    m_Spec = other.m_Spec;
+    m_RendererID = other.m_RendererID;
+    m_ColorAttachment = other.m_ColorAttachment;
+    m_DepthAttachment = other.m_DepthAttachment;
+    other.m_RendererID = 0;
+    other.m_ColorAttachment = 0;
+    other.m_DepthAttachment = 0;
+  }
+  return *this;
+}
+
+void Framebuffer::Create()
+{
+  GLCall(glGenFramebuffers(1, &m_RendererID));
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+  bool multisampled = m_Spec.Samples > 1;
+  if (m_Spec.ColorFormat != FramebufferFormat::None)
+  {
+    GLenum format = GetInternalFormat(m_Spec.ColorFormat);
+    if (multisampled)
+    {
+      GLCall(glGenRenderbuffers(1, &m_ColorAttachment));
+      GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorAttachment));
+      GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Spec.Samples, format, m_Spec.Width, m_Spec.Height));
+      GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_ColorAttachment));
+    }
+    else
+    {
+      GLCall(glGenTextures(1, &m_ColorAttachment));
+      GLCall(glBindTexture(GL_TEXTURE_2D, m_ColorAttachment));
+      GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+      GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+      GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+      GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+      // the format/type pair only describes the (absent) upload data
+      GLCall(glTexImage2D(GL_TEXTURE_2D, 0, format, m_Spec.Width, m_Spec.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+      GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+      GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0));
+    }
+  }
+  else
+  {
+    GLCall(glDrawBuffer(GL_NONE));
+    GLCall(glReadBuffer(GL_NONE));
+  }
+
+  if (m_Spec.DepthFormat != FramebufferFormat::None)
+  {
+    GLenum attachment = m_Spec.DepthFormat == FramebufferFormat::Depth24Stencil8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+    GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glRenderbufferStorageMultisample(GL_RENDERBUFFER, multisampled ? m_Spec.Samples : 0,
+      GetInternalFormat(m_Spec.DepthFormat), m_Spec.Width, m_Spec.Height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, m_DepthAttachment));
+  }
+  GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "Framebuffer " << m_Spec.Width << "x" << m_Spec.Height << " incomplete: 0x" << std::hex << status << std::dec << std::endl;
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void Framebuffer::Destroy()
+{
+  glDeleteFramebuffers(1, &m_RendererID);
+  if (m_Spec.Samples > 1)
+    glDeleteRenderbuffers(1, &m_ColorAttachment);
+  else
+    glDeleteTextures(1, &m_ColorAttachment);
+  glDeleteRenderbuffers(1, &m_DepthAttachment);
+  m_RendererID = m_ColorAttachment = m_DepthAttachment = 0;
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+  if (width == m_Spec.Width && height == m_Spec.Height)
+    return;
+
+  Destroy();
+  m_Spec.Width = width;
+  m_Spec.Height = height;
+  Create();
+}
+
+void Framebuffer::Bind() const
+{
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+  GLCall(glViewport(0, 0, m_Spec.Width, m_Spec.Height));
+}
+
+void Framebuffer::BindDefault(int width, int height)
+{
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+  GLCall(glViewport(0, 0, width, height));
+}
+
+void Framebuffer::BindColorTexture(unsigned int slot) const
+{
+  ASSERT(m_Spec.Samples <= 1);
+  GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_ColorAttachment));
+}
+
+void Framebuffer::Blit(const Framebuffer& target) const
+{
+  bool depth = m_DepthAttachment && target.m_DepthAttachment && m_Spec.DepthFormat == target.m_Spec.DepthFormat;
+  BlitTo(target.m_RendererID, target.m_Spec.Width, target.m_Spec.Height, depth);
+}
+
+void Framebuffer::BlitToDefault(int width, int height) const
+{
+  BlitTo(0, width, height, false);
+}
+
+void Framebuffer::BlitTo(unsigned int framebuffer, int width, int height, bool depth) const
+{
+  // depth can only be copied 1:1 with nearest filtering
+  bool sameSize = width == m_Spec.Width && height == m_Spec.Height;
+  ASSERT(sameSize || m_Spec.Samples <= 1);
+  GLbitfield mask = GL_COLOR_BUFFER_BIT | (depth && sameSize ? GL_DEPTH_BUFFER_BIT : 0);
+  GLenum filter = sameSize ? GL_NEAREST : GL_LINEAR;
+
+  GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+  GLCall(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer));
+  GLCall(glBlitFramebuffer(0, 0, m_Spec.Width, m_Spec.Height, 0, 0, width, height, mask, filter));
+  GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+size_t Framebuffer::GetMemoryUsage() const
+{
+  size_t pixels = (size_t)m_Spec.Width * m_Spec.Height * (m_Spec.Samples > 1 ? m_Spec.Samples : 1);
+  return pixels * (GetBytesPerPixel(m_Spec.ColorFormat) + GetBytesPerPixel(m_Spec.DepthFormat));
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+
+enum class FramebufferFormat
+{
+  None,
+  RGBA8,
+  RGBA16F,
+  R11G11B10F,
+  Depth24Stencil8,
+  Depth32F
+};
+
+struct FramebufferSpec
+{
+  int Width = 0;
+  int Height = 0;
+  FramebufferFormat ColorFormat = FramebufferFormat::RGBA8;
+  FramebufferFormat DepthFormat = FramebufferFormat::None;
+  // more than 1 gives multisampled renderbuffers, which have to be resolved
+  // (Blit) into a single-sampled target before they can be sampled
+  int Samples = 1;
+
+  bool operator==(const FramebufferSpec& other) const
+  {
+    return Width == other.Width && Height == other.Height && ColorFormat == other.ColorFormat &&
+      DepthFormat == other.DepthFormat && Samples == other.Samples;
+  }
+  bool operator!=(const FramebufferSpec& other) const { return !(*this == other); }
+};
+
+// Offscreen render target with one color and an optional depth attachment.
+// Single-sampled color is a texture (bind it to sample the result); depth and
+// multisampled color are renderbuffers.
+class Framebuffer
+{
+public:
+  Framebuffer(const FramebufferSpec& spec);
+  ~Framebuffer();
+
+  Framebuffer(const Framebuffer&) = delete;
+  Framebuffer& operator=(const Framebuffer&) = delete;
+  Framebuffer(Framebuffer&& other) noexcept;
+  Framebuffer& operator=(Framebuffer&& other) noexcept;
+
+  // Binds for drawing and sets the viewport to the whole target.
+  void Bind() const;
+  // Back to the window, with a viewport of the given size.
+  static void BindDefault(int width, int height);
+
+  // Recreates the attachments; contents are lost.
+  void Resize(int width, int height);
+
+  void BindColorTexture(unsigned int slot = 0) const;
+  // Copies color (and depth, when both have it) into target, resolving
+  // multisampling. Single-sampled sources may also scale, with linear
+  // filtering; multisampled ones have to resolve at the same size.
+  void Blit(const Framebuffer& target) const;
+  // Same, into the window's framebuffer.
+  void BlitToDefault(int width, int height) const;
+  // Same, into a framebuffer by GL name (0 is the window) covering
+  // [0, width) x [0, height); e.g. whatever target a caller had bound.
+  void BlitTo(unsigned int framebuffer, int width, int height, bool depth = false) const;
+
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+  inline unsigned int GetColorAttachment() const { return m_ColorAttachment; }
+  inline const FramebufferSpec& GetSpec() const { return m_Spec; }
+  inline int GetWidth() const { return m_Spec.Width; }
+  inline int GetHeight() const { return m_Spec.Height; }
+  // Estimated from formats, size and sample count.
+  size_t GetMemoryUsage() const;
+
+  static unsigned int GetBytesPerPixel(FramebufferFormat format);
+private:
+  void Create();
+  void Destroy();
+
+  FramebufferSpec m_Spec;
+  unsigned int m_RendererID;
+  unsigned int m_ColorAttachment;
+  unsigned int m_DepthAttachment;
+};
@@ -0,0 +1,91 @@
+#include "GLBuffer.h"
+#include "Renderer.h"
+#include "GLCapabilities.h"
+
+GLBuffer::GLBuffer(unsigned int target, unsigned int size, unsigned int usage)
+  : m_Target(target), m_Size(size), m_Usage(usage)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glCreateBuffers(1, &m_RendererID));
+    GLCall(glNamedBufferData(m_RendererID, size, nullptr, usage));
+    return;
+  }
+
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLCall(glBindBuffer(target, m_RendererID));
+  GLCall(glBufferData(target, size, nullptr, usage));
+  GLCall(glBindBuffer(target, 0));
+}
+
+GLBuffer::~GLBuffer()
+{
+  GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+GLBuffer::GLBuffer(GLBuffer&& other) noexcept
+  : m_RendererID(other.m_RendererID), m_Target(other.m_Target), m_Size(other.m_Size), m_Usage(other.m_Usage)
+{
+  other.m_RendererID = 0;
+  other.m_Size = 0;
+}
+
+GLBuffer& GLBuffer::operator=(GLBuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteBuffers(1, &m_RendererID);
+    m_RendererID = other.m_RendererID;
+    m_Target = other.m_Target;
+    m_Size = other.m_Size;
+    m_Usage = other.m_Usage;
+    other.m_RendererID = 0;
+    other.m_Size = 0;
+  }
+  return *this;
+}
+
+void GLBuffer::SetData(const void* data, unsigned int size)
+{
+  ASSERT(size <= m_Size);
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glNamedBufferData(m_RendererID, m_Size, nullptr, m_Usage));
+    if (size > 0)
+      GLCall(glNamedBufferSubData(m_RendererID, 0, size, data));
+    return;
+  }
+
+  GLCall(glBindBuffer(m_Target, m_RendererID));
+  GLCall(glBufferData(m_Target, m_Size, nullptr, m_Usage));
+  if (size > 0)
+    GLCall(glBufferSubData(m_Target, 0, size, data));
+}
+
+void GLBuffer::SetSubData(unsigned int offset, const void* data, unsigned int size)
+{
+  ASSERT(offset + size <= m_Size);
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glNamedBufferSubData(m_RendererID, offset, size, data));
+    return;
+  }
+
+  GLCall(glBindBuffer(m_Target, m_RendererID));
+  GLCall(glBufferSubData(m_Target, offset, size, data));
+}
+
+void GLBuffer::Bind() const
+{
+  GLCall(glBindBuffer(m_Target, m_RendererID));
+}
+
+void GLBuffer::Unbind() const
+{
+  GLCall(glBindBuffer(m_Target, 0));
+}
+
+void GLBuffer::BindBase(unsigned int index) const
+{
+  GLCall(glBindBufferBase(m_Target, index, m_RendererID));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Buffer object for targets without a dedicated wrapper, e.g.
+// GL_UNIFORM_BUFFER or GL_DRAW_INDIRECT_BUFFER. Storage is fixed at
+// creation; SetData() orphans it before uploading so the driver doesn't
+// have to wait for draws still reading the old contents.
+class GLBuffer
+{
+public:
+  // size bytes of uninitialised storage; usage as in glBufferData.
+  GLBuffer(unsigned int target, unsigned int size, unsigned int usage);
+  ~GLBuffer();
+
+  // Owns the GL name: move-only, a moved-from buffer holds 0.
+  GLBuffer(const GLBuffer&) = delete;
+  GLBuffer& operator=(const GLBuffer&) = delete;
+  GLBuffer(GLBuffer&& other) noexcept;
+  GLBuffer& operator=(GLBuffer&& other) noexcept;
+
+  void SetData(const void* data, unsigned int size);
+  void SetSubData(unsigned int offset, const void* data, unsigned int size);
+
+  void Bind() const;
+  void Unbind() const;
+  // For indexed targets (uniform, transform feedback...).
+  void BindBase(unsigned int index) const;
+
+  inline unsigned int GetTarget() const { return m_Target; }
+  inline unsigned int GetSize() const { return m_Size; }
+  inline unsigned int GetRendererID() const { return m_RendererID; }
+private:
+  unsigned int m_RendererID;
+  unsigned int m_Target;
+  unsigned int m_Size;
+  unsigned int m_Usage;
+};
@@ -0,0 +1,92 @@
+#include "GLCapabilities.h"
+
+#include <cstring>
+#include <iostream>
+
+int GLCapabilities::s_MajorVersion = 0;
+int GLCapabilities::s_MinorVersion = 0;
+bool GLCapabilities::s_DirectStateAccess = false;
+bool GLCapabilities::s_VertexAttribBinding = false;
+bool GLCapabilities::s_MultiDrawIndirect = false;
+
+// glad only loads the 4.5 entry points on a 4.5 context; ARB_direct_state_access
+// exposes the same unsuffixed names on older ones.
+#define LOAD_IF_MISSING(name) if (!glad_##name) glad_##name = (decltype(glad_##name))load(#name)
+
+static bool LoadDirectStateAccess(GLADloadproc load)
+{
+  LOAD_IF_MISSING(glCreateBuffers);
+  LOAD_IF_MISSING(glNamedBufferData);
+  LOAD_IF_MISSING(glNamedBufferSubData);
+  LOAD_IF_MISSING(glMapNamedBufferRange);
+  LOAD_IF_MISSING(glUnmapNamedBuffer);
+  LOAD_IF_MISSING(glCreateTextures);
+  LOAD_IF_MISSING(glTextureStorage2D);
+  LOAD_IF_MISSING(glTextureSubImage2D);
+  LOAD_IF_MISSING(glTextureParameteri);
+  LOAD_IF_MISSING(glBindTextureUnit);
+  LOAD_IF_MISSING(glCreateVertexArrays);
+  LOAD_IF_MISSING(glEnableVertexArrayAttrib);
+  LOAD_IF_MISSING(glVertexArrayAttribFormat);
+  LOAD_IF_MISSING(glVertexArrayAttribBinding);
+  LOAD_IF_MISSING(glVertexArrayVertexBuffer);
+  LOAD_IF_MISSING(glVertexArrayBindingDivisor);
+
+  return glCreateBuffers && glNamedBufferData && glNamedBufferSubData && glMapNamedBufferRange && glUnmapNamedBuffer
+    && glCreateTextures && glTextureStorage2D && glTextureSubImage2D && glTextureParameteri && glBindTextureUnit
+    && glCreateVertexArrays && glEnableVertexArrayAttrib && glVertexArrayAttribFormat && glVertexArrayAttribBinding
+    && glVertexArrayVertexBuffer && glVertexArrayBindingDivisor;
+}
+
+static bool LoadVertexAttribBinding(GLADloadproc load)
+{
+  LOAD_IF_MISSING(glVertexAttribFormat);
+  LOAD_IF_MISSING(glVertexAttribBinding);
+  LOAD_IF_MISSING(glVertexBindingDivisor);
+  LOAD_IF_MISSING(glBindVertexBuffer);
+
+  return glVertexAttribFormat && glVertexAttribBinding && glVertexBindingDivisor && glBindVertexBuffer;
+}
+
+static bool LoadMultiDrawIndirect(GLADloadproc load)
+{
+  LOAD_IF_MISSING(glMultiDrawElementsIndirect);
+
+  return glMultiDrawElementsIndirect != nullptr;
+}
+
+#undef LOAD_IF_MISSING
+
+void GLCapabilities::Initialize(GLADloadproc load)
+{
+  s_MajorVersion = GLVersion.major;
+  s_MinorVersion = GLVersion.minor;
+
+  bool core45 = s_MajorVersion > 4 || (s_MajorVersion == 4 && s_MinorVersion >= 5);
+  if (core45 || HasExtension("GL_ARB_direct_state_access"))
+    s_DirectStateAccess = LoadDirectStateAccess(load);
+
+  bool core43 = s_MajorVersion > 4 || (s_MajorVersion == 4 && s_MinorVersion >= 3);
+  if (core43 || HasExtension("GL_ARB_vertex_attrib_binding"))
+    s_VertexAttribBinding = LoadVertexAttribBinding(load);
+  if (core43 || (HasExtension("GL_ARB_multi_draw_indirect") && HasExtension("GL_ARB_base_instance")))
+    s_MultiDrawIndirect = LoadMultiDrawIndirect(load);
+
+  std::cout << "OpenGL " << glGetString(GL_VERSION) << " (" << glGetString(GL_RENDERER) << "), direct state access "
+    << (s_DirectStateAccess ? "on" : "off")
+    << ", vertex attrib binding " << (s_VertexAttribBinding ? "on" : "off")
+    << ", multi-draw indirect " << (s_MultiDrawIndirect ? "on" : "off") << std::endl;
+}
+
+bool GLCapabilities::HasExtension(const char* name)
+{
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for (GLint i = 0; i < count; i++)
+  {
+    const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+    if (extension && std::strcmp(extension, name) == 0)
+      return true;
+  }
+  return false;
+}
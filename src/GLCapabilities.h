@@ -0,0 +1,34 @@
+#pragma once
+#include <glad/glad.h>
+
+// What the current context can do beyond the GL 3.3 core baseline the app
+// asks for. Initialize() once the context is current and glad is loaded;
+// the wrappers (VertexBuffer, IndexBuffer, VertexArray, Texture) check it
+// to pick between the bind-to-edit path and direct state access.
+class GLCapabilities
+{
+public:
+  static void Initialize(GLADloadproc load);
+
+  inline static int GetMajorVersion() { return s_MajorVersion; }
+  inline static int GetMinorVersion() { return s_MinorVersion; }
+  static bool HasExtension(const char* name);
+
+  // GL 4.5 or ARB_direct_state_access: resources are created and edited by
+  // name, without touching the bindings the draws rely on.
+  inline static bool HasDirectStateAccess() { return s_DirectStateAccess; }
+  // GL 4.3 or ARB_vertex_attrib_binding: attribute formats are VAO state
+  // separate from the buffers feeding them (see VertexFormat).
+  inline static bool HasVertexAttribBinding() { return s_VertexAttribBinding; }
+
+  // GL 4.3 or ARB_multi_draw_indirect + ARB_base_instance: a whole list of
+  // draws from a GL_DRAW_INDIRECT_BUFFER in one call, with per-draw data
+  // fetched through the base instance.
+  inline static bool HasMultiDrawIndirect() { return s_MultiDrawIndirect; }
+private:
+  static int s_MajorVersion;
+  static int s_MinorVersion;
+  static bool s_DirectStateAccess;
+  static bool s_VertexAttribBinding;
+  static bool s_MultiDrawIndirect;
+};
@@ -0,0 +1,67 @@
+#include "GeometryPool.h"
+#include "Renderer.h"
+#include "VertexFormat.h"
+
+GeometryPool::GeometryPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices, unsigned int maxMeshes)
+  : m_Layout(layout), m_Format(VertexFormat::Get(layout)),
+  m_VertexBuffer(maxVertices * layout.GetStride()), m_IndexBuffer(maxIndices),
+  // every live mesh can be followed by a free gap, each a node of its own
+  m_VertexAllocator(maxVertices, maxMeshes * 2 + 1), m_IndexAllocator(maxIndices, maxMeshes * 2 + 1), m_MeshCount(0)
+{
+}
+
+GeometryHandle GeometryPool::Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+  GeometryHandle handle;
+  handle.Vertices = m_VertexAllocator.Allocate(vertexCount);
+  handle.Indices = m_IndexAllocator.Allocate(indexCount);
+  if (!handle.IsValid())
+  {
+    m_VertexAllocator.Free(handle.Vertices);
+    m_IndexAllocator.Free(handle.Indices);
+    return GeometryHandle();
+  }
+  handle.VertexCount = vertexCount;
+  handle.IndexCount = indexCount;
+
+  unsigned int stride = m_Layout.GetStride();
+  m_VertexBuffer.SetSubData(handle.GetBaseVertex() * stride, vertices, vertexCount * stride);
+  m_IndexBuffer.SetSubData(handle.GetFirstIndex(), indices, indexCount);
+  m_MeshCount++;
+  return handle;
+}
+
+void GeometryPool::Free(GeometryHandle& handle)
+{
+  if (!handle.IsValid())
+    return;
+
+  m_VertexAllocator.Free(handle.Vertices);
+  m_IndexAllocator.Free(handle.Indices);
+  m_MeshCount--;
+  handle = GeometryHandle();
+}
+
+void GeometryPool::Bind() const
+{
+  m_Format.BindVertexBuffer(m_VertexBuffer);
+}
+
+void GeometryPool::Draw(const GeometryHandle& handle, const Shader& shader) const
+{
+  Renderer renderer;
+  renderer.Draw(m_Format, m_IndexBuffer, shader, handle.IndexCount, handle.GetFirstIndex(), (int)handle.GetBaseVertex());
+}
+
+GeometryPoolStats GeometryPool::GetStats() const
+{
+  GeometryPoolStats stats;
+  stats.MeshCount = m_MeshCount;
+  stats.VertexCapacity = m_VertexAllocator.GetSize();
+  stats.UsedVertices = stats.VertexCapacity - m_VertexAllocator.GetFree();
+  stats.IndexCapacity = m_IndexAllocator.GetSize();
+  stats.UsedIndices = stats.IndexCapacity - m_IndexAllocator.GetFree();
+  stats.VertexReport = m_VertexAllocator.GetReport();
+  stats.IndexReport = m_IndexAllocator.GetReport();
+  return stats;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "OffsetAllocator.h"
+#include "IndexBuffer.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+class Shader;
+class VertexFormat;
+
+// A mesh living in a GeometryPool. Indices are relative to BaseVertex.
+struct GeometryHandle
+{
+  OffsetAllocation Vertices;
+  OffsetAllocation Indices;
+  unsigned int VertexCount = 0;
+  unsigned int IndexCount = 0;
+
+  inline unsigned int GetBaseVertex() const { return Vertices.Offset; }
+  inline unsigned int GetFirstIndex() const { return Indices.Offset; }
+  inline bool IsValid() const { return Vertices.IsValid() && Indices.IsValid(); }
+};
+
+struct GeometryPoolStats
+{
+  unsigned int MeshCount;
+  unsigned int UsedVertices, VertexCapacity;
+  unsigned int UsedIndices, IndexCapacity;
+  OffsetAllocatorReport VertexReport;
+  OffsetAllocatorReport IndexReport;
+};
+
+// One large vertex buffer (for a single layout) and one index buffer shared by
+// many meshes. Ranges are sub-allocated with an OffsetAllocator and meshes are
+// drawn with glDrawElementsBaseVertex through the layout's shared VAO, so
+// switching mesh costs no buffer or VAO changes at all.
+class GeometryPool
+{
+public:
+  GeometryPool(const VertexBufferLayout& layout, unsigned int maxVertices, unsigned int maxIndices, unsigned int maxMeshes = 16 * 1024);
+
+  // Returns an invalid handle when either buffer has no room left.
+  GeometryHandle Allocate(const void* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+  void Free(GeometryHandle& handle);
+
+  // Attaches the pool's buffers to the layout's VAO; call before drawing.
+  void Bind() const;
+  void Draw(const GeometryHandle& handle, const Shader& shader) const;
+
+  GeometryPoolStats GetStats() const;
+  inline const VertexBuffer& GetVertexBuffer() const { return m_VertexBuffer; }
+  inline const IndexBuffer& GetIndexBuffer() const { return m_IndexBuffer; }
+  inline const VertexBufferLayout& GetLayout() const { return m_Layout; }
+private:
+  VertexBufferLayout m_Layout;
+  const VertexFormat& m_Format;
+  VertexBuffer m_VertexBuffer;
+  IndexBuffer m_IndexBuffer;
+  OffsetAllocator m_VertexAllocator;
+  OffsetAllocator m_IndexAllocator;
+  unsigned int m_MeshCount;
+};
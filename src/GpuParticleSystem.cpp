@@ -0,0 +1,210 @@
+#include "GpuParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const unsigned int s_SpawnBufferBinding = 0;
+
+GpuParticleSystem::GpuParticleSystem(unsigned int capacity)
+  : m_Capacity(capacity), m_Current(0), m_SpawnedTotal(0), m_WindowBegin(0), m_Time(0.0f), m_Seed(0x9e3779b9u),
+  m_Spawned(0), m_Overwritten(0), m_UpdateGpuTime(0.0f), m_RenderGpuTime(0.0f),
+  m_SpawnBuffer(GL_UNIFORM_BUFFER, MaxSpawnBatches * (unsigned int)sizeof(SpawnBatch), GL_STREAM_DRAW)
+{
+  for (int i = 0; i < 2; i++)
+  {
+    m_StateBuffers[i] = std::make_unique<VertexBuffer>(capacity * (unsigned int)sizeof(GpuParticle));
+    m_StateArrays[i] = std::make_unique<VertexArray>();
+    m_StateArrays[i]->AddBuffer<GpuParticle>(*m_StateBuffers[i]);
+  }
+
+  m_UpdateShader = std::make_unique<Shader>("res/shaders/GpuParticleUpdate.shader",
+    std::vector<std::string>{ "v_Position", "v_Velocity", "v_Age", "v_Lifetime" });
+  m_UpdateShader->Bind();
+  m_UpdateShader->SetUniformBlockBinding("SpawnBuffer", s_SpawnBufferBinding);
+  m_UpdateShader->SetUniform1i("u_Capacity", capacity);
+  m_Shader = std::make_unique<Shader>("res/shaders/GpuParticle.shader");
+}
+
+GpuParticleSystem::~GpuParticleSystem()
+{
+}
+
+unsigned int GpuParticleSystem::AddEmitter(const ParticleEmitter& emitter)
+{
+  ASSERT(m_Emitters.size() < MaxSpawnBatches);
+  m_Emitters.push_back(emitter);
+  m_EmitAccumulators.push_back(0.0f);
+  return (unsigned int)m_Emitters.size() - 1;
+}
+
+void GpuParticleSystem::Clear()
+{
+  // an empty window; the stale slots are never read again
+  m_WindowBegin = m_SpawnedTotal;
+  m_Generations.clear();
+  std::fill(m_EmitAccumulators.begin(), m_EmitAccumulators.end(), 0.0f);
+}
+
+GpuParticleStats GpuParticleSystem::GetStats() const
+{
+  GpuParticleStats stats;
+  stats.Window = (unsigned int)(m_SpawnedTotal - m_WindowBegin);
+  stats.Spawned = m_Spawned;
+  stats.Overwritten = m_Overwritten;
+  stats.UpdateGpuTime = m_UpdateGpuTime;
+  stats.RenderGpuTime = m_RenderGpuTime;
+  return stats;
+}
+
+GpuParticleSystem::Window GpuParticleSystem::GetWindow() const
+{
+  Window window;
+  unsigned int count = (unsigned int)(m_SpawnedTotal - m_WindowBegin);
+  unsigned int first = (unsigned int)(m_WindowBegin % m_Capacity);
+  unsigned int head = std::min(count, m_Capacity - first);
+  window.Segments[0] = { first, head };
+  window.Segments[1] = { 0, count - head };
+  window.SegmentCount = count == 0 ? 0 : (head < count ? 2 : 1);
+  return window;
+}
+
+void GpuParticleSystem::Update(float deltaTime)
+{
+  m_Time += deltaTime;
+  m_Spawned = 0;
+  m_Overwritten = 0;
+
+  std::array<SpawnBatch, MaxSpawnBatches> batches;
+  unsigned int batchCount = 0;
+  float expireTime = m_Time;
+  for (size_t e = 0; e < m_Emitters.size(); e++)
+  {
+    const ParticleEmitter& emitter = m_Emitters[e];
+    if (!emitter.Enabled)
+    {
+      m_EmitAccumulators[e] = 0.0f;
+      continue;
+    }
+
+    m_EmitAccumulators[e] += emitter.Rate * deltaTime;
+    unsigned int spawn = (unsigned int)m_EmitAccumulators[e];
+    m_EmitAccumulators[e] -= (float)spawn;
+    // a batch may not cover a slot twice
+    spawn = std::min(spawn, m_Capacity - m_Spawned);
+    if (spawn == 0)
+      continue;
+
+    m_Seed = m_Seed * 1664525u + 1013904223u;
+    SpawnBatch& batch = batches[batchCount++];
+    batch.Range = glm::uvec4((unsigned int)(m_SpawnedTotal % m_Capacity), spawn, m_Seed, 0);
+    batch.Area = glm::vec4(emitter.Position, emitter.HalfExtent);
+    batch.Velocity = glm::vec4(emitter.Direction, emitter.Spread, emitter.SpeedMin, emitter.SpeedMax);
+    batch.Lifetime = glm::vec4(emitter.LifetimeMin, emitter.LifetimeMax, 0.0f, 0.0f);
+
+    m_SpawnedTotal += spawn;
+    m_Spawned += spawn;
+    expireTime = std::max(expireTime, m_Time + emitter.LifetimeMax);
+  }
+  if (m_Spawned > 0)
+    m_Generations.push_back({ m_SpawnedTotal, expireTime });
+
+  // the window starts at the oldest generation that may still have live particles
+  while (!m_Generations.empty() && m_Generations.front().ExpireTime <= m_Time)
+  {
+    m_WindowBegin = std::max(m_WindowBegin, m_Generations.front().End);
+    m_Generations.pop_front();
+  }
+  if (m_SpawnedTotal - m_WindowBegin > m_Capacity)
+  {
+    m_Overwritten = (unsigned int)(m_SpawnedTotal - m_WindowBegin - m_Capacity);
+    m_WindowBegin = m_SpawnedTotal - m_Capacity;
+  }
+
+  Window window = GetWindow();
+  if (window.SegmentCount == 0)
+    return;
+
+  unsigned int source = m_Current;
+  m_Current = 1 - m_Current;
+  float damping = std::exp(-m_Modules.Drag * deltaTime);
+  glm::vec2 gravity = m_Modules.Gravity;
+  Renderer::Submit([this, batches, batchCount, window, source, deltaTime, damping, gravity]() {
+    Simulate(batches, batchCount, window, source, deltaTime, damping, gravity);
+  });
+}
+
+void GpuParticleSystem::Simulate(const std::array<SpawnBatch, MaxSpawnBatches>& batches, unsigned int batchCount,
+  const Window& window, unsigned int source, float deltaTime, float damping, glm::vec2 gravity)
+{
+  float gpuTime;
+  if (m_UpdateTimer.Poll(gpuTime))
+    m_UpdateGpuTime = gpuTime;
+  m_UpdateTimer.Begin();
+
+  m_SpawnBuffer.SetData(batches.data(), batchCount * (unsigned int)sizeof(SpawnBatch));
+  m_SpawnBuffer.BindBase(s_SpawnBufferBinding);
+
+  m_UpdateShader->Bind();
+  m_UpdateShader->SetUniform1i("u_SpawnBatchCount", batchCount);
+  m_UpdateShader->SetUniform1f("u_DeltaTime", deltaTime);
+  m_UpdateShader->SetUniform1f("u_Damping", damping);
+  m_UpdateShader->SetUniform2f("u_Gravity", gravity.x, gravity.y);
+
+  // each segment is written back to the same slots of the other buffer
+  unsigned int target = m_StateBuffers[1 - source]->GetRendererID();
+  Renderer renderer;
+  GLCall(glEnable(GL_RASTERIZER_DISCARD));
+  for (unsigned int i = 0; i < window.SegmentCount; i++)
+  {
+    const Segment& segment = window.Segments[i];
+    GLCall(glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, target, (GLintptr)segment.First * sizeof(GpuParticle),
+      (GLsizeiptr)segment.Count * sizeof(GpuParticle)));
+    GLCall(glBeginTransformFeedback(GL_POINTS));
+    renderer.DrawPoints(*m_StateArrays[source], *m_UpdateShader, segment.Count, segment.First);
+    GLCall(glEndTransformFeedback());
+  }
+  GLCall(glDisable(GL_RASTERIZER_DISCARD));
+  GLCall(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0));
+
+  m_UpdateTimer.End();
+}
+
+void GpuParticleSystem::Render(const glm::mat4& viewProj)
+{
+  Window window = GetWindow();
+  if (window.SegmentCount == 0)
+    return;
+
+  unsigned int current = m_Current;
+  ParticleModules modules = m_Modules;
+  Renderer::Submit([this, window, current, viewProj, modules]() { Draw(window, current, viewProj, modules); });
+}
+
+void GpuParticleSystem::Draw(const Window& window, unsigned int source, const glm::mat4& viewProj, const ParticleModules& modules)
+{
+  float gpuTime;
+  if (m_RenderTimer.Poll(gpuTime))
+    m_RenderGpuTime = gpuTime;
+  m_RenderTimer.Begin();
+
+  // point sizes are in pixels; the modules give them in world units
+  int viewport[4];
+  GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+  float pixelScale = viewProj[0][0] * viewport[2] * 0.5f;
+
+  m_Shader->Bind();
+  m_Shader->SetUniformMat4f("u_ViewProj", viewProj);
+  m_Shader->SetUniform4f("u_StartColor", modules.StartColor.r, modules.StartColor.g, modules.StartColor.b, modules.StartColor.a);
+  m_Shader->SetUniform4f("u_EndColor", modules.EndColor.r, modules.EndColor.g, modules.EndColor.b, modules.EndColor.a);
+  m_Shader->SetUniform1f("u_StartSize", modules.StartSize);
+  m_Shader->SetUniform1f("u_EndSize", modules.EndSize);
+  m_Shader->SetUniform1f("u_PixelScale", pixelScale);
+
+  Renderer renderer;
+  GLCall(glEnable(GL_PROGRAM_POINT_SIZE));
+  for (unsigned int i = 0; i < window.SegmentCount; i++)
+    renderer.DrawPoints(*m_StateArrays[source], *m_Shader, window.Segments[i].Count, window.Segments[i].First);
+  GLCall(glDisable(GL_PROGRAM_POINT_SIZE));
+
+  m_RenderTimer.End();
+}
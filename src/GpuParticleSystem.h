@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "ParticleSystem.h"
+#include "GLBuffer.h"
+#include "GpuTimer.h"
+
+// Simulation state of one particle, as captured by transform feedback.
+struct GpuParticle
+{
+  glm::vec2 Position;
+  glm::vec2 Velocity;
+  float Age;
+  float Lifetime;
+};
+VERTEX_LAYOUT(GpuParticle, Position, Velocity, Age, Lifetime);
+
+struct GpuParticleStats
+{
+  // slots updated and drawn: everything spawned within the longest lifetime
+  unsigned int Window = 0;
+  unsigned int Spawned = 0;
+  // slots reused before their generation expired because the ring was full
+  unsigned int Overwritten = 0;
+  // milliseconds, measured a frame or two late
+  float UpdateGpuTime = 0.0f;
+  float RenderGpuTime = 0.0f;
+};
+
+// Particles that live on the GPU. The state ping-pongs between two buffers:
+// each frame a vertex-only pass reads one and writes the other through
+// transform feedback with the rasterizer off, and the points are then drawn
+// straight from the buffer just written. Nothing but a small spawn buffer
+// crosses the bus.
+//
+// Slots are handed out as a ring, so new particles always go at the front
+// and everything spawned longer ago than the longest lifetime is dead. Only
+// that window is updated and drawn; particles that die earlier stay in it
+// and are culled in the vertex shader. Emitters are described per frame by
+// a spawn batch (first slot, count, seed, emitter parameters), and the
+// update pass initializes the slots covered by a batch instead of
+// integrating them.
+//
+// Uses the same emitters and modules as the CPU ParticleSystem. Update()
+// and Render() run on the main thread and submit the GL work.
+class GpuParticleSystem
+{
+public:
+  static const unsigned int MaxSpawnBatches = 16;
+
+  GpuParticleSystem(unsigned int capacity);
+  ~GpuParticleSystem();
+
+  GpuParticleSystem(const GpuParticleSystem&) = delete;
+  GpuParticleSystem& operator=(const GpuParticleSystem&) = delete;
+
+  // Up to MaxSpawnBatches emitters.
+  unsigned int AddEmitter(const ParticleEmitter& emitter);
+  inline ParticleEmitter& GetEmitter(unsigned int index) { return m_Emitters[index]; }
+  inline unsigned int GetEmitterCount() const { return (unsigned int)m_Emitters.size(); }
+  inline ParticleModules& GetModules() { return m_Modules; }
+
+  void Update(float deltaTime);
+  void Render(const glm::mat4& viewProj);
+  void Clear();
+
+  inline unsigned int GetCapacity() const { return m_Capacity; }
+  GpuParticleStats GetStats() const;
+private:
+  // std140 mirror of SpawnBatch in GpuParticleUpdate.shader
+  struct SpawnBatch
+  {
+    glm::uvec4 Range;
+    glm::vec4 Area;
+    glm::vec4 Velocity;
+    glm::vec4 Lifetime;
+  };
+  struct Segment
+  {
+    unsigned int First, Count;
+  };
+  // the ring window: [first slot, count), split in two where it wraps
+  struct Window
+  {
+    Segment Segments[2];
+    unsigned int SegmentCount;
+  };
+  // particles spawned in one frame, all dead after ExpireTime
+  struct Generation
+  {
+    unsigned long long End;
+    float ExpireTime;
+  };
+
+  Window GetWindow() const;
+  void Simulate(const std::array<SpawnBatch, MaxSpawnBatches>& batches, unsigned int batchCount, const Window& window,
+    unsigned int source, float deltaTime, float damping, glm::vec2 gravity);
+  void Draw(const Window& window, unsigned int source, const glm::mat4& viewProj, const ParticleModules& modules);
+
+  unsigned int m_Capacity;
+  // buffer holding the newest state
+  unsigned int m_Current;
+  // running slot counters; slot = counter % capacity
+  unsigned long long m_SpawnedTotal;
+  unsigned long long m_WindowBegin;
+  std::deque<Generation> m_Generations;
+  float m_Time;
+  unsigned int m_Seed;
+
+  std::vector<ParticleEmitter> m_Emitters;
+  std::vector<float> m_EmitAccumulators;
+  ParticleModules m_Modules;
+
+  unsigned int m_Spawned;
+  unsigned int m_Overwritten;
+  // written on the GL thread
+  std::atomic<float> m_UpdateGpuTime;
+  std::atomic<float> m_RenderGpuTime;
+
+  std::unique_ptr<VertexBuffer> m_StateBuffers[2];
+  std::unique_ptr<VertexArray> m_StateArrays[2];
+  GLBuffer m_SpawnBuffer;
+  std::unique_ptr<Shader> m_UpdateShader;
+  std::unique_ptr<Shader> m_Shader;
+  GpuTimer m_UpdateTimer;
+  GpuTimer m_RenderTimer;
+};
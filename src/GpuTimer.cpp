@@ -0,0 +1,52 @@
+#include "GpuTimer.h"
+#include "Renderer.h"
+
+GpuTimer::GpuTimer()
+  : m_Issued(0), m_Collected(0), m_Active(false)
+{
+  GLCall(glGenQueries(QueryCount * 2, &m_Queries[0][0]));
+}
+
+GpuTimer::~GpuTimer()
+{
+  glDeleteQueries(QueryCount * 2, &m_Queries[0][0]);
+}
+
+void GpuTimer::Begin()
+{
+  m_Active = m_Issued - m_Collected < QueryCount;
+  if (m_Active)
+    GLCall(glQueryCounter(m_Queries[m_Issued % QueryCount][0], GL_TIMESTAMP));
+}
+
+void GpuTimer::End()
+{
+  if (!m_Active)
+    return;
+
+  GLCall(glQueryCounter(m_Queries[m_Issued % QueryCount][1], GL_TIMESTAMP));
+  m_Issued++;
+  m_Active = false;
+}
+
+bool GpuTimer::Poll(float& milliseconds)
+{
+  bool found = false;
+  while (m_Collected < m_Issued)
+  {
+    const unsigned int* queries = m_Queries[m_Collected % QueryCount];
+    // the end timestamp finishes last
+    GLint available = 0;
+    GLCall(glGetQueryObjectiv(queries[1], GL_QUERY_RESULT_AVAILABLE, &available));
+    if (!available)
+      break;
+
+    GLuint64 begin = 0, end = 0;
+    GLCall(glGetQueryObjectui64v(queries[0], GL_QUERY_RESULT, &begin));
+    GLCall(glGetQueryObjectui64v(queries[1], GL_QUERY_RESULT, &end));
+    milliseconds = (end - begin) / 1.0e6f;
+    m_Collected++;
+    found = true;
+  }
+  return found;
+}
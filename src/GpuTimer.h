@@ -0,0 +1,33 @@
+#pragma once
+
+// Measures GPU time between Begin() and End() with a ring of
+// GL_TIMESTAMP query pairs, so reading results never stalls the pipeline:
+// Poll() only collects queries the GPU has already finished, typically one
+// or two frames old. Timestamps, unlike GL_TIME_ELAPSED queries, may nest,
+// so a system can time itself inside a frame that is timed as a whole.
+// GL thread only.
+class GpuTimer
+{
+public:
+  static const unsigned int QueryCount = 4;
+
+  GpuTimer();
+  ~GpuTimer();
+
+  GpuTimer(const GpuTimer&) = delete;
+  GpuTimer& operator=(const GpuTimer&) = delete;
+
+  // When every query is still in flight this frame is not measured.
+  void Begin();
+  void End();
+  // Returns true and the newest finished measurement if any query finished
+  // since the last call.
+  bool Poll(float& milliseconds);
+private:
+  // begin and end timestamp of each measurement
+  unsigned int m_Queries[QueryCount][2];
+  // counters, the ring index is counter % QueryCount
+  unsigned int m_Issued;
+  unsigned int m_Collected;
+  bool m_Active;
+};
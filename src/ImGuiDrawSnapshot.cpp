@@ -0,0 +1,42 @@
+#include "ImGuiDrawSnapshot.h"
+
+#include <cstring>
+
+// Unlike ImVector's assignment, keeps the buffer when it is big enough.
+template<typename T>
+static void CopyInto(ImVector<T>& destination, const ImVector<T>& source)
+{
+  destination.resize(source.Size);
+  if (source.Size > 0)
+    std::memcpy(destination.Data, source.Data, (size_t)source.Size * sizeof(T));
+}
+
+ImGuiDrawSnapshot::ImGuiDrawSnapshot()
+{
+}
+
+ImGuiDrawSnapshot::~ImGuiDrawSnapshot()
+{
+  for (ImDrawList* list : m_Lists)
+    IM_DELETE(list);
+}
+
+void ImGuiDrawSnapshot::Capture(const ImDrawData* drawData)
+{
+  // the lists are kept from frame to frame, so once they have grown to the
+  // size of the UI a capture is only copies
+  while (m_Lists.Size < drawData->CmdListsCount)
+    m_Lists.push_back(IM_NEW(ImDrawList)(drawData->CmdLists[m_Lists.Size]->_Data));
+
+  for (int i = 0; i < drawData->CmdListsCount; i++)
+  {
+    const ImDrawList* source = drawData->CmdLists[i];
+    ImDrawList* list = m_Lists[i];
+    CopyInto(list->CmdBuffer, source->CmdBuffer);
+    CopyInto(list->IdxBuffer, source->IdxBuffer);
+    CopyInto(list->VtxBuffer, source->VtxBuffer);
+    list->Flags = source->Flags;
+  }
+  m_DrawData = *drawData;
+  m_DrawData.CmdLists = m_Lists.Data;
+}
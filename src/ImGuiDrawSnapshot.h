@@ -0,0 +1,22 @@
+#pragma once
+#include "imgui/imgui.h"
+
+// Deep copy of a frame's ImDrawData. ImGui reuses its draw lists on the next
+// NewFrame(), so a render thread that draws the UI one frame late needs its
+// own copy. The copies' buffers are reused by the next Capture(). Create and
+// destroy snapshots on the thread that owns the ImGui context.
+class ImGuiDrawSnapshot
+{
+public:
+  ImGuiDrawSnapshot();
+  ~ImGuiDrawSnapshot();
+
+  ImGuiDrawSnapshot(const ImGuiDrawSnapshot&) = delete;
+  ImGuiDrawSnapshot& operator=(const ImGuiDrawSnapshot&) = delete;
+
+  void Capture(const ImDrawData* drawData);
+  inline ImDrawData* GetDrawData() { return &m_DrawData; }
+private:
+  ImDrawData m_DrawData;
+  ImVector<ImDrawList*> m_Lists;
+};
@@ -0,0 +1,198 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+static unsigned int Crc32(unsigned int crc, const unsigned char* data, size_t size)
+{
+  static const std::array<unsigned int, 256> table = []() {
+    std::array<unsigned int, 256> entries;
+    for (unsigned int i = 0; i < 256; i++)
+    {
+      unsigned int c = i;
+      for (int k = 0; k < 8; k++)
+        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      entries[i] = c;
+    }
+    return entries;
+  }();
+
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void PutBigEndian(std::vector<unsigned char>& out, unsigned int value)
+{
+  out.push_back((unsigned char)(value >> 24));
+  out.push_back((unsigned char)(value >> 16));
+  out.push_back((unsigned char)(value >> 8));
+  out.push_back((unsigned char)value);
+}
+
+static void PutChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data)
+{
+  PutBigEndian(out, (unsigned int)data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  PutBigEndian(out, Crc32(0, &out[start], out.size() - start));
+}
+
+bool ImageWriter::WritePng(const std::string& path, int width, int height, const unsigned char* pixels)
+{
+  // filter byte 0 (none) in front of every RGB row, top row first
+  std::vector<unsigned char> raw;
+  raw.reserve(((size_t)width * 3 + 1) * height);
+  for (int y = height - 1; y >= 0; y--)
+  {
+    raw.push_back(0);
+    const unsigned char* row = pixels + (size_t)width * 4 * y;
+    for (int x = 0; x < width; x++)
+      raw.insert(raw.end(), row + x * 4, row + x * 4 + 3);
+  }
+
+  // zlib stream of stored blocks, at most 65535 bytes each
+  std::vector<unsigned char> zlib;
+  zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+  zlib.push_back(0x78);
+  zlib.push_back(0x01);
+  unsigned int a = 1, b = 0;
+  for (size_t offset = 0; offset < raw.size() || offset == 0;)
+  {
+    size_t size = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+    bool last = offset + size == raw.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back((unsigned char)size);
+    zlib.push_back((unsigned char)(size >> 8));
+    zlib.push_back((unsigned char)~size);
+    zlib.push_back((unsigned char)(~size >> 8));
+    zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+    for (size_t i = offset; i < offset + size; i++)
+    {
+      a = (a + raw[i]) % 65521;
+      b = (b + a) % 65521;
+    }
+    offset += size;
+    if (last)
+      break;
+  }
+  PutBigEndian(zlib, (b << 16) | a);
+
+  std::vector<unsigned char> header;
+  PutBigEndian(header, width);
+  PutBigEndian(header, height);
+  // 8 bit RGB, deflate, adaptive filtering, no interlace
+  header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+  static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+  std::vector<unsigned char> png(signature, signature + 8);
+  PutChunk(png, "IHDR", header);
+  PutChunk(png, "IDAT", zlib);
+  PutChunk(png, "IEND", {});
+
+  std::FILE* file = std::fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool written = std::fwrite(png.data(), 1, png.size(), file) == png.size();
+  std::fclose(file);
+  return written;
+}
+
+Y4MWriter::Y4MWriter()
+  : m_File(nullptr), m_Width(0), m_Height(0)
+{
+}
+
+Y4MWriter::~Y4MWriter()
+{
+  Close();
+}
+
+bool Y4MWriter::Open(const std::string& path, int width, int height, int framesPerSecond)
+{
+  Close();
+  m_File = std::fopen(path.c_str(), "wb");
+  if (!m_File)
+    return false;
+
+  m_Path = path;
+  m_Width = width;
+  m_Height = height;
+  // full range BT.601, chroma sited like JPEG
+  std::fprintf(m_File, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, framesPerSecond);
+  return true;
+}
+
+// Rounds and saturates; full-range chroma of pure red or blue comes out at 256.
+static unsigned char ToByte(float value)
+{
+  return (unsigned char)std::min(std::max(value + 0.5f, 0.0f), 255.0f);
+}
+
+void Y4MWriter::WriteFrame(const unsigned char* pixels)
+{
+  if (!m_File)
+    return;
+
+  int chromaWidth = (m_Width + 1) / 2, chromaHeight = (m_Height + 1) / 2;
+  size_t lumaSize = (size_t)m_Width * m_Height, chromaSize = (size_t)chromaWidth * chromaHeight;
+  m_Frame.resize(lumaSize + chromaSize * 2);
+  unsigned char* luma = m_Frame.data();
+  unsigned char* u = luma + lumaSize;
+  unsigned char* v = u + chromaSize;
+
+  for (int y = 0; y < m_Height; y++)
+  {
+    const unsigned char* row = pixels + (size_t)(m_Height - 1 - y) * m_Width * 4;
+    for (int x = 0; x < m_Width; x++)
+    {
+      const unsigned char* p = row + x * 4;
+      luma[(size_t)y * m_Width + x] = ToByte(0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]);
+    }
+  }
+
+  // chroma from the average of each 2x2 block
+  for (int cy = 0; cy < chromaHeight; cy++)
+  {
+    for (int cx = 0; cx < chromaWidth; cx++)
+    {
+      float r = 0.0f, g = 0.0f, b = 0.0f;
+      int count = 0;
+      for (int dy = 0; dy < 2; dy++)
+      {
+        int y = cy * 2 + dy;
+        if (y >= m_Height)
+          continue;
+        for (int dx = 0; dx < 2; dx++)
+        {
+          int x = cx * 2 + dx;
+          if (x >= m_Width)
+            continue;
+          const unsigned char* p = pixels + ((size_t)(m_Height - 1 - y) * m_Width + x) * 4;
+          r += p[0];
+          g += p[1];
+          b += p[2];
+          count++;
+        }
+      }
+      r /= count;
+      g /= count;
+      b /= count;
+      u[(size_t)cy * chromaWidth + cx] = ToByte(128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b);
+      v[(size_t)cy * chromaWidth + cx] = ToByte(128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b);
+    }
+  }
+
+  std::fputs("FRAME\n", m_File);
+  std::fwrite(m_Frame.data(), 1, m_Frame.size(), m_File);
+}
+
+void Y4MWriter::Close()
+{
+  if (m_File)
+    std::fclose(m_File);
+  m_File = nullptr;
+}
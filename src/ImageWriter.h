@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Minimal image output for captures. Pixels are RGBA8 rows as glReadPixels
+// returns them (bottom row first) and are flipped on the way out.
+class ImageWriter
+{
+public:
+  // PNG with stored (uncompressed) deflate blocks: larger files, but
+  // writing is a copy plus checksums. pixels are RGBA, bottom row first;
+  // alpha is dropped, since a back buffer's alpha is whatever blending left.
+  static bool WritePng(const std::string& path, int width, int height, const unsigned char* pixels);
+};
+
+// Raw YUV 4:2:0 video (YUV4MPEG2), readable by ffmpeg and most players.
+class Y4MWriter
+{
+public:
+  Y4MWriter();
+  ~Y4MWriter();
+
+  Y4MWriter(const Y4MWriter&) = delete;
+  Y4MWriter& operator=(const Y4MWriter&) = delete;
+
+  bool Open(const std::string& path, int width, int height, int framesPerSecond);
+  // Frames must match the size given to Open().
+  void WriteFrame(const unsigned char* pixels);
+  void Close();
+
+  inline bool IsOpen() const { return m_File != nullptr; }
+  inline const std::string& GetPath() const { return m_Path; }
+  inline int GetWidth() const { return m_Width; }
+  inline int GetHeight() const { return m_Height; }
+private:
+  std::FILE* m_File;
+  std::string m_Path;
+  int m_Width, m_Height;
+  std::vector<unsigned char> m_Frame;
+};
@@ -1,21 +1,79 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
+#include "GLCapabilities.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
   : m_Count(count)
 {
   ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glCreateBuffers(1, &m_RendererID));
+    GLCall(glNamedBufferData(m_RendererID, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
+    return;
+  }
+
   GLCall(glGenBuffers(1, &m_RendererID));
   GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
   GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW));
 }
 
+IndexBuffer::IndexBuffer(unsigned int count)
+  : m_Count(count)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glCreateBuffers(1, &m_RendererID));
+    GLCall(glNamedBufferData(m_RendererID, count * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW));
+    return;
+  }
+
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+  GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW));
+}
+
+void IndexBuffer::SetSubData(unsigned int firstIndex, const unsigned int* data, unsigned int count)
+{
+  ASSERT(firstIndex + count <= m_Count);
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glNamedBufferSubData(m_RendererID, firstIndex * sizeof(unsigned int), count * sizeof(unsigned int), data));
+    return;
+  }
+
+  // element array binding is VAO state: don't retarget whatever VAO is bound
+  GLCall(glBindVertexArray(0));
+  GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+  GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, firstIndex * sizeof(unsigned int), count * sizeof(unsigned int), data));
+}
+
 IndexBuffer::~IndexBuffer()
 {
   GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
+IndexBuffer::IndexBuffer(IndexBuffer&& other) noexcept
+  : m_RendererID(other.m_RendererID), m_Count(other.m_Count)
+{
+  other.m_RendererID = 0;
+  other.m_Count = 0;
+}
+
+IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteBuffers(1, &m_RendererID);
+    m_RendererID = other.m_RendererID;
+    m_Count = other.m_Count;
+    other.m_RendererID = 0;
+    other.m_Count = 0;
+  }
+  return *this;
+}
+
 void IndexBuffer::Bind() const
 {
   GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
@@ -6,8 +6,17 @@ private:
 	unsigned int m_Count;
 public:
 	IndexBuffer(const unsigned int* data, unsigned int count);
+	// Dynamic buffer with room for count indices, filled with SetSubData.
+	IndexBuffer(unsigned int count);
 	~IndexBuffer();
 
+	IndexBuffer(const IndexBuffer&) = delete;
+	IndexBuffer& operator=(const IndexBuffer&) = delete;
+	IndexBuffer(IndexBuffer&& other) noexcept;
+	IndexBuffer& operator=(IndexBuffer&& other) noexcept;
+
+	void SetSubData(unsigned int firstIndex, const unsigned int* data, unsigned int count);
+
 	void Bind() const;
 	void Unbind() const;
 
@@ -0,0 +1,361 @@
+#include "JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+struct Job
+{
+  std::function<void()> Function;
+  JobCounter* Counter = nullptr;
+  // pooled jobs go back to their owner's ring, injected ones are deleted
+  std::atomic<bool> InUse{ false };
+  bool Pooled = false;
+};
+
+// Chase-Lev deque (Le et al., "Correct and Efficient Work-Stealing for Weak
+// Memory Models"). Push/Pop are owner-only and work at the bottom, Steal may
+// be called from any thread and takes from the top.
+class WorkStealingQueue
+{
+public:
+  static const long long Capacity = 4096;
+
+  WorkStealingQueue() : m_Top(0), m_Bottom(0)
+  {
+    for (auto& job : m_Jobs)
+      job.store(nullptr, std::memory_order_relaxed);
+  }
+
+  bool Push(Job* job)
+  {
+    long long bottom = m_Bottom.load(std::memory_order_relaxed);
+    long long top = m_Top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity)
+      return false;
+
+    m_Jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  Job* Pop()
+  {
+    long long bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    Job* job = m_Jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+      // last element: race the thieves for it
+      if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        job = nullptr;
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+  }
+
+  Job* Steal()
+  {
+    long long top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    long long bottom = m_Bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+      return nullptr;
+
+    Job* job = m_Jobs[top & (Capacity - 1)].load(std::memory_order_acquire);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return nullptr;
+    return job;
+  }
+private:
+  std::atomic<long long> m_Top;
+  std::atomic<long long> m_Bottom;
+  std::atomic<Job*> m_Jobs[Capacity];
+};
+
+struct Worker
+{
+  WorkStealingQueue Queue;
+  // ring of reusable jobs; only the owning thread allocates from it
+  Job Jobs[WorkStealingQueue::Capacity];
+  unsigned int NextJob = 0;
+  std::thread Thread;
+};
+
+static std::vector<std::unique_ptr<Worker>> s_Workers;
+static std::atomic<bool> s_Running(false);
+static std::atomic<int> s_PendingJobs(0);
+static std::mutex s_WakeMutex;
+static std::condition_variable s_WakeCondition;
+
+static std::mutex s_InjectionMutex;
+static std::deque<Job*> s_InjectionQueue;
+
+static thread_local int t_WorkerIndex = -1;
+static thread_local unsigned int t_StealIndex = 0;
+
+static Job* AllocateJob()
+{
+  if (t_WorkerIndex >= 0)
+  {
+    Worker& worker = *s_Workers[t_WorkerIndex];
+    Job& job = worker.Jobs[worker.NextJob % WorkStealingQueue::Capacity];
+    // the ring only wraps onto a finished job; otherwise fall back to the heap
+    if (!job.InUse.load(std::memory_order_acquire))
+    {
+      worker.NextJob++;
+      job.InUse.store(true, std::memory_order_relaxed);
+      job.Pooled = true;
+      return &job;
+    }
+  }
+  Job* job = new Job();
+  job->InUse.store(true, std::memory_order_relaxed);
+  return job;
+}
+
+static void ReleaseJob(Job* job)
+{
+  job->Function = nullptr;
+  job->Counter = nullptr;
+  if (job->Pooled)
+    job->InUse.store(false, std::memory_order_release);
+  else
+    delete job;
+}
+
+static void Schedule(Job* job)
+{
+  s_PendingJobs.fetch_add(1, std::memory_order_release);
+
+  if (t_WorkerIndex < 0 || !s_Workers[t_WorkerIndex]->Queue.Push(job))
+  {
+    std::lock_guard<std::mutex> lock(s_InjectionMutex);
+    s_InjectionQueue.push_back(job);
+  }
+
+  std::lock_guard<std::mutex> lock(s_WakeMutex);
+  s_WakeCondition.notify_one();
+}
+
+static Job* FindJob()
+{
+  if (t_WorkerIndex >= 0)
+  {
+    if (Job* job = s_Workers[t_WorkerIndex]->Queue.Pop())
+      return job;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(s_InjectionMutex);
+    if (!s_InjectionQueue.empty())
+    {
+      Job* job = s_InjectionQueue.front();
+      s_InjectionQueue.pop_front();
+      return job;
+    }
+  }
+
+  unsigned int workerCount = (unsigned int)s_Workers.size();
+  for (unsigned int i = 0; i < workerCount; i++)
+  {
+    unsigned int victim = (t_StealIndex++) % workerCount;
+    if ((int)victim == t_WorkerIndex)
+      continue;
+    if (Job* job = s_Workers[victim]->Queue.Steal())
+      return job;
+  }
+  return nullptr;
+}
+
+void JobSystem::Execute(Job* job)
+{
+  s_PendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+  job->Function();
+  JobCounter* counter = job->Counter;
+  ReleaseJob(job);
+
+  if (counter)
+    Finish(*counter);
+}
+
+void JobSystem::Finish(JobCounter& counter)
+{
+  // The counter may be destroyed as soon as a waiter sees zero, so the
+  // decrement and the hand-over of the continuations happen under the lock
+  // Wait() takes before returning; the counter is not touched after it.
+  std::vector<Job*> continuations;
+  {
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+    if (counter.m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      continuations.swap(counter.m_Continuations);
+  }
+  // queue whatever was waiting on this counter
+  for (Job* job : continuations)
+    Schedule(job);
+}
+
+void JobSystem::WorkerMain(int index)
+{
+  t_WorkerIndex = index;
+  while (s_Running.load(std::memory_order_acquire))
+  {
+    if (Job* job = FindJob())
+    {
+      Execute(job);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(s_WakeMutex);
+    s_WakeCondition.wait(lock, [] {
+      return s_PendingJobs.load(std::memory_order_acquire) > 0 || !s_Running.load(std::memory_order_acquire);
+    });
+  }
+}
+
+void JobSystem::Initialize(unsigned int workerCount)
+{
+  if (s_Running)
+    return;
+
+  if (workerCount == AutoWorkerCount)
+  {
+    unsigned int cores = std::thread::hardware_concurrency();
+    workerCount = cores > 1 ? cores - 1 : 0;
+  }
+
+  s_Running = true;
+  for (unsigned int i = 0; i <= workerCount; i++)
+    s_Workers.push_back(std::make_unique<Worker>());
+
+  t_WorkerIndex = 0;
+  for (unsigned int i = 1; i <= workerCount; i++)
+    s_Workers[i]->Thread = std::thread(&JobSystem::WorkerMain, (int)i);
+}
+
+void JobSystem::Shutdown()
+{
+  if (!s_Running)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(s_WakeMutex);
+    s_Running = false;
+  }
+  s_WakeCondition.notify_all();
+
+  for (auto& worker : s_Workers)
+  {
+    if (worker->Thread.joinable())
+      worker->Thread.join();
+  }
+  s_Workers.clear();
+  t_WorkerIndex = -1;
+}
+
+bool JobSystem::IsInitialized()
+{
+  return s_Running.load(std::memory_order_acquire);
+}
+
+unsigned int JobSystem::GetThreadCount()
+{
+  return s_Running ? (unsigned int)s_Workers.size() : 1;
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter)
+{
+  if (!s_Running)
+  {
+    job();
+    return;
+  }
+
+  if (counter)
+    counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+  Job* entry = AllocateJob();
+  entry->Function = std::move(job);
+  entry->Counter = counter;
+  Schedule(entry);
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter, JobCounter& dependency)
+{
+  if (!s_Running)
+  {
+    job();
+    return;
+  }
+
+  if (counter)
+    counter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+  Job* entry = AllocateJob();
+  entry->Function = std::move(job);
+  entry->Counter = counter;
+
+  {
+    // checked under the lock so a concurrent Finish() either sees this
+    // continuation or has already reached zero before we look
+    std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+    if (!dependency.IsDone())
+    {
+      dependency.m_Continuations.push_back(entry);
+      return;
+    }
+  }
+  Schedule(entry);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+  while (!counter.IsDone())
+  {
+    if (Job* job = FindJob())
+      Execute(job);
+    else
+      std::this_thread::yield();
+  }
+  // waits for the Finish() that reached zero to let go of the counter
+  std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int chunkSize, const std::function<void(unsigned int, unsigned int)>& body)
+{
+  if (count == 0)
+    return;
+
+  if (chunkSize == 0)
+  {
+    // a few chunks per thread keeps everyone busy when chunks finish unevenly
+    unsigned int chunks = GetThreadCount() * 4;
+    chunkSize = (count + chunks - 1) / chunks;
+  }
+
+  if (!s_Running || chunkSize >= count)
+  {
+    body(0, count);
+    return;
+  }
+
+  JobCounter counter;
+  for (unsigned int begin = 0; begin < count; begin += chunkSize)
+  {
+    unsigned int end = begin + chunkSize < count ? begin + chunkSize : count;
+    Run([&body, begin, end]() { body(begin, end); }, &counter);
+  }
+  Wait(counter);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+struct Job;
+
+// Counts outstanding jobs. Pass one to JobSystem::Run and wait on it, or use
+// it as the dependency of jobs that must not start before it reaches zero.
+class JobCounter
+{
+public:
+  JobCounter() : m_Value(0) {}
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  // Only Wait() guarantees the last job is done with the counter, so wait
+  // before destroying it rather than polling IsDone().
+  inline bool IsDone() const { return m_Value.load(std::memory_order_acquire) == 0; }
+private:
+  friend class JobSystem;
+
+  std::atomic<int> m_Value;
+  std::mutex m_Mutex;
+  std::vector<Job*> m_Continuations;
+};
+
+// Fixed pool of worker threads, each with its own Chase-Lev work-stealing
+// deque. The thread that calls Initialize() becomes worker 0 and executes jobs
+// while it waits; any other thread (e.g. the render thread) can submit and
+// wait too, its jobs go through a shared injection queue.
+class JobSystem
+{
+public:
+  static const unsigned int AutoWorkerCount = ~0u;
+
+  // workerCount background threads, 0 for none (jobs run on the calling
+  // thread); AutoWorkerCount picks hardware_concurrency() - 1.
+  static void Initialize(unsigned int workerCount = AutoWorkerCount);
+  static void Shutdown();
+  static bool IsInitialized();
+
+  // Background workers plus the thread that called Initialize().
+  static unsigned int GetThreadCount();
+
+  static void Run(std::function<void()> job, JobCounter* counter = nullptr);
+  // Queues the job once dependency has reached zero.
+  static void Run(std::function<void()> job, JobCounter* counter, JobCounter& dependency);
+  // Executes other jobs until the counter reaches zero.
+  static void Wait(JobCounter& counter);
+
+  // Splits [0, count) into chunks of chunkSize (0 picks one) and runs
+  // body(begin, end) for each chunk in parallel. Returns when all are done.
+  static void ParallelFor(unsigned int count, unsigned int chunkSize, const std::function<void(unsigned int, unsigned int)>& body);
+private:
+  static void WorkerMain(int index);
+  static void Execute(Job* job);
+  static void Finish(JobCounter& counter);
+};
@@ -0,0 +1,103 @@
+#include "MultiDrawRenderer.h"
+#include "Renderer.h"
+#include "GLCapabilities.h"
+#include "VertexFormat.h"
+
+static VertexBufferLayout DrawDataLayout()
+{
+  VertexBufferLayout layout;
+  layout.Push<float>(4); // transform
+  layout.Push<float>(4); // color
+  return layout;
+}
+
+MultiDrawRenderer::MultiDrawRenderer(const GeometryPool& pool, unsigned int maxDraws)
+  : m_Pool(pool), m_MaxDraws(maxDraws), m_UseIndirect(GLCapabilities::HasMultiDrawIndirect()), m_IndexCount(0),
+  m_DrawDataBuffer(maxDraws * (unsigned int)sizeof(IndirectDrawData)),
+  m_Shader("res/shaders/MultiDraw.shader")
+{
+  m_Commands.reserve(maxDraws);
+  m_DrawData.reserve(maxDraws);
+
+  if (GLCapabilities::HasMultiDrawIndirect())
+    m_IndirectBuffer = std::make_unique<GLBuffer>(GL_DRAW_INDIRECT_BUFFER,
+      maxDraws * (unsigned int)sizeof(DrawElementsIndirectCommand), GL_DYNAMIC_DRAW);
+}
+
+MultiDrawRenderer::~MultiDrawRenderer()
+{
+}
+
+void MultiDrawRenderer::SetUseIndirect(bool useIndirect)
+{
+  m_UseIndirect = useIndirect && GLCapabilities::HasMultiDrawIndirect();
+}
+
+void MultiDrawRenderer::Begin()
+{
+  m_Commands.clear();
+  m_DrawData.clear();
+  m_IndexCount = 0;
+}
+
+void MultiDrawRenderer::Submit(const GeometryHandle& mesh, const IndirectDrawData& data)
+{
+  if (m_Commands.size() == m_MaxDraws || !mesh.IsValid())
+    return;
+
+  DrawElementsIndirectCommand command;
+  command.Count = mesh.IndexCount;
+  command.InstanceCount = 1;
+  command.FirstIndex = mesh.GetFirstIndex();
+  command.BaseVertex = (int)mesh.GetBaseVertex();
+  command.BaseInstance = (unsigned int)m_DrawData.size();
+  m_Commands.push_back(command);
+  m_DrawData.push_back(data);
+  m_IndexCount += mesh.IndexCount;
+}
+
+void MultiDrawRenderer::End(const glm::mat4& viewProj)
+{
+  if (m_Commands.empty())
+    return;
+
+  m_Shader.Bind();
+  m_Shader.SetUniformMat4f("u_ViewProj", viewProj);
+  if (m_UseIndirect)
+    DrawIndirect();
+  else
+    DrawLoop();
+}
+
+void MultiDrawRenderer::DrawIndirect()
+{
+  unsigned int drawCount = (unsigned int)m_Commands.size();
+  m_DrawDataBuffer.SetData(m_DrawData.data(), drawCount * (unsigned int)sizeof(IndirectDrawData));
+
+  m_IndirectBuffer->SetData(m_Commands.data(), drawCount * (unsigned int)sizeof(DrawElementsIndirectCommand));
+  m_IndirectBuffer->Bind();
+
+  const VertexFormat& format = VertexFormat::Get(m_Pool.GetLayout(), DrawDataLayout());
+  format.BindVertexBuffer(m_Pool.GetVertexBuffer(), 0);
+  format.BindVertexBuffer(m_DrawDataBuffer, 1);
+
+  Renderer renderer;
+  renderer.DrawIndirect(format, m_Pool.GetIndexBuffer(), m_Shader, drawCount, m_IndexCount);
+}
+
+void MultiDrawRenderer::DrawLoop()
+{
+  // vertex data only: attributes 1 and 2 stay disabled and read the constants set below
+  const VertexFormat& format = VertexFormat::Get(m_Pool.GetLayout());
+  format.BindVertexBuffer(m_Pool.GetVertexBuffer());
+
+  unsigned int attribute = (unsigned int)m_Pool.GetLayout().GetElements().size();
+  Renderer renderer;
+  for (size_t i = 0; i < m_Commands.size(); i++)
+  {
+    const DrawElementsIndirectCommand& command = m_Commands[i];
+    glVertexAttrib4fv(attribute, &m_DrawData[i].Transform.x);
+    glVertexAttrib4fv(attribute + 1, &m_DrawData[i].Color.x);
+    renderer.Draw(format, m_Pool.GetIndexBuffer(), m_Shader, command.Count, command.FirstIndex, command.BaseVertex);
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "GeometryPool.h"
+#include "GLBuffer.h"
+#include "Shader.h"
+#include "glm/glm.hpp"
+
+// Layout fixed by glMultiDrawElementsIndirect.
+struct DrawElementsIndirectCommand
+{
+  unsigned int Count;
+  unsigned int InstanceCount;
+  unsigned int FirstIndex;
+  int BaseVertex;
+  unsigned int BaseInstance;
+};
+
+// Per-draw data, read in the shader as instanced attributes 1 and 2.
+struct IndirectDrawData
+{
+  // xy offset, z scale, w rotation in radians
+  glm::vec4 Transform;
+  glm::vec4 Color;
+};
+
+// Draws many different meshes of one GeometryPool with a single
+// glMultiDrawElementsIndirect. Each command's BaseInstance points at its
+// IndirectDrawData in a per-instance vertex buffer, so the shader gets
+// per-draw data through plain attributes (no gl_DrawID or SSBO needed).
+//
+// Without multi-draw indirect (GL 3.3) End() falls back to one
+// glDrawElementsBaseVertex per mesh, with the per-draw data set as constant
+// attribute values.
+class MultiDrawRenderer
+{
+public:
+  MultiDrawRenderer(const GeometryPool& pool, unsigned int maxDraws);
+  ~MultiDrawRenderer();
+
+  MultiDrawRenderer(const MultiDrawRenderer&) = delete;
+  MultiDrawRenderer& operator=(const MultiDrawRenderer&) = delete;
+
+  void Begin();
+  void Submit(const GeometryHandle& mesh, const IndirectDrawData& data);
+  void End(const glm::mat4& viewProj);
+
+  void SetUseIndirect(bool useIndirect);
+  inline bool IsUsingIndirect() const { return m_UseIndirect; }
+  inline unsigned int GetDrawCount() const { return (unsigned int)m_Commands.size(); }
+private:
+  void DrawIndirect();
+  void DrawLoop();
+
+  const GeometryPool& m_Pool;
+  unsigned int m_MaxDraws;
+  bool m_UseIndirect;
+
+  std::vector<DrawElementsIndirectCommand> m_Commands;
+  std::vector<IndirectDrawData> m_DrawData;
+  unsigned int m_IndexCount;
+
+  // only when multi-draw indirect is supported
+  std::unique_ptr<GLBuffer> m_IndirectBuffer;
+  VertexBuffer m_DrawDataBuffer;
+  Shader m_Shader;
+};
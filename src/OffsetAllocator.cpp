@@ -0,0 +1,302 @@
+#include "OffsetAllocator.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static uint32_t CountLeadingZeros(uint32_t value)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  return _BitScanReverse(&index, value) ? 31 - index : 32;
+#else
+  return value ? __builtin_clz(value) : 32;
+#endif
+}
+
+static uint32_t CountTrailingZeros(uint32_t value)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  return _BitScanForward(&index, value) ? index : 32;
+#else
+  return value ? __builtin_ctz(value) : 32;
+#endif
+}
+
+// Sizes are binned as small floats: 3 bit mantissa, the rest exponent.
+// Rounding up when allocating and down when freeing guarantees any node in
+// the bin found for a request is big enough.
+namespace SmallFloat
+{
+  static const uint32_t MantissaBits = 3;
+  static const uint32_t MantissaValue = 1 << MantissaBits;
+  static const uint32_t MantissaMask = MantissaValue - 1;
+
+  static uint32_t FromUintRoundUp(uint32_t size)
+  {
+    uint32_t exponent = 0, mantissa = 0;
+    if (size < MantissaValue)
+    {
+      mantissa = size;
+    }
+    else
+    {
+      uint32_t highestSetBit = 31 - CountLeadingZeros(size);
+      uint32_t mantissaStartBit = highestSetBit - MantissaBits;
+      exponent = mantissaStartBit + 1;
+      mantissa = (size >> mantissaStartBit) & MantissaMask;
+      uint32_t lowBitsMask = (1u << mantissaStartBit) - 1;
+      if (size & lowBitsMask)
+        mantissa++;
+    }
+    // + rather than | so a mantissa overflow carries into the exponent
+    return (exponent << MantissaBits) + mantissa;
+  }
+
+  static uint32_t FromUintRoundDown(uint32_t size)
+  {
+    uint32_t exponent = 0, mantissa = 0;
+    if (size < MantissaValue)
+    {
+      mantissa = size;
+    }
+    else
+    {
+      uint32_t highestSetBit = 31 - CountLeadingZeros(size);
+      uint32_t mantissaStartBit = highestSetBit - MantissaBits;
+      exponent = mantissaStartBit + 1;
+      mantissa = (size >> mantissaStartBit) & MantissaMask;
+    }
+    return (exponent << MantissaBits) | mantissa;
+  }
+}
+
+static uint32_t FindLowestSetBitAfter(uint32_t mask, uint32_t startBit)
+{
+  if (startBit >= 32)
+    return OffsetAllocation::NoSpace;
+  uint32_t bitsAfter = mask & ~((1u << startBit) - 1);
+  return bitsAfter ? CountTrailingZeros(bitsAfter) : OffsetAllocation::NoSpace;
+}
+
+OffsetAllocator::OffsetAllocator(uint32_t size, uint32_t maxAllocations)
+  : m_Size(size), m_MaxAllocations(maxAllocations)
+{
+  Reset();
+}
+
+void OffsetAllocator::Reset()
+{
+  m_FreeStorage = 0;
+  m_UsedBinsTop = 0;
+  for (uint32_t i = 0; i < NumTopBins; i++)
+    m_UsedBins[i] = 0;
+  for (uint32_t i = 0; i < NumLeafBins; i++)
+    m_BinIndices[i] = Unused;
+
+  m_Nodes.assign(m_MaxAllocations, Node());
+  m_FreeNodes.resize(m_MaxAllocations);
+  // free nodes are popped from the back, so hand out low indices first
+  for (uint32_t i = 0; i < m_MaxAllocations; i++)
+    m_FreeNodes[i] = m_MaxAllocations - i - 1;
+  m_FreeOffset = m_MaxAllocations - 1;
+
+  // the whole range starts out as one free node
+  InsertNodeIntoBin(m_Size, 0);
+}
+
+OffsetAllocation OffsetAllocator::Allocate(uint32_t size)
+{
+  // keep one node spare for the remainder of a split
+  if (m_FreeOffset == 0 || size == 0)
+    return OffsetAllocation();
+
+  uint32_t minBinIndex = SmallFloat::FromUintRoundUp(size);
+  uint32_t minTopBinIndex = minBinIndex >> 3;
+  uint32_t minLeafBinIndex = minBinIndex & 7;
+
+  uint32_t topBinIndex = minTopBinIndex;
+  uint32_t leafBinIndex = OffsetAllocation::NoSpace;
+  if (m_UsedBinsTop & (1u << topBinIndex))
+    leafBinIndex = FindLowestSetBitAfter(m_UsedBins[topBinIndex], minLeafBinIndex);
+
+  // nothing big enough in the same top bin: take the smallest bin of the next used one
+  if (leafBinIndex == OffsetAllocation::NoSpace)
+  {
+    topBinIndex = FindLowestSetBitAfter(m_UsedBinsTop, minTopBinIndex + 1);
+    if (topBinIndex == OffsetAllocation::NoSpace)
+      return OffsetAllocation();
+    leafBinIndex = CountTrailingZeros(m_UsedBins[topBinIndex]);
+  }
+
+  uint32_t binIndex = (topBinIndex << 3) | leafBinIndex;
+
+  uint32_t nodeIndex = m_BinIndices[binIndex];
+  Node& node = m_Nodes[nodeIndex];
+  uint32_t nodeTotalSize = node.DataSize;
+  node.DataSize = size;
+  node.Used = true;
+  m_BinIndices[binIndex] = node.BinListNext;
+  if (node.BinListNext != Unused)
+    m_Nodes[node.BinListNext].BinListPrev = Unused;
+  m_FreeStorage -= nodeTotalSize;
+
+  if (m_BinIndices[binIndex] == Unused)
+  {
+    m_UsedBins[topBinIndex] &= ~(1 << leafBinIndex);
+    if (m_UsedBins[topBinIndex] == 0)
+      m_UsedBinsTop &= ~(1u << topBinIndex);
+  }
+
+  // put the rest back as a free neighbour
+  uint32_t remainderSize = nodeTotalSize - size;
+  if (remainderSize > 0)
+  {
+    uint32_t newNodeIndex = InsertNodeIntoBin(remainderSize, node.DataOffset + size);
+    Node& current = m_Nodes[nodeIndex];
+    if (current.NeighborNext != Unused)
+      m_Nodes[current.NeighborNext].NeighborPrev = newNodeIndex;
+    m_Nodes[newNodeIndex].NeighborPrev = nodeIndex;
+    m_Nodes[newNodeIndex].NeighborNext = current.NeighborNext;
+    current.NeighborNext = newNodeIndex;
+  }
+
+  OffsetAllocation allocation;
+  allocation.Offset = m_Nodes[nodeIndex].DataOffset;
+  allocation.Metadata = nodeIndex;
+  return allocation;
+}
+
+void OffsetAllocator::Free(OffsetAllocation allocation)
+{
+  if (!allocation.IsValid())
+    return;
+
+  uint32_t nodeIndex = allocation.Metadata;
+  Node& node = m_Nodes[nodeIndex];
+
+  uint32_t offset = node.DataOffset;
+  uint32_t size = node.DataSize;
+
+  if (node.NeighborPrev != Unused && !m_Nodes[node.NeighborPrev].Used)
+  {
+    Node& prev = m_Nodes[node.NeighborPrev];
+    offset = prev.DataOffset;
+    size += prev.DataSize;
+
+    uint32_t prevIndex = node.NeighborPrev;
+    node.NeighborPrev = prev.NeighborPrev;
+    RemoveNodeFromBin(prevIndex);
+  }
+
+  if (node.NeighborNext != Unused && !m_Nodes[node.NeighborNext].Used)
+  {
+    Node& next = m_Nodes[node.NeighborNext];
+    size += next.DataSize;
+
+    uint32_t nextIndex = node.NeighborNext;
+    node.NeighborNext = next.NeighborNext;
+    RemoveNodeFromBin(nextIndex);
+  }
+
+  uint32_t neighborNext = node.NeighborNext;
+  uint32_t neighborPrev = node.NeighborPrev;
+
+  node = Node();
+  m_FreeNodes[++m_FreeOffset] = nodeIndex;
+
+  uint32_t combinedIndex = InsertNodeIntoBin(size, offset);
+  if (neighborNext != Unused)
+  {
+    m_Nodes[combinedIndex].NeighborNext = neighborNext;
+    m_Nodes[neighborNext].NeighborPrev = combinedIndex;
+  }
+  if (neighborPrev != Unused)
+  {
+    m_Nodes[combinedIndex].NeighborPrev = neighborPrev;
+    m_Nodes[neighborPrev].NeighborNext = combinedIndex;
+  }
+}
+
+uint32_t OffsetAllocator::InsertNodeIntoBin(uint32_t size, uint32_t dataOffset)
+{
+  uint32_t binIndex = SmallFloat::FromUintRoundDown(size);
+  uint32_t topBinIndex = binIndex >> 3;
+  uint32_t leafBinIndex = binIndex & 7;
+
+  if (m_BinIndices[binIndex] == Unused)
+  {
+    m_UsedBins[topBinIndex] |= 1 << leafBinIndex;
+    m_UsedBinsTop |= 1u << topBinIndex;
+  }
+
+  uint32_t topNodeIndex = m_BinIndices[binIndex];
+  uint32_t nodeIndex = m_FreeNodes[m_FreeOffset--];
+
+  Node& node = m_Nodes[nodeIndex];
+  node = Node();
+  node.DataOffset = dataOffset;
+  node.DataSize = size;
+  node.BinListNext = topNodeIndex;
+  if (topNodeIndex != Unused)
+    m_Nodes[topNodeIndex].BinListPrev = nodeIndex;
+  m_BinIndices[binIndex] = nodeIndex;
+
+  m_FreeStorage += size;
+  return nodeIndex;
+}
+
+void OffsetAllocator::RemoveNodeFromBin(uint32_t nodeIndex)
+{
+  Node& node = m_Nodes[nodeIndex];
+
+  if (node.BinListPrev != Unused)
+  {
+    // in the middle of a list: just unlink
+    m_Nodes[node.BinListPrev].BinListNext = node.BinListNext;
+    if (node.BinListNext != Unused)
+      m_Nodes[node.BinListNext].BinListPrev = node.BinListPrev;
+  }
+  else
+  {
+    // head of its bin's list
+    uint32_t binIndex = SmallFloat::FromUintRoundDown(node.DataSize);
+    uint32_t topBinIndex = binIndex >> 3;
+    uint32_t leafBinIndex = binIndex & 7;
+
+    m_BinIndices[binIndex] = node.BinListNext;
+    if (node.BinListNext != Unused)
+      m_Nodes[node.BinListNext].BinListPrev = Unused;
+
+    if (m_BinIndices[binIndex] == Unused)
+    {
+      m_UsedBins[topBinIndex] &= ~(1 << leafBinIndex);
+      if (m_UsedBins[topBinIndex] == 0)
+        m_UsedBinsTop &= ~(1u << topBinIndex);
+    }
+  }
+
+  m_FreeNodes[++m_FreeOffset] = nodeIndex;
+  m_FreeStorage -= node.DataSize;
+}
+
+uint32_t OffsetAllocator::GetAllocationSize(OffsetAllocation allocation) const
+{
+  return allocation.IsValid() ? m_Nodes[allocation.Metadata].DataSize : 0;
+}
+
+OffsetAllocatorReport OffsetAllocator::GetReport() const
+{
+  OffsetAllocatorReport report = { m_FreeStorage, 0, 0 };
+  for (uint32_t binIndex = 0; binIndex < NumLeafBins; binIndex++)
+  {
+    for (uint32_t nodeIndex = m_BinIndices[binIndex]; nodeIndex != Unused; nodeIndex = m_Nodes[nodeIndex].BinListNext)
+    {
+      report.FreeRegions++;
+      if (m_Nodes[nodeIndex].DataSize > report.LargestFree)
+        report.LargestFree = m_Nodes[nodeIndex].DataSize;
+    }
+  }
+  return report;
+}
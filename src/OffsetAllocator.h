@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct OffsetAllocation
+{
+  static const uint32_t NoSpace = 0xffffffff;
+
+  uint32_t Offset = NoSpace;
+  // node index inside the allocator, needed to free
+  uint32_t Metadata = NoSpace;
+
+  inline bool IsValid() const { return Offset != NoSpace; }
+};
+
+struct OffsetAllocatorReport
+{
+  uint32_t TotalFree;
+  uint32_t LargestFree;
+  uint32_t FreeRegions;
+
+  // 0 when all free space is one block, towards 1 as it splinters
+  float GetFragmentation() const { return TotalFree ? 1.0f - (float)LargestFree / TotalFree : 0.0f; }
+};
+
+// Hands out ranges of an abstract [0, size) space in O(1), two-level
+// segregated fit (TLSF) style. Free ranges sit in 256 size bins, spaced like
+// a tiny float (5 bit exponent, 3 bit mantissa), with a bitmask per level so
+// finding a fitting bin is two bit scans. Freed ranges merge with free
+// neighbours straight away.
+//
+// Units are up to the caller: the geometry pool uses vertices and indices.
+class OffsetAllocator
+{
+public:
+  OffsetAllocator(uint32_t size, uint32_t maxAllocations = 64 * 1024);
+
+  OffsetAllocation Allocate(uint32_t size);
+  void Free(OffsetAllocation allocation);
+  void Reset();
+
+  uint32_t GetAllocationSize(OffsetAllocation allocation) const;
+  inline uint32_t GetSize() const { return m_Size; }
+  inline uint32_t GetFree() const { return m_FreeStorage; }
+  OffsetAllocatorReport GetReport() const;
+private:
+  static const uint32_t NumTopBins = 32;
+  static const uint32_t BinsPerLeaf = 8;
+  static const uint32_t NumLeafBins = NumTopBins * BinsPerLeaf;
+  static const uint32_t Unused = 0xffffffff;
+
+  struct Node
+  {
+    uint32_t DataOffset = 0;
+    uint32_t DataSize = 0;
+    uint32_t BinListPrev = Unused;
+    uint32_t BinListNext = Unused;
+    uint32_t NeighborPrev = Unused;
+    uint32_t NeighborNext = Unused;
+    bool Used = false;
+  };
+
+  uint32_t InsertNodeIntoBin(uint32_t size, uint32_t dataOffset);
+  void RemoveNodeFromBin(uint32_t nodeIndex);
+
+  uint32_t m_Size;
+  uint32_t m_MaxAllocations;
+  uint32_t m_FreeStorage;
+
+  uint32_t m_UsedBinsTop;
+  uint8_t m_UsedBins[NumTopBins];
+  uint32_t m_BinIndices[NumLeafBins];
+
+  std::vector<Node> m_Nodes;
+  std::vector<uint32_t> m_FreeNodes;
+  uint32_t m_FreeOffset;
+};
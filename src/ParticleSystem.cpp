@@ -0,0 +1,306 @@
+#include "ParticleSystem.h"
+#include "JobSystem.h"
+#include "FrameAllocator.h"
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #define PARTICLES_SSE2 1
+  #include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+  #define PARTICLES_NEON 1
+  #include <arm_neon.h>
+#endif
+
+static float GetMilliseconds(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+  return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+ParticleSystem::ParticleSystem(unsigned int maxParticles)
+  : m_MaxParticles(maxParticles), m_Count(0), m_RandomState(0x9e3779b9u), m_Simd(true), m_Parallel(true)
+{
+  for (std::vector<float>* array : { &m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_Age, &m_Lifetime })
+    array->resize(maxParticles);
+
+  m_VAO = std::make_unique<VertexArray>();
+  m_InstanceBuffer = std::make_unique<VertexBuffer>(maxParticles * (unsigned int)sizeof(ParticleInstance));
+  m_VAO->AddBuffer<ParticleInstance>(*m_InstanceBuffer, 1);
+  std::vector<unsigned int> indices = BatchRenderer::GenerateQuadIndices(1);
+  m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+  m_Shader = std::make_unique<Shader>("res/shaders/Particle.shader");
+}
+
+ParticleSystem::~ParticleSystem()
+{
+}
+
+unsigned int ParticleSystem::AddEmitter(const ParticleEmitter& emitter)
+{
+  m_Emitters.push_back(emitter);
+  m_EmitAccumulators.push_back(0.0f);
+  return (unsigned int)m_Emitters.size() - 1;
+}
+
+void ParticleSystem::Clear()
+{
+  m_Count = 0;
+  std::fill(m_EmitAccumulators.begin(), m_EmitAccumulators.end(), 0.0f);
+}
+
+void ParticleSystem::ForEachChunk(unsigned int count, const std::function<void(unsigned int, unsigned int)>& body) const
+{
+  // body always gets exactly one chunk starting at a multiple of ChunkSize,
+  // the compaction relies on it; ParallelFor may hand out any aligned range
+  // (all of it when the job system isn't running), so split it here
+  auto chunks = [&body](unsigned int begin, unsigned int end) {
+    for (unsigned int chunk = begin; chunk < end; chunk += ChunkSize)
+      body(chunk, std::min(chunk + ChunkSize, end));
+  };
+  if (m_Parallel)
+    JobSystem::ParallelFor(count, ChunkSize, chunks);
+  else
+    chunks(0, count);
+}
+
+void ParticleSystem::Update(float deltaTime)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  float damping = std::exp(-m_Modules.Drag * deltaTime);
+  unsigned int count = m_Count;
+  unsigned int chunkCount = (count + ChunkSize - 1) / ChunkSize;
+  m_ChunkLive.resize(chunkCount);
+  ForEachChunk(count, [this, deltaTime, damping](unsigned int begin, unsigned int end) {
+    Simulate(begin, end, deltaTime, damping);
+    m_ChunkLive[begin / ChunkSize] = CompactChunk(begin, end);
+  });
+  auto simulated = std::chrono::steady_clock::now();
+
+  CloseGaps(chunkCount);
+  m_Stats.Died = count - m_Count;
+  auto compacted = std::chrono::steady_clock::now();
+
+  Emit(deltaTime);
+  auto emitted = std::chrono::steady_clock::now();
+
+  m_Stats.Live = m_Count;
+  m_Stats.SimulateTime = GetMilliseconds(start, simulated);
+  m_Stats.CompactTime = GetMilliseconds(simulated, compacted);
+  m_Stats.EmitTime = GetMilliseconds(compacted, emitted);
+}
+
+void ParticleSystem::Simulate(unsigned int begin, unsigned int end, float deltaTime, float damping)
+{
+  float* positionX = m_PositionX.data();
+  float* positionY = m_PositionY.data();
+  float* velocityX = m_VelocityX.data();
+  float* velocityY = m_VelocityY.data();
+  float* age = m_Age.data();
+  glm::vec2 gravity = m_Modules.Gravity * deltaTime;
+
+  // semi-implicit Euler: velocity first, then position with the new velocity
+  unsigned int i = begin;
+#if defined(PARTICLES_SSE2)
+  if (m_Simd)
+  {
+    __m128 dt = _mm_set1_ps(deltaTime), drag = _mm_set1_ps(damping);
+    __m128 gravityX = _mm_set1_ps(gravity.x), gravityY = _mm_set1_ps(gravity.y);
+    for (; i + 4 <= end; i += 4)
+    {
+      __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocityX + i), drag), gravityX);
+      __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(velocityY + i), drag), gravityY);
+      _mm_storeu_ps(velocityX + i, vx);
+      _mm_storeu_ps(velocityY + i, vy);
+      _mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, dt)));
+      _mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, dt)));
+      _mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), dt));
+    }
+  }
+#elif defined(PARTICLES_NEON)
+  if (m_Simd)
+  {
+    float32x4_t gravityX = vdupq_n_f32(gravity.x), gravityY = vdupq_n_f32(gravity.y);
+    for (; i + 4 <= end; i += 4)
+    {
+      float32x4_t vx = vmlaq_n_f32(gravityX, vld1q_f32(velocityX + i), damping);
+      float32x4_t vy = vmlaq_n_f32(gravityY, vld1q_f32(velocityY + i), damping);
+      vst1q_f32(velocityX + i, vx);
+      vst1q_f32(velocityY + i, vy);
+      vst1q_f32(positionX + i, vmlaq_n_f32(vld1q_f32(positionX + i), vx, deltaTime));
+      vst1q_f32(positionY + i, vmlaq_n_f32(vld1q_f32(positionY + i), vy, deltaTime));
+      vst1q_f32(age + i, vaddq_f32(vld1q_f32(age + i), vdupq_n_f32(deltaTime)));
+    }
+  }
+#endif
+  for (; i < end; i++)
+  {
+    velocityX[i] = velocityX[i] * damping + gravity.x;
+    velocityY[i] = velocityY[i] * damping + gravity.y;
+    positionX[i] += velocityX[i] * deltaTime;
+    positionY[i] += velocityY[i] * deltaTime;
+    age[i] += deltaTime;
+  }
+}
+
+unsigned int ParticleSystem::CompactChunk(unsigned int begin, unsigned int end)
+{
+  // swap-remove inside the chunk: live particles end up in [begin, end)
+  for (unsigned int i = begin; i < end;)
+  {
+    if (m_Age[i] < m_Lifetime[i])
+    {
+      i++;
+      continue;
+    }
+    end--;
+    m_PositionX[i] = m_PositionX[end];
+    m_PositionY[i] = m_PositionY[end];
+    m_VelocityX[i] = m_VelocityX[end];
+    m_VelocityY[i] = m_VelocityY[end];
+    m_Age[i] = m_Age[end];
+    m_Lifetime[i] = m_Lifetime[end];
+  }
+  return end - begin;
+}
+
+void ParticleSystem::CloseGaps(unsigned int chunkCount)
+{
+  unsigned int live = 0;
+  for (unsigned int chunk = 0; chunk < chunkCount; chunk++)
+    live += m_ChunkLive[chunk];
+
+  // the dead tails of chunks below live are filled with live particles from
+  // chunks above it; both add up to the same count
+  struct Range { unsigned int Begin, End; };
+  std::vector<Range> holes, sources;
+  for (unsigned int chunk = 0; chunk < chunkCount; chunk++)
+  {
+    unsigned int begin = chunk * ChunkSize;
+    unsigned int end = std::min(begin + ChunkSize, m_Count);
+    unsigned int liveEnd = begin + m_ChunkLive[chunk];
+    if (liveEnd < std::min(end, live))
+      holes.push_back({ liveEnd, std::min(end, live) });
+    if (liveEnd > std::max(begin, live))
+      sources.push_back({ std::max(begin, live), liveEnd });
+  }
+
+  size_t source = 0;
+  for (Range& hole : holes)
+  {
+    while (hole.Begin < hole.End)
+    {
+      Range& from = sources[source];
+      unsigned int count = std::min(hole.End - hole.Begin, from.End - from.Begin);
+      unsigned int src = from.End - count;
+      for (std::vector<float>* array : { &m_PositionX, &m_PositionY, &m_VelocityX, &m_VelocityY, &m_Age, &m_Lifetime })
+        std::memcpy(array->data() + hole.Begin, array->data() + src, count * sizeof(float));
+      hole.Begin += count;
+      from.End -= count;
+      if (from.Begin == from.End)
+        source++;
+    }
+  }
+  m_Count = live;
+}
+
+float ParticleSystem::Random()
+{
+  // xorshift32, top 24 bits to [0, 1)
+  m_RandomState ^= m_RandomState << 13;
+  m_RandomState ^= m_RandomState >> 17;
+  m_RandomState ^= m_RandomState << 5;
+  return (m_RandomState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::Emit(float deltaTime)
+{
+  m_Stats.Spawned = 0;
+  for (size_t e = 0; e < m_Emitters.size(); e++)
+  {
+    const ParticleEmitter& emitter = m_Emitters[e];
+    if (!emitter.Enabled)
+    {
+      m_EmitAccumulators[e] = 0.0f;
+      continue;
+    }
+
+    m_EmitAccumulators[e] += emitter.Rate * deltaTime;
+    unsigned int spawn = (unsigned int)m_EmitAccumulators[e];
+    m_EmitAccumulators[e] -= (float)spawn;
+    spawn = std::min(spawn, m_MaxParticles - m_Count);
+
+    for (unsigned int n = 0; n < spawn; n++)
+    {
+      unsigned int i = m_Count++;
+      float angle = emitter.Direction + emitter.Spread * (Random() * 2.0f - 1.0f);
+      float speed = emitter.SpeedMin + (emitter.SpeedMax - emitter.SpeedMin) * Random();
+      m_PositionX[i] = emitter.Position.x + emitter.HalfExtent.x * (Random() * 2.0f - 1.0f);
+      m_PositionY[i] = emitter.Position.y + emitter.HalfExtent.y * (Random() * 2.0f - 1.0f);
+      m_VelocityX[i] = std::cos(angle) * speed;
+      m_VelocityY[i] = std::sin(angle) * speed;
+      m_Age[i] = 0.0f;
+      m_Lifetime[i] = emitter.LifetimeMin + (emitter.LifetimeMax - emitter.LifetimeMin) * Random();
+    }
+    m_Stats.Spawned += spawn;
+  }
+}
+
+void ParticleSystem::WriteInstances(ParticleInstance* instances, unsigned int begin, unsigned int end) const
+{
+  const ParticleModules& modules = m_Modules;
+  glm::vec4 startColor = modules.StartColor * 255.0f;
+  glm::vec4 colorDelta = (modules.EndColor - modules.StartColor) * 255.0f;
+  for (unsigned int i = begin; i < end; i++)
+  {
+    float t = std::min(m_Age[i] / m_Lifetime[i], 1.0f);
+    ParticleInstance& instance = instances[i - begin];
+    instance.Position = { m_PositionX[i], m_PositionY[i] };
+    instance.Size = modules.StartSize + (modules.EndSize - modules.StartSize) * t;
+    instance.Color = glm::u8vec4(glm::clamp(startColor + colorDelta * t + 0.5f, 0.0f, 255.0f));
+  }
+}
+
+void ParticleSystem::Render(const glm::mat4& viewProj)
+{
+  unsigned int count = m_Count;
+  if (count == 0)
+    return;
+
+  auto start = std::chrono::steady_clock::now();
+  if (Renderer::IsRenderThreadRunning())
+  {
+    // the next Update() runs while the render thread uploads this frame
+    ParticleInstance* instances = BufferedFrameAllocator::Get().GetCurrent().AllocateArray<ParticleInstance>(count);
+    ForEachChunk(count, [this, instances](unsigned int begin, unsigned int end) {
+      WriteInstances(instances + begin, begin, end);
+    });
+    Renderer::Submit([this, instances, count, viewProj]() { DrawInstances(instances, count, viewProj); });
+  }
+  else
+  {
+    ParticleInstance* instances = (ParticleInstance*)m_InstanceBuffer->Map(count * sizeof(ParticleInstance));
+    ForEachChunk(count, [this, instances](unsigned int begin, unsigned int end) {
+      WriteInstances(instances + begin, begin, end);
+    });
+    m_InstanceBuffer->Unmap();
+    DrawInstances(nullptr, count, viewProj);
+  }
+  m_Stats.WriteTime = GetMilliseconds(start, std::chrono::steady_clock::now());
+}
+
+void ParticleSystem::DrawInstances(const ParticleInstance* instances, unsigned int count, const glm::mat4& viewProj)
+{
+  if (instances)
+    m_InstanceBuffer->SetData(instances, count * sizeof(ParticleInstance));
+
+  m_Shader->Bind();
+  m_Shader->SetUniformMat4f("u_ViewProj", viewProj);
+
+  Renderer renderer;
+  renderer.DrawInstanced(*m_VAO, *m_IndexBuffer, *m_Shader, count);
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "glm/glm.hpp"
+
+struct ParticleInstance
+{
+  glm::vec2 Position;
+  float Size;
+  glm::u8vec4 Color;
+};
+VERTEX_LAYOUT(ParticleInstance, Position, Size, Color);
+
+struct ParticleEmitter
+{
+  glm::vec2 Position = glm::vec2(0.0f);
+  // spawn area around Position
+  glm::vec2 HalfExtent = glm::vec2(0.0f);
+  // particles per second
+  float Rate = 1000.0f;
+  // velocity module: launch direction and half the cone angle, in radians
+  float Direction = 1.5707963f;
+  float Spread = 0.3f;
+  float SpeedMin = 100.0f, SpeedMax = 200.0f;
+  float LifetimeMin = 1.0f, LifetimeMax = 2.0f;
+  bool Enabled = true;
+};
+
+// Per system; applied to every particle each update.
+struct ParticleModules
+{
+  glm::vec2 Gravity = glm::vec2(0.0f, -200.0f);
+  // velocity decays as exp(-Drag * t)
+  float Drag = 0.5f;
+  // over lifetime, linear from start to end
+  glm::vec4 StartColor = glm::vec4(1.0f, 0.8f, 0.3f, 1.0f);
+  glm::vec4 EndColor = glm::vec4(0.8f, 0.1f, 0.0f, 0.0f);
+  float StartSize = 4.0f, EndSize = 1.0f;
+};
+
+struct ParticleStats
+{
+  unsigned int Live = 0;
+  unsigned int Spawned = 0;
+  unsigned int Died = 0;
+  // milliseconds, main thread
+  float SimulateTime = 0.0f;
+  float CompactTime = 0.0f;
+  float EmitTime = 0.0f;
+  float WriteTime = 0.0f;
+};
+
+// CPU particles stored as structure of arrays. Update() integrates them with
+// SSE2/NEON in parallel chunks on the job system; each chunk swap-removes its
+// dead particles, then the holes left between chunks are filled from the end
+// of the array, so compaction moves one particle per death rather than the
+// whole array. Render() streams one instance per particle into an orphaned
+// buffer and draws the whole system with one instanced draw.
+class ParticleSystem
+{
+public:
+  static const unsigned int ChunkSize = 16384;
+
+  ParticleSystem(unsigned int maxParticles);
+  ~ParticleSystem();
+
+  ParticleSystem(const ParticleSystem&) = delete;
+  ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+  unsigned int AddEmitter(const ParticleEmitter& emitter);
+  inline ParticleEmitter& GetEmitter(unsigned int index) { return m_Emitters[index]; }
+  inline unsigned int GetEmitterCount() const { return (unsigned int)m_Emitters.size(); }
+  inline ParticleModules& GetModules() { return m_Modules; }
+
+  void Update(float deltaTime);
+  void Render(const glm::mat4& viewProj);
+  void Clear();
+
+  // For comparisons: scalar update and/or everything on the calling thread.
+  inline void SetSimd(bool simd) { m_Simd = simd; }
+  inline bool IsSimd() const { return m_Simd; }
+  inline void SetParallel(bool parallel) { m_Parallel = parallel; }
+  inline bool IsParallel() const { return m_Parallel; }
+
+  inline unsigned int GetLiveCount() const { return m_Count; }
+  inline unsigned int GetMaxParticles() const { return m_MaxParticles; }
+  inline const ParticleStats& GetStats() const { return m_Stats; }
+private:
+  void Simulate(unsigned int begin, unsigned int end, float deltaTime, float damping);
+  unsigned int CompactChunk(unsigned int begin, unsigned int end);
+  void CloseGaps(unsigned int chunkCount);
+  void Emit(float deltaTime);
+  void WriteInstances(ParticleInstance* instances, unsigned int begin, unsigned int end) const;
+  // null instances: already written to the mapped instance buffer
+  void DrawInstances(const ParticleInstance* instances, unsigned int count, const glm::mat4& viewProj);
+  void ForEachChunk(unsigned int count, const std::function<void(unsigned int, unsigned int)>& body) const;
+  float Random();
+
+  unsigned int m_MaxParticles;
+  unsigned int m_Count;
+  std::vector<float> m_PositionX, m_PositionY, m_VelocityX, m_VelocityY, m_Age, m_Lifetime;
+  // live particles per chunk after CompactChunk
+  std::vector<unsigned int> m_ChunkLive;
+
+  std::vector<ParticleEmitter> m_Emitters;
+  std::vector<float> m_EmitAccumulators;
+  ParticleModules m_Modules;
+  unsigned int m_RandomState;
+
+  bool m_Simd;
+  bool m_Parallel;
+  ParticleStats m_Stats;
+
+  std::unique_ptr<VertexArray> m_VAO;
+  std::unique_ptr<VertexBuffer> m_InstanceBuffer;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  std::unique_ptr<Shader> m_Shader;
+};
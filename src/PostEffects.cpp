@@ -0,0 +1,199 @@
+#include "PostEffects.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+
+#include <vector>
+
+static const char* s_TonemapSource = R"(
+vec4 $Apply(vec4 color, vec2 uv)
+{
+  vec3 x = color.rgb * $Exposure;
+  x = clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+  return vec4(x, color.a);
+}
+)";
+
+TonemapEffect::TonemapEffect()
+  : PostEffect("Tonemap", s_TonemapSource, { { "Exposure", 1.0f, 0.1f, 8.0f } })
+{
+}
+
+static const char* s_ColorGradeSource = R"(
+uniform sampler2D $Lut;
+vec4 $Apply(vec4 color, vec2 uv)
+{
+  // blue picks two neighbouring slices, red and green are filtered in hardware
+  vec3 c = clamp(color.rgb, 0.0, 1.0) * 15.0;
+  float slice = min(floor(c.b), 14.0);
+  vec2 p = vec2((c.r + 0.5) / 256.0, (c.g + 0.5) / 16.0);
+  vec3 a = texture($Lut, p + vec2(slice / 16.0, 0.0)).rgb;
+  vec3 b = texture($Lut, p + vec2((slice + 1.0) / 16.0, 0.0)).rgb;
+  return vec4(mix(color.rgb, mix(a, b, c.b - slice), $Intensity), color.a);
+}
+)";
+
+static std::vector<unsigned int> GenerateGradeLut()
+{
+  const int size = ColorGradeEffect::LutSize;
+  std::vector<unsigned int> pixels(size * size * size);
+  for (int b = 0; b < size; b++)
+  {
+    for (int g = 0; g < size; g++)
+    {
+      for (int r = 0; r < size; r++)
+      {
+        glm::vec3 c = glm::vec3(r, g, b) / (float)(size - 1);
+        // gentle S curve, then shadows towards teal and highlights towards orange
+        c = glm::mix(c, c * c * (3.0f - 2.0f * c), 0.5f);
+        float luma = glm::dot(c, glm::vec3(0.2126f, 0.7152f, 0.0722f));
+        c += (1.0f - luma) * glm::vec3(-0.03f, 0.02f, 0.06f) + luma * glm::vec3(0.06f, 0.02f, -0.05f);
+        c = glm::clamp(glm::mix(glm::vec3(luma), c, 1.1f), 0.0f, 1.0f);
+
+        unsigned int pixel = 0xff000000 | ((unsigned int)(c.b * 255.0f + 0.5f) << 16) |
+          ((unsigned int)(c.g * 255.0f + 0.5f) << 8) | (unsigned int)(c.r * 255.0f + 0.5f);
+        pixels[g * size * size + b * size + r] = pixel;
+      }
+    }
+  }
+  return pixels;
+}
+
+ColorGradeEffect::ColorGradeEffect()
+  : PostEffect("Color Grade", s_ColorGradeSource, { { "Intensity", 1.0f, 0.0f, 1.0f } }),
+  m_Lut(LutSize * LutSize, LutSize, GenerateGradeLut().data())
+{
+}
+
+void ColorGradeEffect::BindTextures(Shader& shader, const std::string& prefix, unsigned int& textureSlot) const
+{
+  m_Lut.Bind(textureSlot);
+  shader.SetUniform1i(prefix + "Lut", textureSlot);
+  textureSlot++;
+}
+
+static const char* s_VignetteSource = R"(
+vec4 $Apply(vec4 color, vec2 uv)
+{
+  float falloff = smoothstep($Radius - $Softness, $Radius, length(uv - 0.5) * 1.41421);
+  return vec4(color.rgb * (1.0 - falloff * $Intensity), color.a);
+}
+)";
+
+VignetteEffect::VignetteEffect()
+  : PostEffect("Vignette", s_VignetteSource, {
+    { "Intensity", 0.5f, 0.0f, 1.0f }, { "Radius", 1.0f, 0.2f, 1.5f }, { "Softness", 0.6f, 0.01f, 1.0f } })
+{
+}
+
+static const char* s_BloomSource = R"(
+uniform sampler2D $Texture;
+vec4 $Apply(vec4 color, vec2 uv)
+{
+  return vec4(color.rgb + texture($Texture, uv).rgb * $Intensity, color.a);
+}
+)";
+
+static const char* s_BloomDownsampleSource = R"(#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+uniform sampler2D u_Source;
+uniform vec2 u_TexelSize;
+uniform float u_Threshold;
+uniform int u_Prefilter;
+
+void main()
+{
+  // four bilinear taps average a 4x4 texel footprint
+  vec4 o = u_TexelSize.xyxy * vec4(-1.0, -1.0, 1.0, 1.0);
+  vec3 c = texture(u_Source, v_TexCoord + o.xy).rgb + texture(u_Source, v_TexCoord + o.zy).rgb +
+    texture(u_Source, v_TexCoord + o.xw).rgb + texture(u_Source, v_TexCoord + o.zw).rgb;
+  c *= 0.25;
+  if (u_Prefilter == 1)
+  {
+    float brightness = max(c.r, max(c.g, c.b));
+    c *= max(brightness - u_Threshold, 0.0) / max(brightness, 0.0001);
+  }
+  color = vec4(c, 1.0);
+}
+)";
+
+static const char* s_BloomUpsampleSource = R"(#version 330 core
+
+layout(location = 0) out vec4 color;
+in vec2 v_TexCoord;
+uniform sampler2D u_Source;
+uniform vec2 u_TexelSize;
+
+void main()
+{
+  vec4 o = u_TexelSize.xyxy * vec4(-0.5, -0.5, 0.5, 0.5);
+  vec3 c = texture(u_Source, v_TexCoord + o.xy).rgb + texture(u_Source, v_TexCoord + o.zy).rgb +
+    texture(u_Source, v_TexCoord + o.xw).rgb + texture(u_Source, v_TexCoord + o.zw).rgb;
+  color = vec4(c * 0.25, 1.0);
+}
+)";
+
+BloomEffect::BloomEffect()
+  : PostEffect("Bloom", s_BloomSource, { { "Threshold", 0.8f, 0.0f, 4.0f }, { "Intensity", 0.6f, 0.0f, 3.0f } }),
+  m_Downsample(ShaderProgramSource{ PostProcessStack::GetFullscreenVertexSource(), s_BloomDownsampleSource }),
+  m_Upsample(ShaderProgramSource{ PostProcessStack::GetFullscreenVertexSource(), s_BloomUpsampleSource }),
+  m_Result(nullptr)
+{
+}
+
+void BloomEffect::Prepass(PostProcessStack& stack, const Framebuffer& input, const float* params)
+{
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  FramebufferSpec spec;
+  spec.ColorFormat = FramebufferFormat::RGBA16F;
+  spec.Width = input.GetWidth();
+  spec.Height = input.GetHeight();
+
+  // threshold into half size, then keep halving
+  const Framebuffer* levels[MaxLevels];
+  int levelCount = 0;
+  const Framebuffer* source = &input;
+  m_Downsample.Bind();
+  m_Downsample.SetUniform1i("u_Source", 0);
+  m_Downsample.SetUniform1f("u_Threshold", params[0]);
+  while (levelCount < MaxLevels && spec.Width >= 2 && spec.Height >= 2)
+  {
+    spec.Width /= 2;
+    spec.Height /= 2;
+    Framebuffer& level = pool.Acquire(spec);
+    level.Bind();
+    source->BindColorTexture(0);
+    m_Downsample.SetUniform2f("u_TexelSize", 1.0f / source->GetWidth(), 1.0f / source->GetHeight());
+    m_Downsample.SetUniform1i("u_Prefilter", levelCount == 0 ? 1 : 0);
+    stack.DrawFullscreen(m_Downsample);
+
+    levels[levelCount++] = &level;
+    source = &level;
+  }
+
+  // each level is added onto the next larger one on the way back up
+  GLCall(glEnable(GL_BLEND));
+  GLCall(glBlendFunc(GL_ONE, GL_ONE));
+  m_Upsample.Bind();
+  m_Upsample.SetUniform1i("u_Source", 0);
+  for (int i = levelCount - 1; i > 0; i--)
+  {
+    levels[i - 1]->Bind();
+    levels[i]->BindColorTexture(0);
+    m_Upsample.SetUniform2f("u_TexelSize", 1.0f / levels[i]->GetWidth(), 1.0f / levels[i]->GetHeight());
+    stack.DrawFullscreen(m_Upsample);
+  }
+  GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+  GLCall(glDisable(GL_BLEND));
+
+  m_Result = levelCount > 0 ? levels[0] : nullptr;
+}
+
+void BloomEffect::BindTextures(Shader& shader, const std::string& prefix, unsigned int& textureSlot) const
+{
+  if (m_Result)
+    m_Result->BindColorTexture(textureSlot);
+  shader.SetUniform1i(prefix + "Texture", textureSlot);
+  textureSlot++;
+}
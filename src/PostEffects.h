@@ -0,0 +1,52 @@
+#pragma once
+#include "PostProcess.h"
+#include "Texture.h"
+
+class Framebuffer;
+
+// ACES filmic curve (Narkowicz fit) after an exposure scale.
+class TonemapEffect : public PostEffect
+{
+public:
+  TonemapEffect();
+};
+
+// 16x16x16 color lookup table, stored as 16 slices side by side in a
+// 256x16 texture. The default table is a procedural teal/orange grade.
+class ColorGradeEffect : public PostEffect
+{
+public:
+  static const int LutSize = 16;
+
+  ColorGradeEffect();
+
+  void BindTextures(Shader& shader, const std::string& prefix, unsigned int& textureSlot) const override;
+private:
+  Texture m_Lut;
+};
+
+class VignetteEffect : public PostEffect
+{
+public:
+  VignetteEffect();
+};
+
+// Bright parts of the image, blurred by downsampling through a chain of half
+// size targets and adding them back up. Only the final add runs at full
+// resolution, fused with the per-pixel effects after it.
+class BloomEffect : public PostEffect
+{
+public:
+  static const int MaxLevels = 6;
+
+  BloomEffect();
+
+  bool HasPrepass() const override { return true; }
+  void Prepass(PostProcessStack& stack, const Framebuffer& input, const float* params) override;
+  void BindTextures(Shader& shader, const std::string& prefix, unsigned int& textureSlot) const override;
+private:
+  Shader m_Downsample;
+  Shader m_Upsample;
+  // half resolution result of the last prepass
+  const Framebuffer* m_Result;
+};
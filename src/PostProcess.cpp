@@ -0,0 +1,225 @@
+#include "PostProcess.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+
+PostEffect::PostEffect(const char* name, const char* source, std::vector<PostEffectParam> params)
+  : m_Name(name), m_Source(source), m_Params(std::move(params))
+{
+}
+
+PostProcessStack::PostProcessStack()
+  : m_Enabled(false), m_Fusion(true), m_SceneActive(false), m_Scene(nullptr)
+{
+}
+
+PostProcessStack::~PostProcessStack()
+{
+}
+
+PostEffect& PostProcessStack::AddEffect(std::unique_ptr<PostEffect> effect)
+{
+  m_Effects.push_back(std::move(effect));
+  return *m_Effects.back();
+}
+
+void PostProcessStack::MoveEffect(size_t from, size_t to)
+{
+  if (from >= m_Effects.size() || to >= m_Effects.size() || from == to)
+    return;
+
+  std::unique_ptr<PostEffect> effect = std::move(m_Effects[from]);
+  m_Effects.erase(m_Effects.begin() + from);
+  m_Effects.insert(m_Effects.begin() + to, std::move(effect));
+}
+
+void PostProcessStack::BeginScene()
+{
+  m_SceneActive = m_Enabled;
+  if (!m_SceneActive)
+    return;
+
+  Renderer::Submit([this]() {
+    FramebufferSpec spec;
+    spec.ColorFormat = FramebufferFormat::RGBA16F;
+    m_Scene = &RenderTargetPool::Get().AcquireWindowSized(spec);
+    m_Scene->Bind();
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+  });
+}
+
+void PostProcessStack::EndScene()
+{
+  if (!m_SceneActive)
+    return;
+  m_SceneActive = false;
+
+  Frame frame;
+  frame.Fusion = m_Fusion;
+  for (const std::unique_ptr<PostEffect>& effect : m_Effects)
+  {
+    if (!effect->Enabled)
+      continue;
+    frame.Effects.push_back(effect.get());
+    frame.ParamOffsets.push_back(frame.Params.size());
+    for (const PostEffectParam& param : effect->GetParams())
+      frame.Params.push_back(param.Value);
+  }
+
+  Renderer::Submit([this, frame = std::move(frame)]() { Apply(frame); });
+}
+
+unsigned int PostProcessStack::GetPassCount() const
+{
+  unsigned int passes = 0;
+  bool pending = false;
+  for (const std::unique_ptr<PostEffect>& effect : m_Effects)
+  {
+    if (!effect->Enabled)
+      continue;
+    if (pending && (effect->HasPrepass() || !m_Fusion))
+      passes++;
+    pending = true;
+  }
+  // an empty stack still copies the scene to the window
+  return passes + 1;
+}
+
+void PostProcessStack::Apply(const Frame& frame)
+{
+  RenderTargetPool& pool = RenderTargetPool::Get();
+  int width = pool.GetWindowWidth(), height = pool.GetWindowHeight();
+  FramebufferSpec spec;
+  spec.ColorFormat = FramebufferFormat::RGBA16F;
+
+  GLCall(glDisable(GL_BLEND));
+
+  // Runs of per-pixel effects end where the next effect needs a prepass (it
+  // has to see their result), or after every effect with fusion off. The
+  // last run draws straight into the window.
+  const Framebuffer* input = m_Scene;
+  size_t first = 0;
+  size_t count = frame.Effects.size();
+  for (size_t i = 0; i < count; i++)
+  {
+    PostEffect* effect = frame.Effects[i];
+    if (i > first && (effect->HasPrepass() || !frame.Fusion))
+    {
+      Framebuffer& output = pool.AcquireWindowSized(spec);
+      output.Bind();
+      DrawPass(frame, first, i - first, *input);
+      // ping-pong: the old input can be handed out again
+      if (input != m_Scene)
+        pool.Release(*input);
+      input = &output;
+      first = i;
+    }
+    if (effect->HasPrepass())
+      effect->Prepass(*this, *input, &frame.Params[frame.ParamOffsets[i]]);
+  }
+
+  if (count > first)
+  {
+    Framebuffer::BindDefault(width, height);
+    DrawPass(frame, first, count - first, *input);
+  }
+  else
+  {
+    input->BlitToDefault(width, height);
+  }
+
+  Framebuffer::BindDefault(width, height);
+  GLCall(glEnable(GL_BLEND));
+  m_Scene = nullptr;
+}
+
+void PostProcessStack::DrawPass(const Frame& frame, size_t first, size_t count, const Framebuffer& input)
+{
+  FusedShader& fused = GetFusedShader(frame, first, count);
+  Shader& shader = *fused.Program;
+  shader.Bind();
+  input.BindColorTexture(0);
+  shader.SetUniform1i("u_Input", 0);
+
+  for (const FusedUniform& uniform : fused.Uniforms)
+    shader.SetUniform1f(uniform.Name, frame.Params[frame.ParamOffsets[first + uniform.Effect] + uniform.Param]);
+
+  unsigned int textureSlot = 1;
+  for (size_t i = 0; i < count; i++)
+    frame.Effects[first + i]->BindTextures(shader, "e" + std::to_string(i) + "_", textureSlot);
+
+  DrawFullscreen(shader);
+}
+
+PostProcessStack::FusedShader& PostProcessStack::GetFusedShader(const Frame& frame, size_t first, size_t count)
+{
+  std::string key;
+  for (size_t i = 0; i < count; i++)
+    key += std::string(frame.Effects[first + i]->GetName()) + "|";
+
+  FusedShader& fused = m_Shaders[key];
+  if (fused.Program)
+    return fused;
+
+  std::string fragment =
+    "#version 330 core\n"
+    "\n"
+    "layout(location = 0) out vec4 color;\n"
+    "in vec2 v_TexCoord;\n"
+    "uniform sampler2D u_Input;\n";
+  std::string body;
+  for (size_t i = 0; i < count; i++)
+  {
+    const PostEffect& effect = *frame.Effects[first + i];
+    std::string prefix = "e" + std::to_string(i) + "_";
+    std::string source = effect.GetSource();
+
+    fragment += "\n// " + std::string(effect.GetName()) + "\n";
+    const std::vector<PostEffectParam>& params = effect.GetParams();
+    for (size_t p = 0; p < params.size(); p++)
+    {
+      if (source.find(std::string("$") + params[p].Name) == std::string::npos)
+        continue;
+      fused.Uniforms.push_back({ prefix + params[p].Name, i, p });
+      fragment += "uniform float " + prefix + params[p].Name + ";\n";
+    }
+
+    for (size_t at = source.find('$'); at != std::string::npos; at = source.find('$', at + prefix.size()))
+      source.replace(at, 1, prefix);
+    fragment += source;
+    body += "  c = " + prefix + "Apply(c, v_TexCoord);\n";
+  }
+  fragment +=
+    "\nvoid main()\n"
+    "{\n"
+    "  vec4 c = texture(u_Input, v_TexCoord);\n" + body +
+    "  color = c;\n"
+    "}\n";
+
+  fused.Program = std::make_unique<Shader>(ShaderProgramSource{ GetFullscreenVertexSource(), fragment });
+  return fused;
+}
+
+void PostProcessStack::DrawFullscreen(const Shader& shader) const
+{
+  Renderer renderer;
+  renderer.DrawArrays(m_EmptyVAO, shader, 3);
+}
+
+const char* PostProcessStack::GetFullscreenVertexSource()
+{
+  // one triangle covering the screen, no vertex buffer needed
+  return
+    "#version 330 core\n"
+    "\n"
+    "out vec2 v_TexCoord;\n"
+    "\n"
+    "void main()\n"
+    "{\n"
+    "  vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+    "  v_TexCoord = p;\n"
+    "  gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);\n"
+    "}\n";
+}
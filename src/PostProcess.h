@@ -0,0 +1,129 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "VertexArray.h"
+#include "Shader.h"
+
+class Framebuffer;
+class PostProcessStack;
+
+struct PostEffectParam
+{
+  const char* Name;
+  float Value;
+  float Min, Max;
+};
+
+// One fullscreen effect. The per-pixel part is GLSL that defines
+//
+//   vec4 $Apply(vec4 color, vec2 uv)
+//
+// where every '$' is replaced with a prefix unique to the effect inside the
+// generated shader. Parameters become 'uniform float $<Name>' and are set
+// automatically; samplers and helpers are declared in the source with the
+// same prefix. Adjacent effects are fused into one shader and one pass.
+//
+// Effects that need more than the pixel under them (bloom) do that work in
+// Prepass(), which sees the image as the effects before it left it; their
+// per-pixel part then joins the next fused pass.
+class PostEffect
+{
+public:
+  PostEffect(const char* name, const char* source, std::vector<PostEffectParam> params = {});
+  virtual ~PostEffect() {}
+
+  virtual bool HasPrepass() const { return false; }
+  // GL thread. params holds this frame's values, in GetParams() order.
+  virtual void Prepass(PostProcessStack& stack, const Framebuffer& input, const float* params) {}
+  // GL thread. Binds the textures the per-pixel part samples, starting at
+  // textureSlot, and advances it.
+  virtual void BindTextures(Shader& shader, const std::string& prefix, unsigned int& textureSlot) const {}
+
+  inline const char* GetName() const { return m_Name; }
+  inline const char* GetSource() const { return m_Source; }
+  inline std::vector<PostEffectParam>& GetParams() { return m_Params; }
+  inline const std::vector<PostEffectParam>& GetParams() const { return m_Params; }
+
+  bool Enabled = true;
+private:
+  const char* m_Name;
+  const char* m_Source;
+  std::vector<PostEffectParam> m_Params;
+};
+
+// Ordered list of PostEffects applied to the frame after the test's OnRender.
+// The scene is drawn into a pooled RGBA16F target; each run of per-pixel
+// effects is compiled into a single shader (cached by effect sequence) and
+// drawn as one fullscreen pass, ping-ponging through pooled targets, with the
+// last pass writing straight to the window.
+//
+// BeginScene/EndScene and the UI run on the main thread; the GL work goes
+// through Renderer::Submit with the effect order and parameters copied, so it
+// also works with the render thread.
+class PostProcessStack
+{
+public:
+  PostProcessStack();
+  ~PostProcessStack();
+
+  PostEffect& AddEffect(std::unique_ptr<PostEffect> effect);
+  void MoveEffect(size_t from, size_t to);
+  inline size_t GetEffectCount() const { return m_Effects.size(); }
+  inline PostEffect& GetEffect(size_t index) { return *m_Effects[index]; }
+
+  void BeginScene();
+  void EndScene();
+
+  inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+  inline bool IsEnabled() const { return m_Enabled; }
+  // With fusion off every per-pixel effect gets its own pass, for comparison.
+  inline void SetFusion(bool fusion) { m_Fusion = fusion; }
+  inline bool IsFusing() const { return m_Fusion; }
+  // Full-resolution passes the current settings need (prepasses not included).
+  unsigned int GetPassCount() const;
+
+  // For Prepass implementations.
+  void DrawFullscreen(const Shader& shader) const;
+  static const char* GetFullscreenVertexSource();
+private:
+  struct Frame
+  {
+    std::vector<PostEffect*> Effects;
+    // all parameter values, effect after effect
+    std::vector<float> Params;
+    std::vector<size_t> ParamOffsets;
+    bool Fusion;
+  };
+
+  struct FusedUniform
+  {
+    std::string Name;
+    // effect inside the pass, parameter inside the effect
+    size_t Effect;
+    size_t Param;
+  };
+
+  struct FusedShader
+  {
+    std::unique_ptr<Shader> Program;
+    // only the parameters the sources actually use
+    std::vector<FusedUniform> Uniforms;
+  };
+
+  void Apply(const Frame& frame);
+  void DrawPass(const Frame& frame, size_t first, size_t count, const Framebuffer& input);
+  FusedShader& GetFusedShader(const Frame& frame, size_t first, size_t count);
+
+  std::vector<std::unique_ptr<PostEffect>> m_Effects;
+  bool m_Enabled;
+  bool m_Fusion;
+  bool m_SceneActive;
+
+  // GL thread only
+  VertexArray m_EmptyVAO;
+  Framebuffer* m_Scene;
+  std::unordered_map<std::string, FusedShader> m_Shaders;
+};
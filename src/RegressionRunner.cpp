@@ -0,0 +1,283 @@
+#include "RegressionRunner.h"
+#include "FrameClock.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+#include "GpuTimer.h"
+#include "ImageWriter.h"
+#include "stb_image/stb_image.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+  // value below which the given fraction of the samples fall
+  float Percentile(std::vector<float> samples, float fraction)
+  {
+    if (samples.empty())
+      return 0.0f;
+    size_t index = std::min(samples.size() - 1, (size_t)(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+  }
+
+  float Mean(const std::vector<float>& samples)
+  {
+    if (samples.empty())
+      return 0.0f;
+    float sum = 0.0f;
+    for (float sample : samples)
+      sum += sample;
+    return sum / samples.size();
+  }
+
+  const char* GetStatusName(RegressionRunner::Status status)
+  {
+    switch (status)
+    {
+    case RegressionRunner::Status::Passed: return "PASS";
+    case RegressionRunner::Status::Failed: return "FAIL";
+    case RegressionRunner::Status::Created: return "NEW";
+    case RegressionRunner::Status::Updated: return "UPDATED";
+    }
+    return "";
+  }
+}
+
+bool RegressionRunner::ParseArguments(int argc, char** argv, RegressionOptions& options)
+{
+  bool regression = false;
+  for (int i = 1; i < argc; i++)
+  {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (std::strcmp(arg, "--regression") == 0)
+      regression = true;
+    else if (std::strcmp(arg, "--update-golden") == 0)
+      regression = options.UpdateGolden = true;
+    else if (std::strcmp(arg, "--frames") == 0 && hasValue)
+      options.Frames = std::max(1, std::atoi(argv[++i]));
+    else if (std::strcmp(arg, "--warmup") == 0 && hasValue)
+      options.WarmupFrames = std::max(0, std::atoi(argv[++i]));
+    else if (std::strcmp(arg, "--tolerance") == 0 && hasValue)
+      options.Tolerance = std::max(0, std::atoi(argv[++i]));
+    else if (std::strcmp(arg, "--max-diff-pixels") == 0 && hasValue)
+      options.MaxDifferingPixels = (float)std::atof(argv[++i]);
+    else if (std::strcmp(arg, "--golden") == 0 && hasValue)
+      options.GoldenDirectory = argv[++i];
+    else if (std::strcmp(arg, "--out") == 0 && hasValue)
+      options.OutputDirectory = argv[++i];
+    else if (std::strcmp(arg, "--filter") == 0 && hasValue)
+      options.Filter = argv[++i];
+    else
+      std::cout << "Unknown argument: " << arg << std::endl;
+  }
+  return regression;
+}
+
+RegressionRunner::RegressionRunner(GLFWwindow* window, const RegressionOptions& options)
+  : m_Window(window), m_Options(options)
+{
+}
+
+int RegressionRunner::Run(const test::TestMenu& menu)
+{
+  std::error_code error;
+  std::filesystem::create_directories(m_Options.GoldenDirectory, error);
+  std::filesystem::create_directories(m_Options.OutputDirectory, error);
+
+  std::string csvPath = m_Options.OutputDirectory + "/timings.csv";
+  std::ofstream csv(csvPath);
+  csv << "test,frames,cpu_mean_ms,cpu_p95_ms,cpu_max_ms,gpu_mean_ms,gpu_p95_ms,result,max_difference,differing_pixels\n";
+
+  int failures = 0;
+  m_Results.clear();
+  for (auto& test : menu.GetTests())
+  {
+    if (!m_Options.Filter.empty() && test.first.find(m_Options.Filter) == std::string::npos)
+      continue;
+
+    Result result = RunTest(test.first, test.second);
+    if (result.TestStatus == Status::Failed)
+      failures++;
+
+    char line[256];
+    snprintf(line, sizeof(line), "[%-7s] %-32s cpu %6.2f ms (p95 %6.2f)  gpu %6.2f ms (p95 %6.2f)",
+      GetStatusName(result.TestStatus), result.Name.c_str(), result.CpuMean, result.CpuP95, result.GpuMean, result.GpuP95);
+    std::cout << line;
+    if (!result.Message.empty())
+      std::cout << "  " << result.Message;
+    std::cout << std::endl;
+
+    csv << '"' << result.Name << "\"," << result.Frames << ',' << result.CpuMean << ',' << result.CpuP95 << ','
+      << result.CpuMax << ',' << result.GpuMean << ',' << result.GpuP95 << ',' << GetStatusName(result.TestStatus) << ','
+      << result.MaxDifference << ',' << result.DifferingPixels << '\n';
+
+    m_Results.push_back(std::move(result));
+  }
+
+  std::cout << m_Results.size() << " tests, " << failures << " failed, timings in " << csvPath << std::endl;
+  return failures;
+}
+
+RegressionRunner::Result RegressionRunner::RunTest(const std::string& name, const std::function<test::Test*()>& factory)
+{
+  Result result;
+  result.Name = name;
+
+  int width, height;
+  glfwGetFramebufferSize(m_Window, &width, &height);
+  GLCall(glViewport(0, 0, width, height));
+  RenderTargetPool::Get().OnWindowResize(width, height);
+
+  Renderer renderer;
+  GpuTimer gpuTimer;
+  std::vector<float> cpuTimes, gpuTimes;
+  std::vector<unsigned char> pixels((size_t)width * height * 4);
+
+  // one fixed step per frame and no interpolation, so every run draws the same frames
+  const float deltaTime = 1.0f / 60.0f;
+  test::Test* test = factory();
+  for (int frame = 0; frame < m_Options.Frames; frame++)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    // only for its frame index (font cache eviction); the tests get deltaTime
+    FrameClock::Get().Tick();
+    Renderer::ResetStats();
+    RenderTargetPool::Get().BeginFrame();
+    gpuTimer.Begin();
+    renderer.Clear();
+    test->OnFixedUpdate(deltaTime);
+    test->OnUpdate(deltaTime);
+    test->OnRender(1.0f);
+    gpuTimer.End();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    bool measured = frame >= m_Options.WarmupFrames;
+    if (measured)
+      cpuTimes.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+
+    if (frame == m_Options.Frames - 1)
+    {
+      GLCall(glReadBuffer(GL_BACK));
+      GLCall(glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data()));
+    }
+    glfwSwapBuffers(m_Window);
+    glfwPollEvents();
+
+    float gpuTime;
+    if (gpuTimer.Poll(gpuTime) && measured)
+      gpuTimes.push_back(gpuTime);
+  }
+  delete test;
+
+  result.Frames = m_Options.Frames;
+  result.CpuMean = Mean(cpuTimes);
+  result.CpuP95 = Percentile(cpuTimes, 0.95f);
+  result.CpuMax = cpuTimes.empty() ? 0.0f : *std::max_element(cpuTimes.begin(), cpuTimes.end());
+  result.GpuMean = Mean(gpuTimes);
+  result.GpuP95 = Percentile(gpuTimes, 0.95f);
+
+  Compare(result, pixels, width, height);
+  return result;
+}
+
+void RegressionRunner::Compare(Result& result, const std::vector<unsigned char>& pixels, int width, int height)
+{
+  std::string fileName = GetFileName(result.Name);
+  std::string goldenPath = m_Options.GoldenDirectory + "/" + fileName + ".png";
+
+  bool exists = std::filesystem::exists(goldenPath);
+  if (!exists || m_Options.UpdateGolden)
+  {
+    result.TestStatus = exists ? Status::Updated : Status::Created;
+    if (!ImageWriter::WritePng(goldenPath, width, height, pixels.data()))
+    {
+      result.TestStatus = Status::Failed;
+      result.Message = "could not write " + goldenPath;
+    }
+    return;
+  }
+
+  // bottom row first, like glReadPixels
+  stbi_set_flip_vertically_on_load(true);
+  int goldenWidth, goldenHeight, channels;
+  unsigned char* golden = stbi_load(goldenPath.c_str(), &goldenWidth, &goldenHeight, &channels, 4);
+  if (!golden)
+  {
+    result.TestStatus = Status::Failed;
+    result.Message = "could not read " + goldenPath;
+    return;
+  }
+  if (goldenWidth != width || goldenHeight != height)
+  {
+    stbi_image_free(golden);
+    result.TestStatus = Status::Failed;
+    result.Message = "golden is " + std::to_string(goldenWidth) + "x" + std::to_string(goldenHeight) +
+      ", frame is " + std::to_string(width) + "x" + std::to_string(height);
+    ImageWriter::WritePng(m_Options.OutputDirectory + "/" + fileName + "_actual.png", width, height, pixels.data());
+    return;
+  }
+
+  // differing pixels in red over a darkened copy of the frame
+  std::vector<unsigned char> diff(pixels.size());
+  size_t pixelCount = (size_t)width * height;
+  for (size_t i = 0; i < pixelCount; i++)
+  {
+    const unsigned char* actual = &pixels[i * 4];
+    const unsigned char* expected = &golden[i * 4];
+    // the back buffer's alpha is undefined
+    int difference = 0;
+    for (int c = 0; c < 3; c++)
+      difference = std::max(difference, std::abs((int)actual[c] - (int)expected[c]));
+    result.MaxDifference = std::max(result.MaxDifference, difference);
+
+    unsigned char* out = &diff[i * 4];
+    if (difference > m_Options.Tolerance)
+    {
+      result.DifferingPixels++;
+      out[0] = (unsigned char)std::min(255, 128 + difference);
+      out[1] = 0;
+      out[2] = 0;
+    }
+    else
+    {
+      unsigned char gray = (unsigned char)((actual[0] + actual[1] + actual[2]) / 12);
+      out[0] = out[1] = out[2] = gray;
+    }
+    out[3] = 255;
+  }
+  stbi_image_free(golden);
+
+  if (result.DifferingPixels <= m_Options.MaxDifferingPixels * pixelCount)
+  {
+    result.TestStatus = Status::Passed;
+    return;
+  }
+
+  result.TestStatus = Status::Failed;
+  result.Message = std::to_string(result.DifferingPixels) + " pixels differ, max difference " + std::to_string(result.MaxDifference);
+  ImageWriter::WritePng(m_Options.OutputDirectory + "/" + fileName + "_actual.png", width, height, pixels.data());
+  ImageWriter::WritePng(m_Options.OutputDirectory + "/" + fileName + "_diff.png", width, height, diff.data());
+}
+
+std::string RegressionRunner::GetFileName(const std::string& name) const
+{
+  std::string fileName;
+  for (char c : name)
+  {
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+      fileName += c;
+    else if (!fileName.empty() && fileName.back() != '_')
+      fileName += '_';
+  }
+  while (!fileName.empty() && fileName.back() == '_')
+    fileName.pop_back();
+  return fileName;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "tests/Test.h"
+
+struct GLFWwindow;
+
+struct RegressionOptions
+{
+  int Frames = 120;
+  // the first frames build caches and upload data, they are left out of the timings
+  int WarmupFrames = 10;
+  // largest per-channel difference (0-255) that still counts as a match
+  int Tolerance = 2;
+  // fraction of pixels allowed to exceed the tolerance
+  float MaxDifferingPixels = 0.0f;
+  bool UpdateGolden = false;
+  std::string GoldenDirectory = "res/golden";
+  std::string OutputDirectory = "regression";
+  // only tests whose name contains this run
+  std::string Filter;
+};
+
+// Runs every registered test headlessly with a fixed time step, compares the
+// last frame against a golden PNG and writes the frame timings to a CSV, so
+// one run checks both what the tests draw and how fast they draw it.
+//
+//   OpenGL01 --regression [--frames N] [--tolerance N] [--max-diff-pixels F]
+//            [--golden DIR] [--out DIR] [--filter NAME] [--update-golden]
+//
+// Missing golden images are written instead of compared. Failing tests leave
+// <name>_actual.png and <name>_diff.png in the output directory.
+class RegressionRunner
+{
+public:
+  enum class Status { Passed, Failed, Created, Updated };
+
+  struct Result
+  {
+    std::string Name;
+    Status TestStatus = Status::Failed;
+    int Frames = 0;
+    float CpuMean = 0.0f, CpuP95 = 0.0f, CpuMax = 0.0f;
+    float GpuMean = 0.0f, GpuP95 = 0.0f;
+    int MaxDifference = 0;
+    unsigned int DifferingPixels = 0;
+    std::string Message;
+  };
+
+  // Returns true when the command line asks for a regression run.
+  static bool ParseArguments(int argc, char** argv, RegressionOptions& options);
+
+  RegressionRunner(GLFWwindow* window, const RegressionOptions& options);
+
+  // Must run on the GL thread with the render thread stopped. Returns the
+  // number of failed tests.
+  int Run(const test::TestMenu& menu);
+
+  inline const std::vector<Result>& GetResults() const { return m_Results; }
+private:
+  Result RunTest(const std::string& name, const std::function<test::Test*()>& factory);
+  void Compare(Result& result, const std::vector<unsigned char>& pixels, int width, int height);
+  std::string GetFileName(const std::string& name) const;
+
+  GLFWwindow* m_Window;
+  RegressionOptions m_Options;
+  std::vector<Result> m_Results;
+};
@@ -0,0 +1,132 @@
+#include "RenderTargetPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+RenderTargetPool::RenderTargetPool()
+  : m_WindowWidth(1), m_WindowHeight(1), m_Frame(0), m_CreatedCount(0)
+{
+}
+
+RenderTargetPool& RenderTargetPool::Get()
+{
+  static RenderTargetPool pool;
+  return pool;
+}
+
+Framebuffer& RenderTargetPool::Acquire(const FramebufferSpec& spec)
+{
+  return Acquire(spec, 0.0f);
+}
+
+Framebuffer& RenderTargetPool::AcquireWindowSized(const FramebufferSpec& spec, float scale)
+{
+  scale = std::max(std::round(scale * ScaleSteps), 1.0f) / ScaleSteps;
+  FramebufferSpec sized = spec;
+  GetWindowSize(scale, sized.Width, sized.Height);
+  return Acquire(sized, scale);
+}
+
+Framebuffer& RenderTargetPool::Acquire(const FramebufferSpec& spec, float scale)
+{
+  for (const std::unique_ptr<Target>& target : m_Targets)
+  {
+    if (!target->InUse && target->Scale == scale && target->Buffer.GetSpec() == spec)
+    {
+      target->InUse = true;
+      target->LastUsedFrame = m_Frame;
+      return target->Buffer;
+    }
+  }
+
+  m_Targets.push_back(std::make_unique<Target>(spec, scale));
+  m_CreatedCount++;
+  Target& target = *m_Targets.back();
+  target.InUse = true;
+  target.LastUsedFrame = m_Frame;
+  return target.Buffer;
+}
+
+void RenderTargetPool::Release(const Framebuffer& buffer)
+{
+  for (const std::unique_ptr<Target>& target : m_Targets)
+  {
+    if (&target->Buffer == &buffer)
+    {
+      target->InUse = false;
+      return;
+    }
+  }
+}
+
+void RenderTargetPool::BeginFrame()
+{
+  // the targets are still marked with what the finished frame used
+  RenderTargetPoolStats stats;
+  stats.WindowWidth = m_WindowWidth;
+  stats.WindowHeight = m_WindowHeight;
+  stats.Targets = (unsigned int)m_Targets.size();
+  stats.Created = m_CreatedCount;
+  for (const std::unique_ptr<Target>& target : m_Targets)
+  {
+    stats.TargetsInUse += target->InUse ? 1 : 0;
+    stats.MemoryUsage += target->Buffer.GetMemoryUsage();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_StatsMutex);
+    m_Stats = stats;
+  }
+
+  m_Frame++;
+  for (size_t i = 0; i < m_Targets.size();)
+  {
+    if (m_Frame - m_Targets[i]->LastUsedFrame > EvictAfterFrames)
+    {
+      m_Targets[i] = std::move(m_Targets.back());
+      m_Targets.pop_back();
+      continue;
+    }
+    m_Targets[i]->InUse = false;
+    i++;
+  }
+}
+
+void RenderTargetPool::OnWindowResize(int width, int height)
+{
+  // minimised windows report 0x0; keep the old targets until it comes back
+  if (width <= 0 || height <= 0 || (width == m_WindowWidth && height == m_WindowHeight))
+    return;
+
+  m_WindowWidth = width;
+  m_WindowHeight = height;
+  for (const std::unique_ptr<Target>& target : m_Targets)
+  {
+    if (target->Scale > 0.0f)
+    {
+      int targetWidth, targetHeight;
+      GetWindowSize(target->Scale, targetWidth, targetHeight);
+      target->Buffer.Resize(targetWidth, targetHeight);
+    }
+  }
+}
+
+void RenderTargetPool::Clear()
+{
+  m_Targets.clear();
+}
+
+RenderTargetPoolStats RenderTargetPool::GetStats() const
+{
+  std::lock_guard<std::mutex> lock(m_StatsMutex);
+  return m_Stats;
+}
+
+void RenderTargetPool::GetWindowSize(float scale, int& width, int& height) const
+{
+  width = (int)(m_WindowWidth * scale);
+  height = (int)(m_WindowHeight * scale);
+  if (width < 1)
+    width = 1;
+  if (height < 1)
+    height = 1;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Framebuffer.h"
+
+struct RenderTargetPoolStats
+{
+  int WindowWidth = 0, WindowHeight = 0;
+  unsigned int Targets = 0;
+  unsigned int TargetsInUse = 0;
+  // targets created since startup, a rough measure of how well reuse works
+  unsigned int Created = 0;
+  size_t MemoryUsage = 0;
+};
+
+// Hands out transient render targets for the current frame and keeps them for
+// reuse. Acquire() returns a free target with the same spec or creates one;
+// every target is released again at BeginFrame(), and targets nobody asked
+// for in EvictAfterFrames frames are deleted.
+//
+// Window-sized targets track the window: OnWindowResize() resizes those and
+// leaves fixed-size ones alone. Their scale is rounded to a multiple of
+// 1 / ScaleSteps, so a scale that drifts does not create a target per value.
+//
+// GL thread only, like everything else that creates GL objects, except
+// GetStats().
+class RenderTargetPool
+{
+public:
+  static const unsigned int EvictAfterFrames = 30;
+  static const unsigned int ScaleSteps = 16;
+
+  static RenderTargetPool& Get();
+
+  // Target of exactly spec.Width x spec.Height.
+  Framebuffer& Acquire(const FramebufferSpec& spec);
+  // scale x the window size; spec.Width and spec.Height are ignored.
+  Framebuffer& AcquireWindowSized(const FramebufferSpec& spec, float scale = 1.0f);
+  // Optional: makes the target available again within the same frame.
+  void Release(const Framebuffer& target);
+
+  void BeginFrame();
+  void OnWindowResize(int width, int height);
+  // Deletes every target; call before the context goes away.
+  void Clear();
+
+  inline int GetWindowWidth() const { return m_WindowWidth; }
+  inline int GetWindowHeight() const { return m_WindowHeight; }
+  // As of the last finished frame; safe to call from any thread.
+  RenderTargetPoolStats GetStats() const;
+private:
+  RenderTargetPool();
+
+  struct Target
+  {
+    Target(const FramebufferSpec& spec, float scale) : Buffer(spec), Scale(scale), InUse(false), LastUsedFrame(0) {}
+
+    Framebuffer Buffer;
+    // 0 for fixed-size targets
+    float Scale;
+    bool InUse;
+    unsigned int LastUsedFrame;
+  };
+
+  Framebuffer& Acquire(const FramebufferSpec& spec, float scale);
+  void GetWindowSize(float scale, int& width, int& height) const;
+
+  std::vector<std::unique_ptr<Target>> m_Targets;
+  int m_WindowWidth, m_WindowHeight;
+  unsigned int m_Frame;
+  unsigned int m_CreatedCount;
+
+  // taken in BeginFrame()
+  RenderTargetPoolStats m_Stats;
+  mutable std::mutex m_StatsMutex;
+};
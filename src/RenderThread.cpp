@@ -0,0 +1,155 @@
+#include "RenderThread.h"
+#include "Renderer.h"
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+void RenderCommandList::Execute()
+{
+  for (const Command& command : m_Commands)
+    command.Function(command.Storage);
+  m_Commands.clear();
+}
+
+static float MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+RenderThread::RenderThread(GLFWwindow* window)
+  : m_Window(window), m_Running(false), m_SubmittedFrames(0), m_CompletedFrames(0),
+  m_SyncPending(false), m_StopRequested(false), m_FramesInFlight(1), m_RenderTime(0.0f), m_WaitTime(0.0f)
+{
+}
+
+RenderThread::~RenderThread()
+{
+  Stop();
+}
+
+void RenderThread::Start()
+{
+  if (m_Running)
+    return;
+
+  glfwMakeContextCurrent(nullptr);
+  m_StopRequested = false;
+  m_Running = true;
+  m_Thread = std::thread(&RenderThread::Run, this);
+  Renderer::SetRenderThread(this);
+}
+
+void RenderThread::Stop()
+{
+  if (!m_Running)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_StopRequested = true;
+  }
+  m_Condition.notify_all();
+  m_Thread.join();
+
+  m_Running = false;
+  Renderer::SetRenderThread(nullptr);
+  glfwMakeContextCurrent(m_Window);
+
+  // anything recorded after the last EndFrame() still has to run
+  m_Lists[GetRecordingIndex()].Execute();
+}
+
+void RenderThread::Submit(RenderCommandList::CommandFunction function, void* storage)
+{
+  m_Lists[GetRecordingIndex()].Submit(function, storage);
+}
+
+void RenderThread::SubmitAndWait(std::function<void()> command)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_SyncCommand = std::move(command);
+  m_SyncPending = true;
+  m_Condition.notify_all();
+  m_Condition.wait(lock, [this] { return !m_SyncPending; });
+}
+
+void RenderThread::EndFrame()
+{
+  auto start = std::chrono::steady_clock::now();
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_SubmittedFrames++;
+  m_Condition.notify_all();
+  m_Condition.wait(lock, [this] { return m_SubmittedFrames - m_CompletedFrames <= m_FramesInFlight; });
+
+  m_WaitTime = MillisecondsSince(start);
+}
+
+void RenderThread::WaitIdle()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_Condition.wait(lock, [this] { return m_CompletedFrames == m_SubmittedFrames; });
+}
+
+void RenderThread::SetFramesInFlight(unsigned int count)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_FramesInFlight = count < 1 ? 1 : (count > MaxFramesInFlight ? MaxFramesInFlight : count);
+}
+
+float RenderThread::GetRenderTime() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_RenderTime;
+}
+
+void RenderThread::Run()
+{
+  glfwMakeContextCurrent(m_Window);
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  while (true)
+  {
+    m_Condition.wait(lock, [this] {
+      return m_CompletedFrames < m_SubmittedFrames || m_SyncPending || m_StopRequested;
+    });
+
+    // handed-over frames always go first, so a sync command or a stop
+    // request only runs once the pipeline is drained
+    if (m_CompletedFrames < m_SubmittedFrames)
+    {
+      RenderCommandList& list = m_Lists[m_CompletedFrames % ListCount];
+      lock.unlock();
+
+      auto start = std::chrono::steady_clock::now();
+      list.Execute();
+      glfwSwapBuffers(m_Window);
+      float renderTime = MillisecondsSince(start);
+
+      lock.lock();
+      m_RenderTime = renderTime;
+      m_CompletedFrames++;
+      m_Condition.notify_all();
+    }
+    else if (m_SyncPending)
+    {
+      // the main thread is blocked in SubmitAndWait(), so the list it is
+      // recording into can safely be flushed from here
+      lock.unlock();
+      m_Lists[m_SubmittedFrames % ListCount].Execute();
+      m_SyncCommand();
+      lock.lock();
+
+      m_SyncCommand = nullptr;
+      m_SyncPending = false;
+      m_Condition.notify_all();
+    }
+    else
+    {
+      break;
+    }
+  }
+  lock.unlock();
+
+  glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+// Commands are type-erased callables stored elsewhere (in the frame arena):
+// function runs the one at storage and destroys it. The list keeps its
+// capacity, so once warmed up recording a frame does not allocate.
+class RenderCommandList
+{
+public:
+  typedef void (*CommandFunction)(void* storage);
+
+  inline void Submit(CommandFunction function, void* storage) { m_Commands.push_back({ function, storage }); }
+  // Runs every recorded command in order and leaves the list empty.
+  void Execute();
+
+  inline size_t GetSize() const { return m_Commands.size(); }
+private:
+  struct Command
+  {
+    CommandFunction Function;
+    void* Storage;
+  };
+
+  std::vector<Command> m_Commands;
+};
+
+// Owns the GL context on a dedicated thread while running. The main thread
+// records a frame's commands (Renderer::Submit) and hands the list over with
+// EndFrame(); the render thread executes it and swaps buffers while the main
+// thread simulates and records the next frame.
+//
+// The submitted/completed frame counters act as the fence between the two:
+// EndFrame() blocks while more than GetFramesInFlight() handed-over frames are
+// still pending, which also guarantees the next list to record into is free.
+class RenderThread
+{
+public:
+  static const unsigned int MaxFramesInFlight = 2;
+
+  RenderThread(GLFWwindow* window);
+  ~RenderThread();
+
+  // Start/Stop must be called from the main thread between frames. Start
+  // takes the GL context away from the calling thread, Stop gives it back.
+  void Start();
+  void Stop();
+  inline bool IsRunning() const { return m_Running; }
+
+  void Submit(RenderCommandList::CommandFunction function, void* storage);
+  // Flushes everything recorded so far, runs the command on the render
+  // thread and blocks until it has finished.
+  void SubmitAndWait(std::function<void()> command);
+  void EndFrame();
+  void WaitIdle();
+
+  void SetFramesInFlight(unsigned int count);
+  inline unsigned int GetFramesInFlight() const { return m_FramesInFlight; }
+  // Index of the command list the main thread is recording into, in [0, MaxFramesInFlight].
+  inline unsigned int GetRecordingIndex() const { return (unsigned int)(m_SubmittedFrames % ListCount); }
+
+  // Milliseconds the render thread spent executing the last frame (including swap).
+  float GetRenderTime() const;
+  // Milliseconds the main thread was blocked in the last EndFrame().
+  inline float GetWaitTime() const { return m_WaitTime; }
+private:
+  static const unsigned int ListCount = MaxFramesInFlight + 1;
+
+  void Run();
+
+  GLFWwindow* m_Window;
+  std::thread m_Thread;
+  bool m_Running;
+
+  mutable std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  RenderCommandList m_Lists[ListCount];
+  unsigned long long m_SubmittedFrames;
+  unsigned long long m_CompletedFrames;
+  std::function<void()> m_SyncCommand;
+  bool m_SyncPending;
+  bool m_StopRequested;
+
+  unsigned int m_FramesInFlight;
+  float m_RenderTime;
+  float m_WaitTime;
+};
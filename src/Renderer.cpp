@@ -1,4 +1,14 @@
 #include "Renderer.h"
+#include "FrameAllocator.h"
+#include "RenderThread.h"
+#include "VertexFormat.h"
+
+#include <mutex>
+
+static RenderStats s_Stats;
+static RenderStats s_LastStats;
+static std::mutex s_StatsMutex;
+static RenderThread* s_RenderThread = nullptr;
 
 void Renderer::Clear() const
 {
@@ -12,6 +22,124 @@ void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader&
   va.Bind();
   ib.Bind();
   glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr);
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += ib.GetCount();
+}
+
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex) const
+{
+  shader.Bind();
+  va.Bind();
+  ib.Bind();
+  glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(unsigned int)));
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += count;
+}
+
+void Renderer::Draw(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader) const
+{
+  shader.Bind();
+  format.Bind();
+  ib.Bind();
+  glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr);
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += ib.GetCount();
+}
+
+void Renderer::Draw(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex, int baseVertex) const
+{
+  shader.Bind();
+  format.Bind();
+  ib.Bind();
+  glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const void*)(firstIndex * sizeof(unsigned int)), baseVertex);
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += count;
+}
+
+void Renderer::DrawIndirect(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader, unsigned int drawCount, unsigned int indexCount) const
+{
+  shader.Bind();
+  format.Bind();
+  ib.Bind();
+  glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, drawCount, 0);
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += indexCount;
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const
+{
+  shader.Bind();
+  va.Bind();
+  ib.Bind();
+  glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr, instanceCount);
+
+  s_Stats.DrawCalls++;
+  s_Stats.Indices += ib.GetCount() * instanceCount;
+}
+
+void Renderer::DrawArrays(const VertexArray& va, const Shader& shader, unsigned int vertexCount) const
+{
+  shader.Bind();
+  va.Bind();
+  glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+
+  s_Stats.DrawCalls++;
+}
+
+void Renderer::DrawPoints(const VertexArray& va, const Shader& shader, unsigned int count, unsigned int first) const
+{
+  shader.Bind();
+  va.Bind();
+  glDrawArrays(GL_POINTS, first, count);
+
+  s_Stats.DrawCalls++;
+}
+
+RenderStats Renderer::GetStats()
+{
+  std::lock_guard<std::mutex> lock(s_StatsMutex);
+  return s_LastStats;
+}
+
+void Renderer::ResetStats()
+{
+  std::lock_guard<std::mutex> lock(s_StatsMutex);
+  s_LastStats = s_Stats;
+  s_Stats = RenderStats();
+}
+
+void* Renderer::AllocateCommand(size_t size, size_t alignment)
+{
+  // the arena of the frame being recorded lives until the render thread has run it
+  return BufferedFrameAllocator::Get().GetCurrent().Allocate(size, alignment);
+}
+
+void Renderer::RecordCommand(void (*function)(void*), void* storage)
+{
+  s_RenderThread->Submit(function, storage);
+}
+
+void Renderer::SubmitAndWait(std::function<void()> command)
+{
+  if (s_RenderThread)
+    s_RenderThread->SubmitAndWait(std::move(command));
+  else
+    command();
+}
+
+void Renderer::SetRenderThread(RenderThread* renderThread)
+{
+  s_RenderThread = renderThread;
+}
+
+bool Renderer::IsRenderThreadRunning()
+{
+  return s_RenderThread != nullptr;
 }
 
 void GLClearError()
@@ -1,5 +1,9 @@
 #pragma once
 #include <glad/glad.h>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "IndexBuffer.h"
 #include "VertexArray.h"
 #include "Shader.h"
@@ -11,14 +15,79 @@
     ASSERT(GLLogCall(#x, __FILE__, __LINE__));\
 } while (0)
 
+class RenderThread;
+class VertexFormat;
+
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
 
 
+struct RenderStats
+{
+  unsigned int DrawCalls = 0;
+  unsigned int Indices = 0;
+
+  unsigned int GetQuadCount() const { return Indices / 6; }
+};
+
 class Renderer
 {
 public:
   void Clear() const;
   void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+  void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex = 0) const;
+  // Draws with whatever buffers are currently attached to the format.
+  void Draw(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader) const;
+  // Indices are relative to baseVertex (glDrawElementsBaseVertex), so many
+  // meshes can share one vertex and index buffer.
+  void Draw(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader, unsigned int count, unsigned int firstIndex, int baseVertex) const;
+  // glMultiDrawElementsIndirect over drawCount commands in the bound
+  // GL_DRAW_INDIRECT_BUFFER; indexCount is only for the stats.
+  void DrawIndirect(const VertexFormat& format, const IndexBuffer& ib, const Shader& shader, unsigned int drawCount, unsigned int indexCount) const;
+  void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
+  // Non-indexed triangles, e.g. a fullscreen triangle built from gl_VertexID.
+  void DrawArrays(const VertexArray& va, const Shader& shader, unsigned int vertexCount) const;
+  // GL_POINTS from vertex first on; also the input of transform feedback passes.
+  void DrawPoints(const VertexArray& va, const Shader& shader, unsigned int count, unsigned int first = 0) const;
+
+  // Stats of the last finished frame. ResetStats() closes the current frame
+  // and must run on the GL thread, i.e. through Submit().
+  static RenderStats GetStats();
+  static void ResetStats();
+
+  // Records GL work for the current frame. Runs it right away unless a
+  // render thread is active, in which case the command runs there a frame
+  // later: capture everything it needs by value. The command itself is
+  // placed in the frame arena, so recording does not touch the heap.
+  template<typename F>
+  static void Submit(F&& command)
+  {
+    typedef typename std::decay<F>::type Command;
+    if (!IsRenderThreadRunning())
+    {
+      command();
+      return;
+    }
+    void* storage = AllocateCommand(sizeof(Command), alignof(Command));
+    new (storage) Command(std::forward<F>(command));
+    RecordCommand(&RunCommand<Command>, storage);
+  }
+  // Runs the command on the GL thread, after everything submitted so far,
+  // and blocks until it is done. Use for resource creation and destruction.
+  static void SubmitAndWait(std::function<void()> command);
+
+  static void SetRenderThread(RenderThread* renderThread);
+  static bool IsRenderThreadRunning();
+private:
+  template<typename Command>
+  static void RunCommand(void* storage)
+  {
+    Command* command = (Command*)storage;
+    (*command)();
+    command->~Command();
+  }
+
+  static void* AllocateCommand(size_t size, size_t alignment);
+  static void RecordCommand(void (*function)(void*), void* storage);
 };
 
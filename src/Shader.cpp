@@ -7,6 +7,17 @@ Shader::Shader(const std::string& filepath) :
   ShaderProgramSource source = ParseShader(filepath);
   m_RendererId = CreateShader(source.VertexSource, source.FragmentSource);
 }
+Shader::Shader(const ShaderProgramSource& source) :
+  m_RendererId(0)
+{
+  m_RendererId = CreateShader(source.VertexSource, source.FragmentSource);
+}
+Shader::Shader(const std::string& filepath, const std::vector<std::string>& feedbackVaryings) :
+  m_FilePath(filepath), m_RendererId(0)
+{
+  ShaderProgramSource source = ParseShader(filepath);
+  m_RendererId = CreateShader(source.VertexSource, source.FragmentSource, feedbackVaryings);
+}
 void Shader::Bind()const
 {
   glUseProgram(m_RendererId);
@@ -27,6 +38,16 @@ unsigned int Shader::GetUniformLocation(const std::string& name)
   m_UniformlocationCache[name] = location;
   return location;
 }
+void Shader::SetUniform1f(const std::string& name, float value)
+{
+  int location = GetUniformLocation(name);
+  glUniform1f(location, value);
+}
+void Shader::SetUniform2f(const std::string& name, float v0, float v1)
+{
+  int location = GetUniformLocation(name);
+  glUniform2f(location, v0, v1);
+}
 void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3) 
 {
   int location = GetUniformLocation(name);
@@ -43,6 +64,16 @@ void Shader::SetUniform1iv(const std::string& name, int count, int* value)
   GLCall(glUniform1iv(GetUniformLocation(name), count, value));
 }
 
+void Shader::SetUniformBlockBinding(const std::string& name, unsigned int binding)
+{
+  unsigned int index = glGetUniformBlockIndex(m_RendererId, name.c_str());
+  if (index == GL_INVALID_INDEX) {
+    std::cout << "Warning :uniform block '" << name << "' doesn't exist!" << std::endl;
+    return;
+  }
+  GLCall(glUniformBlockBinding(m_RendererId, index, binding));
+}
+
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
   int location = GetUniformLocation(name);
@@ -98,17 +129,38 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
   }
   return id;
 }
-unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader,
+  const std::vector<std::string>& feedbackVaryings)
 {
   unsigned int program = glCreateProgram();
   unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-  unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+  // a transform feedback pass may have no fragment stage
+  unsigned int fs = fragmentShader.empty() ? 0 : CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
   glAttachShader(program, vs);
-  glAttachShader(program, fs);
+  if (fs)
+    glAttachShader(program, fs);
+  if (!feedbackVaryings.empty()) {
+    std::vector<const char*> names;
+    for (const std::string& varying : feedbackVaryings)
+      names.push_back(varying.c_str());
+    glTransformFeedbackVaryings(program, (int)names.size(), names.data(), GL_INTERLEAVED_ATTRIBS);
+  }
   glLinkProgram(program);
+
+  int result;
+  glGetProgramiv(program, GL_LINK_STATUS, &result);
+  if (result == GL_FALSE) {
+    int length;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::vector<char> message(length + 1);
+    glGetProgramInfoLog(program, length, &length, message.data());
+    std::cout << "Failed to link " << (m_FilePath.empty() ? "generated" : m_FilePath) << " program" << std::endl;
+    std::cout << message.data() << std::endl;
+  }
   glValidateProgram(program);
   glDeleteShader(vs);
-  glDeleteShader(fs);
+  if (fs)
+    glDeleteShader(fs);
   return program;
 }
 
@@ -117,4 +169,24 @@ Shader::~Shader()
   glDeleteProgram(m_RendererId);
 }
 
+Shader::Shader(Shader&& other) noexcept
+  : m_FilePath(std::move(other.m_FilePath)), m_RendererId(other.m_RendererId),
+  m_UniformlocationCache(std::move(other.m_UniformlocationCache))
+{
+  other.m_RendererId = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteProgram(m_RendererId);
+    m_FilePath = std::move(other.m_FilePath);
+    m_RendererId = other.m_RendererId;
+    m_UniformlocationCache = std::move(other.m_UniformlocationCache);
+    other.m_RendererId = 0;
+  }
+  return *this;
+}
+
 
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <sstream>
 #include <unordered_map>
+#include <vector>
 #include "glm/glm.hpp"
 struct ShaderProgramSource {
   std::string VertexSource;
@@ -19,19 +20,35 @@ private:
   mutable std::unordered_map<std::string, int> m_UniformlocationCache;
 public:
   Shader(const std::string& filepath);
+  // For generated shaders that have no file.
+  Shader(const ShaderProgramSource& source);
+  // Captures the named vertex outputs, interleaved in this order, when
+  // drawn inside glBeginTransformFeedback. The file may leave out the
+  // fragment stage.
+  Shader(const std::string& filepath, const std::vector<std::string>& feedbackVaryings);
   ~Shader();
 
+  Shader(const Shader&) = delete;
+  Shader& operator=(const Shader&) = delete;
+  Shader(Shader&& other) noexcept;
+  Shader& operator=(Shader&& other) noexcept;
+
   void Bind() const;
   void UnBind() const;
 
+  void SetUniform1f(const std::string& name, float value);
+  void SetUniform2f(const std::string& name, float v0, float v1);
   void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
   void SetUniform1i(const std::string& name,unsigned int value);
   void SetUniform1iv(const std::string& name, int count, int* value);
   void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+  // Points a uniform block at an indexed GL_UNIFORM_BUFFER binding.
+  void SetUniformBlockBinding(const std::string& name, unsigned int binding);
 private:
   ShaderProgramSource ParseShader(const std::string& filepath);
   unsigned int CompileShader(unsigned int type, const std::string& source);
-  unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+  unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader,
+    const std::vector<std::string>& feedbackVaryings = {});
 
   unsigned int GetUniformLocation(const std::string& name);
 };
@@ -0,0 +1,130 @@
+#include "SpatialGrid.h"
+
+SpatialGrid::SpatialGrid(const glm::vec2& worldMin, const glm::vec2& worldMax, float cellSize)
+  : m_WorldMin(worldMin), m_InvCellSize(1.0f / cellSize), m_ProxyCount(0), m_MaxHalfExtent(0.0f)
+{
+  glm::vec2 size = worldMax - worldMin;
+  m_Columns = glm::max(1, (int)glm::ceil(size.x / cellSize));
+  m_Rows = glm::max(1, (int)glm::ceil(size.y / cellSize));
+  m_Cells.resize((size_t)m_Columns * m_Rows);
+}
+
+unsigned int SpatialGrid::Insert(const glm::vec2& min, const glm::vec2& max, unsigned int userData)
+{
+  unsigned int proxy;
+  if (!m_FreeProxies.empty())
+  {
+    proxy = m_FreeProxies.back();
+    m_FreeProxies.pop_back();
+  }
+  else
+  {
+    proxy = (unsigned int)m_Proxies.size();
+    m_Proxies.push_back({ InvalidProxy, 0 });
+  }
+
+  GrowExtent(min, max);
+  AddToCell(proxy, GetCell(min, max), { min, max, userData, proxy });
+  m_ProxyCount++;
+  return proxy;
+}
+
+void SpatialGrid::Update(unsigned int proxy, const glm::vec2& min, const glm::vec2& max)
+{
+  GrowExtent(min, max);
+
+  Proxy& p = m_Proxies[proxy];
+  unsigned int cell = GetCell(min, max);
+  Entry& entry = m_Cells[p.Cell][p.Slot];
+  if (cell == p.Cell)
+  {
+    entry.Min = min;
+    entry.Max = max;
+    return;
+  }
+
+  unsigned int userData = entry.UserData;
+  RemoveFromCell(proxy);
+  AddToCell(proxy, cell, { min, max, userData, proxy });
+}
+
+void SpatialGrid::Remove(unsigned int proxy)
+{
+  RemoveFromCell(proxy);
+  m_Proxies[proxy].Cell = InvalidProxy;
+  m_FreeProxies.push_back(proxy);
+  m_ProxyCount--;
+}
+
+void SpatialGrid::Clear()
+{
+  for (std::vector<Entry>& cell : m_Cells)
+    cell.clear();
+  m_Proxies.clear();
+  m_FreeProxies.clear();
+  m_ProxyCount = 0;
+  m_MaxHalfExtent = glm::vec2(0.0f);
+}
+
+unsigned int SpatialGrid::Query(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned int>& results) const
+{
+  size_t first = results.size();
+  Query(min, max, [&results](unsigned int userData) { results.push_back(userData); });
+  return (unsigned int)(results.size() - first);
+}
+
+SpatialGridStats SpatialGrid::GetStats() const
+{
+  SpatialGridStats stats = { m_ProxyCount, (unsigned int)m_Cells.size(), 0, 0 };
+  for (const std::vector<Entry>& cell : m_Cells)
+  {
+    if (!cell.empty())
+      stats.OccupiedCells++;
+    if (cell.size() > stats.LargestCell)
+      stats.LargestCell = (unsigned int)cell.size();
+  }
+  return stats;
+}
+
+unsigned int SpatialGrid::GetCell(const glm::vec2& min, const glm::vec2& max) const
+{
+  // anything outside the world is kept in the border cells
+  glm::vec2 cell = ((min + max) * 0.5f - m_WorldMin) * m_InvCellSize;
+  int x = glm::clamp((int)glm::floor(cell.x), 0, m_Columns - 1);
+  int y = glm::clamp((int)glm::floor(cell.y), 0, m_Rows - 1);
+  return (unsigned int)(y * m_Columns + x);
+}
+
+void SpatialGrid::GetCellRange(const glm::vec2& min, const glm::vec2& max, int& x0, int& y0, int& x1, int& y1) const
+{
+  glm::vec2 first = (min - m_WorldMin) * m_InvCellSize;
+  glm::vec2 last = (max - m_WorldMin) * m_InvCellSize;
+  x0 = glm::clamp((int)glm::floor(first.x), 0, m_Columns - 1);
+  y0 = glm::clamp((int)glm::floor(first.y), 0, m_Rows - 1);
+  x1 = glm::clamp((int)glm::floor(last.x), 0, m_Columns - 1);
+  y1 = glm::clamp((int)glm::floor(last.y), 0, m_Rows - 1);
+}
+
+void SpatialGrid::AddToCell(unsigned int proxy, unsigned int cell, const Entry& entry)
+{
+  std::vector<Entry>& entries = m_Cells[cell];
+  m_Proxies[proxy] = { cell, (unsigned int)entries.size() };
+  entries.push_back(entry);
+}
+
+void SpatialGrid::RemoveFromCell(unsigned int proxy)
+{
+  Proxy& p = m_Proxies[proxy];
+  std::vector<Entry>& entries = m_Cells[p.Cell];
+  if (p.Slot != entries.size() - 1)
+  {
+    entries[p.Slot] = entries.back();
+    m_Proxies[entries[p.Slot].Proxy].Slot = p.Slot;
+  }
+  entries.pop_back();
+}
+
+void SpatialGrid::GrowExtent(const glm::vec2& min, const glm::vec2& max)
+{
+  m_MaxHalfExtent = glm::max(m_MaxHalfExtent, (max - min) * 0.5f);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+
+#include "glm/glm.hpp"
+
+struct SpatialGridStats
+{
+  unsigned int ProxyCount;
+  unsigned int CellCount;
+  unsigned int OccupiedCells;
+  unsigned int LargestCell;
+};
+
+// Loose uniform grid for 2D AABBs. Each proxy lives in the one cell holding
+// the centre of its box, and queries grow their rect by the largest half
+// extent inserted so far. Moving a proxy inside its cell only rewrites its
+// box; crossing into another cell is a swap-remove and a push_back.
+//
+// Pick a cell size around a few times the typical object size. Objects much
+// larger than a cell still work but widen every query.
+//
+// Cells store the boxes themselves, so a query reads each visited cell as one
+// contiguous array.
+class SpatialGrid
+{
+public:
+  static const unsigned int InvalidProxy = 0xffffffff;
+
+  SpatialGrid(const glm::vec2& worldMin, const glm::vec2& worldMax, float cellSize);
+
+  // userData is what queries report, e.g. an index into the caller's array.
+  unsigned int Insert(const glm::vec2& min, const glm::vec2& max, unsigned int userData);
+  void Update(unsigned int proxy, const glm::vec2& min, const glm::vec2& max);
+  void Remove(unsigned int proxy);
+  void Clear();
+
+  // Appends the user data of every proxy whose box overlaps [min, max] and
+  // returns how many were added.
+  unsigned int Query(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned int>& results) const;
+
+  template<typename F>
+  void Query(const glm::vec2& min, const glm::vec2& max, F&& callback) const
+  {
+    int x0, y0, x1, y1;
+    GetCellRange(min - m_MaxHalfExtent, max + m_MaxHalfExtent, x0, y0, x1, y1);
+    for (int y = y0; y <= y1; y++)
+    {
+      for (int x = x0; x <= x1; x++)
+      {
+        for (const Entry& entry : m_Cells[y * m_Columns + x])
+        {
+          if (entry.Min.x <= max.x && entry.Max.x >= min.x && entry.Min.y <= max.y && entry.Max.y >= min.y)
+            callback(entry.UserData);
+        }
+      }
+    }
+  }
+
+  inline unsigned int GetProxyCount() const { return m_ProxyCount; }
+  SpatialGridStats GetStats() const;
+private:
+  struct Entry
+  {
+    glm::vec2 Min;
+    glm::vec2 Max;
+    unsigned int UserData;
+    unsigned int Proxy;
+  };
+
+  struct Proxy
+  {
+    // position in m_Cells[Cell]; Cell is InvalidProxy while on the free list
+    unsigned int Cell;
+    unsigned int Slot;
+  };
+
+  unsigned int GetCell(const glm::vec2& min, const glm::vec2& max) const;
+  void GetCellRange(const glm::vec2& min, const glm::vec2& max, int& x0, int& y0, int& x1, int& y1) const;
+  void AddToCell(unsigned int proxy, unsigned int cell, const Entry& entry);
+  void RemoveFromCell(unsigned int proxy);
+  void GrowExtent(const glm::vec2& min, const glm::vec2& max);
+
+  glm::vec2 m_WorldMin;
+  float m_InvCellSize;
+  int m_Columns, m_Rows;
+  std::vector<std::vector<Entry>> m_Cells;
+  std::vector<Proxy> m_Proxies;
+  std::vector<unsigned int> m_FreeProxies;
+  unsigned int m_ProxyCount;
+  glm::vec2 m_MaxHalfExtent;
+};
@@ -0,0 +1,255 @@
+#include "SpriteTransform.h"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #define SPRITE_TRANSFORM_X86 1
+  #include <emmintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+  #define SPRITE_TRANSFORM_NEON 1
+  #include <arm_neon.h>
+#endif
+
+static const float s_CornerX[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+static const float s_CornerY[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+void SpriteTransform::TransformScalar(const SpriteTransformInput& in, unsigned int begin, unsigned int end, const SpriteTransformOutput& out)
+{
+  for (unsigned int i = begin; i < end; i++)
+  {
+    float c = std::cos(in.Rotation[i]);
+    float s = std::sin(in.Rotation[i]);
+    for (int corner = 0; corner < 4; corner++)
+    {
+      float x = (s_CornerX[corner] - in.PivotX[i]) * in.ScaleX[i];
+      float y = (s_CornerY[corner] - in.PivotY[i]) * in.ScaleY[i];
+      out.X[corner][i] = in.PositionX[i] + c * x - s * y;
+      out.Y[corner][i] = in.PositionY[i] + s * x + c * y;
+    }
+  }
+}
+
+#ifdef SPRITE_TRANSFORM_X86
+// Cephes style sincos: reduce to [-pi/4, pi/4] by quadrant, evaluate both
+// polynomials, then swap and negate according to the quadrant.
+static inline void SinCosSSE2(__m128 x, __m128& sinOut, __m128& cosOut)
+{
+  __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.63661977236f)));
+  __m128 q = _mm_cvtepi32_ps(quadrant);
+  __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(1.5703125f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(4.837512969970703125e-4f)));
+  r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(7.54978995489188216e-8f)));
+  __m128 r2 = _mm_mul_ps(r, r);
+
+  __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2), _mm_set1_ps(8.3321608736e-3f));
+  s = _mm_add_ps(_mm_mul_ps(s, r2), _mm_set1_ps(-1.6666654611e-1f));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+
+  __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2), _mm_set1_ps(-1.388731625493765e-3f));
+  c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(4.166664568298827e-2f));
+  c = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(c, r2), r2), _mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(r2, _mm_set1_ps(0.5f))));
+
+  __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  __m128 sinValue = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+  __m128 cosValue = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+  // sin is negated in quadrants 2 and 3, cos in quadrants 1 and 2
+  __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+  __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+  sinOut = _mm_xor_ps(sinValue, sinSign);
+  cosOut = _mm_xor_ps(cosValue, cosSign);
+}
+
+void SpriteTransform::TransformSSE2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 s, c;
+    SinCosSSE2(_mm_loadu_ps(in.Rotation + i), s, c);
+
+    __m128 px = _mm_loadu_ps(in.PositionX + i), py = _mm_loadu_ps(in.PositionY + i);
+    __m128 sx = _mm_loadu_ps(in.ScaleX + i), sy = _mm_loadu_ps(in.ScaleY + i);
+    __m128 pivotX = _mm_loadu_ps(in.PivotX + i), pivotY = _mm_loadu_ps(in.PivotY + i);
+
+    // local corner offsets are either -pivot or 1 - pivot, scaled
+    __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), pivotX), sx);
+    __m128 x1 = _mm_add_ps(x0, sx);
+    __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), pivotY), sy);
+    __m128 y1 = _mm_add_ps(y0, sy);
+
+    __m128 cx0 = _mm_mul_ps(c, x0), cx1 = _mm_mul_ps(c, x1);
+    __m128 sx0 = _mm_mul_ps(s, x0), sx1 = _mm_mul_ps(s, x1);
+    __m128 cy0 = _mm_mul_ps(c, y0), cy1 = _mm_mul_ps(c, y1);
+    __m128 sy0 = _mm_mul_ps(s, y0), sy1 = _mm_mul_ps(s, y1);
+
+    _mm_storeu_ps(out.X[0] + i, _mm_add_ps(px, _mm_sub_ps(cx0, sy0)));
+    _mm_storeu_ps(out.Y[0] + i, _mm_add_ps(py, _mm_add_ps(sx0, cy0)));
+    _mm_storeu_ps(out.X[1] + i, _mm_add_ps(px, _mm_sub_ps(cx1, sy0)));
+    _mm_storeu_ps(out.Y[1] + i, _mm_add_ps(py, _mm_add_ps(sx1, cy0)));
+    _mm_storeu_ps(out.X[2] + i, _mm_add_ps(px, _mm_sub_ps(cx1, sy1)));
+    _mm_storeu_ps(out.Y[2] + i, _mm_add_ps(py, _mm_add_ps(sx1, cy1)));
+    _mm_storeu_ps(out.X[3] + i, _mm_add_ps(px, _mm_sub_ps(cx0, sy1)));
+    _mm_storeu_ps(out.Y[3] + i, _mm_add_ps(py, _mm_add_ps(sx0, cy1)));
+  }
+  TransformScalar(in, i, count, out);
+}
+
+static bool CpuHasAVX2()
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7)
+    return false;
+  __cpuid(info, 1);
+  bool fma = (info[2] & (1 << 12)) != 0;
+  bool osxsave = (info[2] & (1 << 27)) != 0;
+  bool avx = (info[2] & (1 << 28)) != 0;
+  if (!fma || !osxsave || !avx)
+    return false;
+  // the OS has to save the YMM registers on context switches
+  if ((_xgetbv(0) & 0x6) != 0x6)
+    return false;
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#else
+void SpriteTransform::TransformSSE2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  TransformScalar(in, 0, count, out);
+}
+#endif
+
+#ifdef SPRITE_TRANSFORM_NEON
+static inline void SinCosNEON(float32x4_t x, float32x4_t& sinOut, float32x4_t& cosOut)
+{
+  int32x4_t quadrant = vcvtnq_s32_f32(vmulq_n_f32(x, 0.63661977236f));
+  float32x4_t q = vcvtq_f32_s32(quadrant);
+  float32x4_t r = vmlsq_n_f32(x, q, 1.5703125f);
+  r = vmlsq_n_f32(r, q, 4.837512969970703125e-4f);
+  r = vmlsq_n_f32(r, q, 7.54978995489188216e-8f);
+  float32x4_t r2 = vmulq_f32(r, r);
+
+  float32x4_t s = vmlaq_n_f32(vdupq_n_f32(8.3321608736e-3f), r2, -1.9515295891e-4f);
+  s = vmlaq_f32(vdupq_n_f32(-1.6666654611e-1f), s, r2);
+  s = vmlaq_f32(r, vmulq_f32(s, r2), r);
+
+  float32x4_t c = vmlaq_n_f32(vdupq_n_f32(-1.388731625493765e-3f), r2, 2.443315711809948e-5f);
+  c = vmlaq_f32(vdupq_n_f32(4.166664568298827e-2f), c, r2);
+  c = vmlaq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), r2, 0.5f), vmulq_f32(c, r2), r2);
+
+  uint32x4_t swap = vceqq_s32(vandq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(1));
+  float32x4_t sinValue = vbslq_f32(swap, c, s);
+  float32x4_t cosValue = vbslq_f32(swap, s, c);
+
+  uint32x4_t sinSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(quadrant, vdupq_n_s32(2))), 30);
+  uint32x4_t cosSign = vshlq_n_u32(vreinterpretq_u32_s32(vandq_s32(vaddq_s32(quadrant, vdupq_n_s32(1)), vdupq_n_s32(2))), 30);
+  sinOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sinValue), sinSign));
+  cosOut = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cosValue), cosSign));
+}
+
+void SpriteTransform::TransformNEON(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t s, c;
+    SinCosNEON(vld1q_f32(in.Rotation + i), s, c);
+
+    float32x4_t px = vld1q_f32(in.PositionX + i), py = vld1q_f32(in.PositionY + i);
+    float32x4_t sx = vld1q_f32(in.ScaleX + i), sy = vld1q_f32(in.ScaleY + i);
+    float32x4_t x0 = vnegq_f32(vmulq_f32(vld1q_f32(in.PivotX + i), sx));
+    float32x4_t y0 = vnegq_f32(vmulq_f32(vld1q_f32(in.PivotY + i), sy));
+    float32x4_t x1 = vaddq_f32(x0, sx);
+    float32x4_t y1 = vaddq_f32(y0, sy);
+
+    float32x4_t xs[4] = { x0, x1, x1, x0 };
+    float32x4_t ys[4] = { y0, y0, y1, y1 };
+    for (int corner = 0; corner < 4; corner++)
+    {
+      vst1q_f32(out.X[corner] + i, vmlsq_f32(vmlaq_f32(px, c, xs[corner]), s, ys[corner]));
+      vst1q_f32(out.Y[corner] + i, vmlaq_f32(vmlaq_f32(py, s, xs[corner]), c, ys[corner]));
+    }
+  }
+  TransformScalar(in, i, count, out);
+}
+#else
+void SpriteTransform::TransformNEON(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  TransformScalar(in, 0, count, out);
+}
+#endif
+
+static bool DetectSupport(SimdLevel level)
+{
+  switch (level)
+  {
+  case SimdLevel::Scalar: return true;
+#ifdef SPRITE_TRANSFORM_X86
+  case SimdLevel::SSE2: return true;
+  case SimdLevel::AVX2: return CpuHasAVX2();
+#endif
+#ifdef SPRITE_TRANSFORM_NEON
+  case SimdLevel::NEON: return true;
+#endif
+  default: return false;
+  }
+}
+
+static SimdLevel DetectBestLevel()
+{
+  if (DetectSupport(SimdLevel::AVX2)) return SimdLevel::AVX2;
+  if (DetectSupport(SimdLevel::NEON)) return SimdLevel::NEON;
+  if (DetectSupport(SimdLevel::SSE2)) return SimdLevel::SSE2;
+  return SimdLevel::Scalar;
+}
+
+// set from the UI while jobs transform batches
+static std::atomic<SimdLevel> s_Level(DetectBestLevel());
+
+bool SpriteTransform::IsSupported(SimdLevel level)
+{
+  return DetectSupport(level);
+}
+
+SimdLevel SpriteTransform::GetSimdLevel()
+{
+  return s_Level.load(std::memory_order_relaxed);
+}
+
+void SpriteTransform::SetSimdLevel(SimdLevel level)
+{
+  s_Level.store(IsSupported(level) ? level : DetectBestLevel(), std::memory_order_relaxed);
+}
+
+const char* SpriteTransform::GetName(SimdLevel level)
+{
+  switch (level)
+  {
+  case SimdLevel::Scalar: return "Scalar";
+  case SimdLevel::SSE2: return "SSE2";
+  case SimdLevel::AVX2: return "AVX2";
+  case SimdLevel::NEON: return "NEON";
+  }
+  return "Unknown";
+}
+
+void SpriteTransform::Transform(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  switch (s_Level.load(std::memory_order_relaxed))
+  {
+  case SimdLevel::AVX2: TransformAVX2(in, count, out); break;
+  case SimdLevel::SSE2: TransformSSE2(in, count, out); break;
+  case SimdLevel::NEON: TransformNEON(in, count, out); break;
+  default: TransformScalar(in, 0, count, out); break;
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Structure-of-arrays sprite input, count entries per array. The pivot is in
+// unit quad space: (0, 0) is the bottom left corner, (0.5, 0.5) the center.
+struct SpriteTransformInput
+{
+  const float* PositionX;
+  const float* PositionY;
+  const float* ScaleX;
+  const float* ScaleY;
+  const float* Rotation;
+  const float* PivotX;
+  const float* PivotY;
+};
+
+// Transformed corners, one array per corner and axis (count entries each).
+// Corners go counter-clockwise from the bottom left, like the batch quads.
+struct SpriteTransformOutput
+{
+  float* X[4];
+  float* Y[4];
+};
+
+enum class SimdLevel
+{
+  Scalar, SSE2, AVX2, NEON
+};
+
+// 2D sprite transform kernel: scale, rotate around the pivot, translate.
+// Transform() dispatches at runtime to the widest instruction set the CPU
+// supports; the per-level entry points are public for testing and benchmarks.
+class SpriteTransform
+{
+public:
+  static void Transform(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out);
+
+  static void TransformScalar(const SpriteTransformInput& in, unsigned int begin, unsigned int end, const SpriteTransformOutput& out);
+  static void TransformSSE2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out);
+  static void TransformAVX2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out);
+  static void TransformNEON(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out);
+
+  static bool IsSupported(SimdLevel level);
+  static SimdLevel GetSimdLevel();
+  // Forces a level for comparisons; unsupported levels fall back to the best one.
+  static void SetSimdLevel(SimdLevel level);
+  static const char* GetName(SimdLevel level);
+};
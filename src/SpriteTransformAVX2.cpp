@@ -0,0 +1,86 @@
+// AVX2 + FMA variant of the sprite transform kernel. Kept in its own
+// translation unit so only this code is compiled for AVX2; it is only called
+// after SpriteTransform has checked the CPU supports it.
+#include "SpriteTransform.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC target("avx2,fma")
+#endif
+#include <immintrin.h>
+
+#if defined(__clang__)
+  #define AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+  #define AVX2_TARGET
+#endif
+
+AVX2_TARGET static inline void SinCosAVX2(__m256 x, __m256& sinOut, __m256& cosOut)
+{
+  __m256i quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(0.63661977236f)));
+  __m256 q = _mm256_cvtepi32_ps(quadrant);
+  __m256 r = _mm256_fnmadd_ps(q, _mm256_set1_ps(1.5703125f), x);
+  r = _mm256_fnmadd_ps(q, _mm256_set1_ps(4.837512969970703125e-4f), r);
+  r = _mm256_fnmadd_ps(q, _mm256_set1_ps(7.54978995489188216e-8f), r);
+  __m256 r2 = _mm256_mul_ps(r, r);
+
+  __m256 s = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), r2, _mm256_set1_ps(8.3321608736e-3f));
+  s = _mm256_fmadd_ps(s, r2, _mm256_set1_ps(-1.6666654611e-1f));
+  s = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+
+  __m256 c = _mm256_fmadd_ps(_mm256_set1_ps(2.443315711809948e-5f), r2, _mm256_set1_ps(-1.388731625493765e-3f));
+  c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(4.166664568298827e-2f));
+  c = _mm256_fmadd_ps(_mm256_mul_ps(c, r2), r2, _mm256_fnmadd_ps(r2, _mm256_set1_ps(0.5f), _mm256_set1_ps(1.0f)));
+
+  __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+  __m256 sinValue = _mm256_blendv_ps(s, c, swap);
+  __m256 cosValue = _mm256_blendv_ps(c, s, swap);
+
+  __m256 sinSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(2)), 30));
+  __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+  sinOut = _mm256_xor_ps(sinValue, sinSign);
+  cosOut = _mm256_xor_ps(cosValue, cosSign);
+}
+
+// 8 sprites per iteration
+AVX2_TARGET void SpriteTransform::TransformAVX2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 s, c;
+    SinCosAVX2(_mm256_loadu_ps(in.Rotation + i), s, c);
+
+    __m256 px = _mm256_loadu_ps(in.PositionX + i), py = _mm256_loadu_ps(in.PositionY + i);
+    __m256 sx = _mm256_loadu_ps(in.ScaleX + i), sy = _mm256_loadu_ps(in.ScaleY + i);
+    __m256 x0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(in.PivotX + i)), sx);
+    __m256 y0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(in.PivotY + i)), sy);
+    __m256 x1 = _mm256_add_ps(x0, sx);
+    __m256 y1 = _mm256_add_ps(y0, sy);
+
+    // x' = px + c*x - s*y, y' = py + s*x + c*y
+    __m256 sy0 = _mm256_mul_ps(s, y0), sy1 = _mm256_mul_ps(s, y1);
+    __m256 cy0 = _mm256_fmadd_ps(c, y0, py), cy1 = _mm256_fmadd_ps(c, y1, py);
+    __m256 cx0 = _mm256_fmadd_ps(c, x0, px), cx1 = _mm256_fmadd_ps(c, x1, px);
+
+    _mm256_storeu_ps(out.X[0] + i, _mm256_sub_ps(cx0, sy0));
+    _mm256_storeu_ps(out.Y[0] + i, _mm256_fmadd_ps(s, x0, cy0));
+    _mm256_storeu_ps(out.X[1] + i, _mm256_sub_ps(cx1, sy0));
+    _mm256_storeu_ps(out.Y[1] + i, _mm256_fmadd_ps(s, x1, cy0));
+    _mm256_storeu_ps(out.X[2] + i, _mm256_sub_ps(cx1, sy1));
+    _mm256_storeu_ps(out.Y[2] + i, _mm256_fmadd_ps(s, x1, cy1));
+    _mm256_storeu_ps(out.X[3] + i, _mm256_sub_ps(cx0, sy1));
+    _mm256_storeu_ps(out.Y[3] + i, _mm256_fmadd_ps(s, x0, cy1));
+  }
+  TransformScalar(in, i, count, out);
+}
+
+#else
+
+void SpriteTransform::TransformAVX2(const SpriteTransformInput& in, unsigned int count, const SpriteTransformOutput& out)
+{
+  TransformScalar(in, 0, count, out);
+}
+
+#endif
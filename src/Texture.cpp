@@ -1,5 +1,6 @@
 #include "Texture.h"
 
+#include "GLCapabilities.h"
 #include "stb_image/stb_image.h"
 Texture::Texture(const std::string& path)
   :m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
@@ -7,20 +8,48 @@ Texture::Texture(const std::string& path)
   stbi_set_flip_vertically_on_load(true);//תYᣬͼݴϽǿʼopengl½ǿʼ
   m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
 
-  glGenTextures(1, &m_RendererID);
-  glBindTexture(GL_TEXTURE_2D, m_RendererID);
+  Create(m_LocalBuffer);
+
+  if (m_LocalBuffer) {
+    stbi_image_free(m_LocalBuffer);
+  }
+}
+
+Texture::Texture(int width, int height, const void* data)
+  :m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4)
+{
+  Create(data);
+}
+
+void Texture::Create(const void* data)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    // immutable storage; leaves the texture bound to the active unit untouched
+    GLCall(glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID));
+    GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    if (m_Width > 0 && m_Height > 0)
+    {
+      GLCall(glTextureStorage2D(m_RendererID, 1, GL_RGBA8, m_Width, m_Height));
+      if (data)
+        GLCall(glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    }
+    return;
+  }
+
+  GLCall(glGenTextures(1, &m_RendererID));
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
 
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
   GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
 
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  if (m_LocalBuffer) {
-    stbi_image_free(m_LocalBuffer);
-  }
+  GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
 }
 
 Texture::~Texture()
@@ -28,12 +57,53 @@ Texture::~Texture()
   glDeleteTextures(1, &m_RendererID);
 }
 
+Texture::Texture(Texture&& other) noexcept
+  :m_RendererID(other.m_RendererID), m_FilePath(std::move(other.m_FilePath)), m_LocalBuffer(nullptr),
+  m_Width(other.m_Width), m_Height(other.m_Height), m_BPP(other.m_BPP)
+{
+  other.m_RendererID = 0;
+}
+
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteTextures(1, &m_RendererID);
+    m_RendererID = other.m_RendererID;
+    m_FilePath = std::move(other.m_FilePath);
+    m_Width = other.m_Width;
+    m_Height = other.m_Height;
+    m_BPP = other.m_BPP;
+    other.m_RendererID = 0;
+  }
+  return *this;
+}
+
 void Texture::Bind(unsigned int slot) const
 {
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    glBindTextureUnit(slot, m_RendererID);
+    return;
+  }
+
   glActiveTexture(GL_TEXTURE0 + slot);
   glBindTexture(GL_TEXTURE_2D, m_RendererID);
 }
 
+void Texture::SetData(int x, int y, int width, int height, const void* data)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glTextureSubImage2D(m_RendererID, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+    return;
+  }
+
+  GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+  GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data));
+  GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+}
+
 void Texture::UnBind()
 {
   GLCall(glBindTexture(GL_TEXTURE_2D, 0));
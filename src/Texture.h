@@ -8,12 +8,23 @@ class Texture
   int m_Width, m_Height, m_BPP;
 public:
   Texture(const std::string& path);
+  Texture(int width, int height, const void* data);
   ~Texture();
 
+  Texture(const Texture&) = delete;
+  Texture& operator=(const Texture&) = delete;
+  Texture(Texture&& other) noexcept;
+  Texture& operator=(Texture&& other) noexcept;
+
   void Bind(unsigned int slot = 0)const;
+  // Replaces a width x height block of RGBA8 pixels at (x, y).
+  void SetData(int x, int y, int width, int height, const void* data);
   void UnBind();
 
   inline int GetWidth() const { return m_Width; }
   inline int GetHeight() const { return m_Height; }
+private:
+  // Creates the GL texture and uploads m_Width x m_Height RGBA8 pixels.
+  void Create(const void* data);
 };
 
@@ -0,0 +1,205 @@
+#include "Tilemap.h"
+#include "BatchRenderer.h"
+#include "FrameAllocator.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static constexpr unsigned int s_ChunkTiles = Tilemap::ChunkSize * Tilemap::ChunkSize;
+
+// Frame data handed to Draw(): in the frame arena when the render thread runs
+// it later, otherwise in a scratch vector reused every frame.
+template<typename T>
+static T* AllocateFrameArray(std::vector<T>& scratch, size_t count)
+{
+  if (Renderer::IsRenderThreadRunning())
+    return BufferedFrameAllocator::Get().GetCurrent().AllocateArray<T>(count);
+  scratch.resize(count);
+  return scratch.data();
+}
+
+Tilemap::Tilemap(unsigned int width, unsigned int height, float tileSize)
+  : m_Width(width), m_Height(height), m_ChunksX((width + ChunkSize - 1) / ChunkSize),
+  m_ChunksY((height + ChunkSize - 1) / ChunkSize), m_TileSize(tileSize), m_Tiles((size_t)width * height, 0),
+  m_Chunks((size_t)m_ChunksX * m_ChunksY), m_Tileset(nullptr), m_TilesetColumns(1), m_TilesetRows(1),
+  m_InstanceBuffer(m_ChunksX * m_ChunksY * s_ChunkTiles * (unsigned int)sizeof(TileInstance)),
+  m_Shader("res/shaders/Tilemap.shader")
+{
+  std::vector<unsigned int> indices = BatchRenderer::GenerateQuadIndices(1);
+  m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+
+  m_ChunkArrays.resize(m_Chunks.size());
+  for (size_t i = 0; i < m_ChunkArrays.size(); i++)
+  {
+    m_ChunkArrays[i] = std::make_unique<VertexArray>();
+    m_ChunkArrays[i]->AddBuffer<TileInstance>(m_InstanceBuffer, 1, (unsigned int)(i * s_ChunkTiles * sizeof(TileInstance)));
+  }
+
+  m_Shader.Bind();
+  m_Shader.SetUniform1i("u_Tileset", 0);
+  m_Shader.SetUniform1f("u_ChunkSize", (float)ChunkSize);
+}
+
+Tilemap::~Tilemap()
+{
+}
+
+void Tilemap::SetTileset(const Texture* tileset, unsigned int columns, unsigned int rows)
+{
+  m_Tileset = tileset;
+  m_TilesetColumns = columns;
+  m_TilesetRows = rows;
+}
+
+void Tilemap::SetTile(unsigned int x, unsigned int y, unsigned short tile)
+{
+  ASSERT(x < m_Width && y < m_Height);
+  unsigned short& current = m_Tiles[(size_t)y * m_Width + x];
+  if (current == tile)
+    return;
+  current = tile;
+  m_Chunks[(y / ChunkSize) * m_ChunksX + x / ChunkSize].Dirty = true;
+}
+
+void Tilemap::SetTiles(const std::vector<unsigned short>& tiles)
+{
+  ASSERT(tiles.size() == m_Tiles.size());
+  m_Tiles = tiles;
+  InvalidateAll();
+}
+
+void Tilemap::InvalidateAll()
+{
+  for (Chunk& chunk : m_Chunks)
+    chunk.Dirty = true;
+}
+
+glm::ivec2 Tilemap::WorldToTile(const glm::vec2& position) const
+{
+  return glm::ivec2(glm::floor(position / m_TileSize));
+}
+
+unsigned int Tilemap::Bake(unsigned int chunk, TileInstance* instances) const
+{
+  unsigned int originX = (chunk % m_ChunksX) * ChunkSize, originY = (chunk / m_ChunksX) * ChunkSize;
+  unsigned int width = std::min(ChunkSize, m_Width - originX), height = std::min(ChunkSize, m_Height - originY);
+
+  unsigned int count = 0;
+  for (unsigned int y = 0; y < height; y++)
+  {
+    const unsigned short* row = &m_Tiles[(size_t)(originY + y) * m_Width + originX];
+    for (unsigned int x = 0; x < width; x++)
+    {
+      if (row[x] != 0)
+        instances[count++] = { (unsigned short)(y * ChunkSize + x), row[x] };
+    }
+  }
+  return count;
+}
+
+void Tilemap::Render(const glm::mat4& viewProj)
+{
+  m_Stats = TilemapStats();
+  if (!m_Tileset)
+    return;
+
+  auto start = std::chrono::steady_clock::now();
+
+  // world rect under the viewport, in chunks
+  glm::mat4 inverse = glm::inverse(viewProj);
+  glm::vec2 min(INFINITY), max(-INFINITY);
+  for (glm::vec2 corner : { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f) })
+  {
+    glm::vec4 position = inverse * glm::vec4(corner, 0.0f, 1.0f);
+    min = glm::min(min, glm::vec2(position) / position.w);
+    max = glm::max(max, glm::vec2(position) / position.w);
+  }
+  glm::vec2 chunkCount((float)m_ChunksX, (float)m_ChunksY);
+  float chunkWorldSize = ChunkSize * m_TileSize;
+  glm::ivec2 first(glm::clamp(glm::floor(min / chunkWorldSize), glm::vec2(0.0f), chunkCount));
+  glm::ivec2 last(glm::clamp(glm::floor(max / chunkWorldSize), glm::vec2(-1.0f), chunkCount - 1.0f));
+  if (first.x > last.x || first.y > last.y)
+    return;
+  m_Stats.VisibleChunks = (last.x - first.x + 1) * (last.y - first.y + 1);
+
+  std::vector<unsigned int>& bakes = m_BakeList;
+  bakes.clear();
+  for (int y = first.y; y <= last.y; y++)
+  {
+    for (int x = first.x; x <= last.x; x++)
+    {
+      unsigned int chunk = y * m_ChunksX + x;
+      if (!m_Chunks[chunk].Dirty)
+        continue;
+      if (bakes.size() < MaxBakesPerFrame)
+        bakes.push_back(chunk);
+      else
+        m_Stats.PendingChunks++;
+    }
+  }
+
+  unsigned int bakeCount = (unsigned int)bakes.size();
+  TileInstance* instances = AllocateFrameArray(m_BakeScratch, (size_t)bakeCount * s_ChunkTiles);
+  ChunkUpload* uploads = AllocateFrameArray(m_UploadScratch, bakeCount);
+  JobSystem::ParallelFor(bakeCount, 4, [this, &bakes, instances, uploads](unsigned int begin, unsigned int end) {
+    for (unsigned int i = begin; i < end; i++)
+    {
+      Chunk& chunk = m_Chunks[bakes[i]];
+      TileInstance* chunkInstances = instances + (size_t)i * s_ChunkTiles;
+      chunk.InstanceCount = Bake(bakes[i], chunkInstances);
+      chunk.Dirty = false;
+      uploads[i] = { bakes[i], chunkInstances, chunk.InstanceCount };
+    }
+  });
+  m_Stats.BakedChunks = bakeCount;
+
+  ChunkDraw* draws = AllocateFrameArray(m_DrawScratch, m_Stats.VisibleChunks);
+  unsigned int drawCount = 0;
+  for (int y = first.y; y <= last.y; y++)
+  {
+    for (int x = first.x; x <= last.x; x++)
+    {
+      unsigned int chunk = y * m_ChunksX + x;
+      if (m_Chunks[chunk].InstanceCount == 0)
+        continue;
+      draws[drawCount++] = { chunk, m_Chunks[chunk].InstanceCount };
+      m_Stats.DrawnTiles += m_Chunks[chunk].InstanceCount;
+    }
+  }
+  m_Stats.BakeTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  Renderer::Submit([this, uploads, bakeCount, draws, drawCount, viewProj]() {
+    Draw(uploads, bakeCount, draws, drawCount, viewProj);
+  });
+}
+
+void Tilemap::Draw(const ChunkUpload* uploads, unsigned int uploadCount, const ChunkDraw* draws, unsigned int drawCount,
+  const glm::mat4& viewProj)
+{
+  // each chunk's range is only rewritten when it was baked
+  for (unsigned int i = 0; i < uploadCount; i++)
+  {
+    if (uploads[i].Count > 0)
+      m_InstanceBuffer.SetSubData(uploads[i].Chunk * s_ChunkTiles * sizeof(TileInstance), uploads[i].Instances,
+        uploads[i].Count * sizeof(TileInstance));
+  }
+  if (drawCount == 0)
+    return;
+
+  m_Tileset->Bind(0);
+  m_Shader.Bind();
+  m_Shader.SetUniformMat4f("u_ViewProj", viewProj);
+  m_Shader.SetUniform1f("u_TileSize", m_TileSize);
+  m_Shader.SetUniform2f("u_TilesetSize", (float)m_TilesetColumns, (float)m_TilesetRows);
+  m_Shader.SetUniform2f("u_TexelInset", 0.5f / m_Tileset->GetWidth(), 0.5f / m_Tileset->GetHeight());
+
+  Renderer renderer;
+  for (unsigned int i = 0; i < drawCount; i++)
+  {
+    unsigned int chunk = draws[i].Chunk;
+    m_Shader.SetUniform2f("u_ChunkOrigin", (float)((chunk % m_ChunksX) * ChunkSize), (float)((chunk / m_ChunksX) * ChunkSize));
+    renderer.DrawInstanced(*m_ChunkArrays[chunk], *m_IndexBuffer, m_Shader, draws[i].Count);
+  }
+}
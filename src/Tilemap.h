@@ -0,0 +1,123 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "glm/glm.hpp"
+
+// One non-empty tile of a baked chunk, drawn as an instanced quad.
+struct TileInstance
+{
+  // y * ChunkSize + x within the chunk
+  unsigned short Cell;
+  unsigned short Tile;
+};
+VERTEX_LAYOUT(TileInstance, Cell, Tile);
+
+struct TilemapStats
+{
+  unsigned int VisibleChunks = 0;
+  unsigned int DrawnTiles = 0;
+  // chunks baked this frame, and dirty visible ones left for the next frames
+  unsigned int BakedChunks = 0;
+  unsigned int PendingChunks = 0;
+  // milliseconds, main thread
+  float BakeTime = 0.0f;
+};
+
+// Tile map split into ChunkSize x ChunkSize chunks. Every chunk owns a fixed
+// range of one instance buffer, baked from its tiles into one TileInstance
+// per non-empty tile. SetTile() only marks the chunk dirty; Render() rebakes
+// the dirty chunks the camera sees (at most MaxBakesPerFrame of them, the
+// rest keep their old contents for a frame or two) and draws the visible
+// chunks with one instanced draw each. Chunks off screen are neither baked
+// nor drawn, so a large map costs what is on screen plus what changed.
+//
+// Tile 0 is empty; tile t is cell t - 1 of the tileset, counted row by row
+// from the top left. Tile (0, 0) covers [0, tileSize) in world units, y up.
+class Tilemap
+{
+public:
+  static constexpr unsigned int ChunkSize = 64;
+  static constexpr unsigned int MaxBakesPerFrame = 256;
+
+  Tilemap(unsigned int width, unsigned int height, float tileSize);
+  ~Tilemap();
+
+  Tilemap(const Tilemap&) = delete;
+  Tilemap& operator=(const Tilemap&) = delete;
+
+  // columns x rows tiles of equal size; the texture must outlive the map
+  void SetTileset(const Texture* tileset, unsigned int columns, unsigned int rows);
+
+  inline unsigned short GetTile(unsigned int x, unsigned int y) const { return m_Tiles[(size_t)y * m_Width + x]; }
+  void SetTile(unsigned int x, unsigned int y, unsigned short tile);
+  // Writes a whole map without marking chunks one tile at a time.
+  void SetTiles(const std::vector<unsigned short>& tiles);
+  // For comparisons: rebake every visible chunk each frame.
+  void InvalidateAll();
+
+  // Out-of-range positions give tiles outside the map.
+  glm::ivec2 WorldToTile(const glm::vec2& position) const;
+  inline bool Contains(const glm::ivec2& tile) const
+  {
+    return tile.x >= 0 && tile.y >= 0 && tile.x < (int)m_Width && tile.y < (int)m_Height;
+  }
+
+  // viewProj must be a 2D projection (no perspective); the visible chunks
+  // are found from its inverse.
+  void Render(const glm::mat4& viewProj);
+
+  inline unsigned int GetWidth() const { return m_Width; }
+  inline unsigned int GetHeight() const { return m_Height; }
+  inline float GetTileSize() const { return m_TileSize; }
+  inline const TilemapStats& GetStats() const { return m_Stats; }
+private:
+  struct Chunk
+  {
+    unsigned int InstanceCount = 0;
+    bool Dirty = true;
+  };
+  // GL thread work for one frame, in the frame arena
+  struct ChunkUpload
+  {
+    unsigned int Chunk;
+    const TileInstance* Instances;
+    unsigned int Count;
+  };
+  struct ChunkDraw
+  {
+    unsigned int Chunk;
+    unsigned int Count;
+  };
+
+  unsigned int Bake(unsigned int chunk, TileInstance* instances) const;
+  void Draw(const ChunkUpload* uploads, unsigned int uploadCount, const ChunkDraw* draws, unsigned int drawCount,
+    const glm::mat4& viewProj);
+
+  unsigned int m_Width, m_Height;
+  unsigned int m_ChunksX, m_ChunksY;
+  float m_TileSize;
+  std::vector<unsigned short> m_Tiles;
+  std::vector<Chunk> m_Chunks;
+
+  std::vector<unsigned int> m_BakeList;
+  std::vector<TileInstance> m_BakeScratch;
+  std::vector<ChunkUpload> m_UploadScratch;
+  std::vector<ChunkDraw> m_DrawScratch;
+
+  const Texture* m_Tileset;
+  unsigned int m_TilesetColumns, m_TilesetRows;
+  TilemapStats m_Stats;
+
+  VertexBuffer m_InstanceBuffer;
+  // one per chunk, reading its range of m_InstanceBuffer
+  std::vector<std::unique_ptr<VertexArray>> m_ChunkArrays;
+  std::unique_ptr<IndexBuffer> m_IndexBuffer;
+  Shader m_Shader;
+};
@@ -1,9 +1,14 @@
 #include "VertexArray.h"
 #include "Renderer.h"
 #include "VertexBufferLayout.h"
+#include "GLCapabilities.h"
 VertexArray::VertexArray()
+  : m_AttributeCount(0), m_BindingCount(0)
 {
-  glGenVertexArrays(1, &m_RendererID);
+  if (GLCapabilities::HasDirectStateAccess())
+    glCreateVertexArrays(1, &m_RendererID);
+  else
+    glGenVertexArrays(1, &m_RendererID);
 }
 
 VertexArray::~VertexArray()
@@ -11,21 +16,77 @@ VertexArray::~VertexArray()
   glDeleteVertexArrays(1, &m_RendererID);
 }
 
-void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
+VertexArray::VertexArray(VertexArray&& other) noexcept
+  : m_RendererID(other.m_RendererID), m_AttributeCount(other.m_AttributeCount), m_BindingCount(other.m_BindingCount)
 {
-  Bind();
-  vb.Bind();
+  other.m_RendererID = 0;
+  other.m_AttributeCount = 0;
+  other.m_BindingCount = 0;
+}
+
+VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteVertexArrays(1, &m_RendererID);
+    m_RendererID = other.m_RendererID;
+    m_AttributeCount = other.m_AttributeCount;
+    m_BindingCount = other.m_BindingCount;
+    other.m_RendererID = 0;
+    other.m_AttributeCount = 0;
+    other.m_BindingCount = 0;
+  }
+  return *this;
+}
+
+void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int divisor)
+{
+  unsigned int binding = BeginBuffer(vb, layout.GetStride(), divisor);
   const auto& elements = layout.GetElements();
   unsigned int offset = 0;
   for (unsigned int i = 0; i < elements.size(); i++)
   {
     const auto& element = elements[i];
+    AddAttribute(binding, element.type, element.count, element.normalized, layout.GetStride(), offset, divisor);
+    offset += element.count*VertexBufferElement::GetSizeOfType(element.type);
+  }
+}
 
-    glEnableVertexAttribArray(i);
-    glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(),(const void*) offset);
+unsigned int VertexArray::BeginBuffer(const VertexBuffer& vb, unsigned int stride, unsigned int divisor, unsigned int bufferOffset)
+{
+  // one binding point per buffer; with DSA the currently bound VAO and VBO are left alone
+  unsigned int binding = m_BindingCount++;
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glVertexArrayVertexBuffer(m_RendererID, binding, vb.GetRendererID(), bufferOffset, stride));
+    if (divisor)
+      GLCall(glVertexArrayBindingDivisor(m_RendererID, binding, divisor));
+  }
+  else
+  {
+    Bind();
+    vb.Bind();
+  }
+  return binding;
+}
 
-    offset += element.count*VertexBufferElement::GetSizeOfType(element.type);
+void VertexArray::AddAttribute(unsigned int binding, unsigned int type, unsigned int count, bool normalized,
+  unsigned int stride, unsigned int offset, unsigned int divisor, unsigned int bufferOffset)
+{
+  unsigned int index = m_AttributeCount++;
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glEnableVertexArrayAttrib(m_RendererID, index));
+    GLCall(glVertexArrayAttribFormat(m_RendererID, index, count, type, normalized, offset));
+    GLCall(glVertexArrayAttribBinding(m_RendererID, index, binding));
+    return;
   }
+
+  glEnableVertexAttribArray(index);
+  // without separate bindings the buffer offset is part of every attribute pointer
+  glVertexAttribPointer(index, count, type, normalized, stride, (const void*)(size_t)(bufferOffset + offset));
+  if (divisor)
+    glVertexAttribDivisor(index, divisor);
 }
 
 void VertexArray::Bind() const
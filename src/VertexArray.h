@@ -1,5 +1,6 @@
 #pragma once
 #include "VertexBuffer.h"
+#include "VertexLayout.h"
 
 class VertexBufferLayout;
 
@@ -9,11 +10,38 @@ public:
 	VertexArray();
 	~VertexArray();
 
-	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+	VertexArray(const VertexArray&) = delete;
+	VertexArray& operator=(const VertexArray&) = delete;
+	VertexArray(VertexArray&& other) noexcept;
+	VertexArray& operator=(VertexArray&& other) noexcept;
+
+	// Attributes are numbered after those of previously added buffers. A
+	// divisor of 1 makes the buffer per-instance data.
+	void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout, unsigned int divisor = 0);
+	// Same, with the layout of a struct declared through VERTEX_LAYOUT; no
+	// layout object is built at runtime. bufferOffset lets the same buffer be
+	// added again shifted, e.g. by one element to read neighbours.
+	template<typename Vertex>
+	void AddBuffer(const VertexBuffer& vb, unsigned int divisor = 0, unsigned int bufferOffset = 0)
+	{
+		constexpr std::array<VertexAttribute, VertexLayoutOf<Vertex>::Count> attributes = VertexLayoutOf<Vertex>::Attributes();
+		unsigned int binding = BeginBuffer(vb, VertexLayoutOf<Vertex>::Stride, divisor, bufferOffset);
+		for (const VertexAttribute& attribute : attributes)
+			AddAttribute(binding, attribute.Type, attribute.Count, attribute.Normalized, VertexLayoutOf<Vertex>::Stride,
+				attribute.Offset, divisor, bufferOffset);
+	}
 	void Bind() const;
 	void Unbind() const;
 private:
+	// Returns the binding point for vb (only meaningful with DSA).
+	unsigned int BeginBuffer(const VertexBuffer& vb, unsigned int stride, unsigned int divisor, unsigned int bufferOffset = 0);
+	void AddAttribute(unsigned int binding, unsigned int type, unsigned int count, bool normalized,
+		unsigned int stride, unsigned int offset, unsigned int divisor, unsigned int bufferOffset = 0);
+
 	unsigned int m_RendererID;
+	unsigned int m_AttributeCount;
+	// vertex buffer binding points used so far
+	unsigned int m_BindingCount;
 };
 
 
@@ -1,17 +1,118 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
+#include "GLCapabilities.h"
+
+VertexBuffer::VertexBuffer(const void* data, unsigned int size)
+  : m_Size(size)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glCreateBuffers(1, &m_RendererID));
+    GLCall(glNamedBufferData(m_RendererID, size, data, GL_STATIC_DRAW));
+    return;
+  }
 
-VertexBuffer::VertexBuffer(const void* data, unsigned int size) {
   glGenBuffers(1, &m_RendererID);
   glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
   glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+  : m_Size(size)
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glCreateBuffers(1, &m_RendererID));
+    GLCall(glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW));
+    return;
+  }
+
+  GLCall(glGenBuffers(1, &m_RendererID));
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+VertexBuffer::VertexBuffer(VertexBuffer&& other) noexcept
+  : m_RendererID(other.m_RendererID), m_Size(other.m_Size)
+{
+  other.m_RendererID = 0;
+  other.m_Size = 0;
+}
+
+VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    glDeleteBuffers(1, &m_RendererID);
+    m_RendererID = other.m_RendererID;
+    m_Size = other.m_Size;
+    other.m_RendererID = 0;
+    other.m_Size = 0;
+  }
+  return *this;
+}
+
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+  ASSERT(size <= m_Size);
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glNamedBufferData(m_RendererID, m_Size, nullptr, GL_DYNAMIC_DRAW));
+    GLCall(glNamedBufferSubData(m_RendererID, 0, size, data));
+    return;
+  }
+
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  // orphan the old storage so the driver doesn't have to wait for draws still reading it
+  GLCall(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW));
+  GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+}
+
+void VertexBuffer::SetSubData(unsigned int offset, const void* data, unsigned int size)
+{
+  ASSERT(offset + size <= m_Size);
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glNamedBufferSubData(m_RendererID, offset, size, data));
+    return;
+  }
+
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLCall(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+}
+
 VertexBuffer::~VertexBuffer()
 {
   GLCall(glDeleteBuffers(1, &m_RendererID));
 }
 
+void* VertexBuffer::Map(unsigned int size)
+{
+  ASSERT(size <= m_Size);
+  void* data;
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(data = glMapNamedBufferRange(m_RendererID, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    return data;
+  }
+
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLCall(data = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+  return data;
+}
+
+void VertexBuffer::Unmap()
+{
+  if (GLCapabilities::HasDirectStateAccess())
+  {
+    GLCall(glUnmapNamedBuffer(m_RendererID));
+    return;
+  }
+
+  GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+  GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+}
+
 void VertexBuffer::Bind() const
 {
   GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
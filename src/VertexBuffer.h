@@ -3,11 +3,30 @@ class VertexBuffer
 {
 private:
 	unsigned int m_RendererID;
+	unsigned int m_Size;
 public:
 	VertexBuffer(const void* data, unsigned int size);
+	VertexBuffer(unsigned int size);
 	~VertexBuffer();
 
+	// Owns the GL name: move-only, a moved-from buffer holds 0.
+	VertexBuffer(const VertexBuffer&) = delete;
+	VertexBuffer& operator=(const VertexBuffer&) = delete;
+	VertexBuffer(VertexBuffer&& other) noexcept;
+	VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
+	void SetData(const void* data, unsigned int size);
+	// Updates a range in place, without orphaning.
+	void SetSubData(unsigned int offset, const void* data, unsigned int size);
+	// Orphans the buffer and maps the first size bytes for writing. The
+	// pointer may be written from any thread until Unmap().
+	void* Map(unsigned int size);
+	void Unmap();
+
 	void Bind() const;
 	void Unbind() const;
+
+	inline unsigned int GetSize() const { return m_Size; }
+	inline unsigned int GetRendererID() const { return m_RendererID; }
 };
 
@@ -19,6 +19,16 @@ struct VertexBufferElement
     return 0;
   }
 };
+
+// GL type of a Push<T>() component. Specialised at namespace scope (in-class
+// explicit specialisations are an MSVC extension); other types don't compile.
+template<typename T>
+struct VertexElementType;
+
+template<> struct VertexElementType<float> { static constexpr unsigned int Type = GL_FLOAT; static constexpr bool Normalized = false; };
+template<> struct VertexElementType<unsigned int> { static constexpr unsigned int Type = GL_UNSIGNED_INT; static constexpr bool Normalized = false; };
+template<> struct VertexElementType<unsigned char> { static constexpr unsigned int Type = GL_UNSIGNED_BYTE; static constexpr bool Normalized = true; };
+
 class VertexBufferLayout
 {
 private:
@@ -31,31 +41,40 @@ public:
   template<typename T>
   void Push(unsigned int count)
   {
-   static_assert(false);
+    m_Elements.push_back({ VertexElementType<T>::Type, count, VertexElementType<T>::Normalized });
+    m_Stride += VertexBufferElement::GetSizeOfType(VertexElementType<T>::Type) * count;
   }
 
-  template<>
-  void Push<float>(unsigned int count)
-  {
-    m_Elements.push_back({ GL_FLOAT, count, GL_FALSE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_FLOAT) * count;
-  }
+  inline const std::vector<VertexBufferElement>& GetElements() const { return m_Elements; }
+  inline unsigned int GetStride() const { return (unsigned int)m_Stride; }
 
-  template<>
-  void Push<unsigned int>(unsigned int count)
+  // FNV-1a over the elements and stride, for interning (see VertexFormat)
+  size_t GetHash() const
   {
-    m_Elements.push_back({ GL_UNSIGNED_INT, count, GL_FALSE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_INT) * count;
+    unsigned long long hash = 14695981039346656037ull;
+    auto mix = [&hash](unsigned int value) { hash = (hash ^ value) * 1099511628211ull; };
+    for (const VertexBufferElement& element : m_Elements)
+    {
+      mix(element.type);
+      mix(element.count);
+      mix(element.normalized);
+    }
+    mix((unsigned int)m_Stride);
+    return (size_t)hash;
   }
 
-  template<>
-  void Push<unsigned char>(unsigned int count)
+  bool operator==(const VertexBufferLayout& other) const
   {
-    m_Elements.push_back({ GL_UNSIGNED_BYTE, count, GL_TRUE });
-    m_Stride += VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE) * count;
+    if (m_Stride != other.m_Stride || m_Elements.size() != other.m_Elements.size())
+      return false;
+    for (size_t i = 0; i < m_Elements.size(); i++)
+    {
+      const VertexBufferElement& a = m_Elements[i];
+      const VertexBufferElement& b = other.m_Elements[i];
+      if (a.type != b.type || a.count != b.count || a.normalized != b.normalized)
+        return false;
+    }
+    return true;
   }
-
-  inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
-  inline unsigned int GetStride() const { return m_Stride; }
 };
 
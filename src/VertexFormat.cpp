@@ -0,0 +1,146 @@
+#include "VertexFormat.h"
+#include "Renderer.h"
+#include "GLCapabilities.h"
+
+#include <unordered_map>
+
+static std::unordered_map<size_t, std::vector<std::unique_ptr<VertexFormat>>> s_Cache;
+
+const VertexFormat& VertexFormat::Get(const VertexBufferLayout& layout)
+{
+  return Intern({ layout });
+}
+
+const VertexFormat& VertexFormat::Get(const VertexBufferLayout& vertexLayout, const VertexBufferLayout& instanceLayout)
+{
+  return Intern({ vertexLayout, instanceLayout });
+}
+
+const VertexFormat& VertexFormat::Intern(const std::vector<VertexBufferLayout>& layouts)
+{
+  size_t hash = layouts.size();
+  for (const VertexBufferLayout& layout : layouts)
+    hash = hash * 31 + layout.GetHash();
+
+  // equal hashes still have to match layout by layout
+  std::vector<std::unique_ptr<VertexFormat>>& bucket = s_Cache[hash];
+  for (const std::unique_ptr<VertexFormat>& format : bucket)
+  {
+    if (format->m_Layouts == layouts)
+      return *format;
+  }
+  bucket.push_back(std::unique_ptr<VertexFormat>(new VertexFormat(layouts)));
+  return *bucket.back();
+}
+
+void VertexFormat::ClearCache()
+{
+  s_Cache.clear();
+}
+
+unsigned int VertexFormat::GetCacheSize()
+{
+  unsigned int count = 0;
+  for (const auto& bucket : s_Cache)
+    count += (unsigned int)bucket.second.size();
+  return count;
+}
+
+VertexFormat::VertexFormat(const std::vector<VertexBufferLayout>& layouts)
+  : m_Layouts(layouts), m_SeparateFormat(GLCapabilities::HasVertexAttribBinding())
+{
+  bool dsa = GLCapabilities::HasDirectStateAccess();
+  if (dsa)
+    GLCall(glCreateVertexArrays(1, &m_RendererID));
+  else
+    GLCall(glGenVertexArrays(1, &m_RendererID));
+
+  unsigned int attribute = 0;
+  for (unsigned int binding = 0; binding < m_Layouts.size(); binding++)
+  {
+    m_FirstAttribute.push_back(attribute);
+    const auto& elements = m_Layouts[binding].GetElements();
+    if (!m_SeparateFormat)
+    {
+      // 3.3: pointers are set in BindVertexBuffer, only the divisor is fixed
+      Bind();
+      for (unsigned int i = 0; i < elements.size(); i++)
+      {
+        GLCall(glEnableVertexAttribArray(attribute + i));
+        if (binding)
+          GLCall(glVertexAttribDivisor(attribute + i, 1));
+      }
+      attribute += (unsigned int)elements.size();
+      continue;
+    }
+
+    if (!dsa)
+      Bind();
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < elements.size(); i++, attribute++)
+    {
+      const auto& element = elements[i];
+      if (dsa)
+      {
+        GLCall(glEnableVertexArrayAttrib(m_RendererID, attribute));
+        GLCall(glVertexArrayAttribFormat(m_RendererID, attribute, element.count, element.type, element.normalized, offset));
+        GLCall(glVertexArrayAttribBinding(m_RendererID, attribute, binding));
+      }
+      else
+      {
+        GLCall(glEnableVertexAttribArray(attribute));
+        GLCall(glVertexAttribFormat(attribute, element.count, element.type, element.normalized, offset));
+        GLCall(glVertexAttribBinding(attribute, binding));
+      }
+      offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+    }
+    if (binding)
+    {
+      if (dsa)
+        GLCall(glVertexArrayBindingDivisor(m_RendererID, binding, 1));
+      else
+        GLCall(glVertexBindingDivisor(binding, 1));
+    }
+  }
+}
+
+VertexFormat::~VertexFormat()
+{
+  glDeleteVertexArrays(1, &m_RendererID);
+}
+
+void VertexFormat::Bind() const
+{
+  GLCall(glBindVertexArray(m_RendererID));
+}
+
+void VertexFormat::BindVertexBuffer(const VertexBuffer& vb, unsigned int binding, unsigned int offset) const
+{
+  ASSERT(binding < m_Layouts.size());
+  const VertexBufferLayout& layout = m_Layouts[binding];
+
+  if (m_SeparateFormat)
+  {
+    if (GLCapabilities::HasDirectStateAccess())
+    {
+      GLCall(glVertexArrayVertexBuffer(m_RendererID, binding, vb.GetRendererID(), offset, layout.GetStride()));
+    }
+    else
+    {
+      Bind();
+      GLCall(glBindVertexBuffer(binding, vb.GetRendererID(), offset, layout.GetStride()));
+    }
+    return;
+  }
+
+  Bind();
+  vb.Bind();
+  const auto& elements = layout.GetElements();
+  for (unsigned int i = 0; i < elements.size(); i++)
+  {
+    const auto& element = elements[i];
+    GLCall(glVertexAttribPointer(m_FirstAttribute[binding] + i, element.count, element.type, element.normalized,
+      layout.GetStride(), (const void*)(size_t)offset));
+    offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+  }
+}
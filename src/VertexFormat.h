@@ -0,0 +1,48 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+
+// An interned vertex layout with its own VAO. Meshes that share a layout
+// share the VAO and only swap the buffer feeding it:
+//
+//   const VertexFormat& format = VertexFormat::Get(layout);
+//   format.BindVertexBuffer(mesh.VertexBuffer);
+//   renderer.Draw(format, mesh.IndexBuffer, shader);
+//
+// With GL 4.3 / ARB_vertex_attrib_binding the attribute formats are set up
+// once and a switch is a single glBindVertexBuffer. On plain 3.3 the VAO is
+// still shared, but switching buffers has to re-point the attributes.
+class VertexFormat
+{
+public:
+  // Binding 0 holds per-vertex data, binding 1 (if any) per-instance data.
+  static const VertexFormat& Get(const VertexBufferLayout& layout);
+  static const VertexFormat& Get(const VertexBufferLayout& vertexLayout, const VertexBufferLayout& instanceLayout);
+  // Destroys every cached format; call on the GL thread before the context goes away.
+  static void ClearCache();
+  static unsigned int GetCacheSize();
+
+  ~VertexFormat();
+
+  VertexFormat(const VertexFormat&) = delete;
+  VertexFormat& operator=(const VertexFormat&) = delete;
+
+  void Bind() const;
+  // Attaches vb to a binding point of this format, starting offset bytes in.
+  void BindVertexBuffer(const VertexBuffer& vb, unsigned int binding = 0, unsigned int offset = 0) const;
+
+  inline const std::vector<VertexBufferLayout>& GetLayouts() const { return m_Layouts; }
+private:
+  VertexFormat(const std::vector<VertexBufferLayout>& layouts);
+
+  static const VertexFormat& Intern(const std::vector<VertexBufferLayout>& layouts);
+
+  unsigned int m_RendererID;
+  std::vector<VertexBufferLayout> m_Layouts;
+  // first attribute index of each binding
+  std::vector<unsigned int> m_FirstAttribute;
+  bool m_SeparateFormat;
+};
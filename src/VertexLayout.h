@@ -0,0 +1,120 @@
+#pragma once
+#include <array>
+#include <cstddef>
+
+#include <glad/glad.h>
+#include "glm/glm.hpp"
+
+// Compile-time vertex layouts derived from vertex structs:
+//
+//   struct QuadVertex { glm::vec3 Position; glm::vec4 Color; glm::vec2 TexCoord; float TexIndex; };
+//   VERTEX_LAYOUT(QuadVertex, Position, Color, TexCoord, TexIndex);
+//   ...
+//   vao.AddBuffer<QuadVertex>(vertexBuffer);
+//
+// GL type, component count and offset of every attribute are computed from
+// the member types. The offsets are accumulated from the member sizes and
+// checked against offsetof/sizeof, so a reordered, padded or forgotten
+// member is a compile error rather than garbage on screen.
+
+struct VertexAttribute
+{
+  unsigned int Type;
+  unsigned int Count;
+  bool Normalized;
+  unsigned int Size;
+  unsigned int Offset;
+};
+
+// GL description of a member type; only the specialisations below exist.
+template<typename T>
+struct VertexAttributeType;
+
+template<> struct VertexAttributeType<float> { static constexpr unsigned int Type = GL_FLOAT, Count = 1; static constexpr bool Normalized = false; };
+template<> struct VertexAttributeType<glm::vec2> { static constexpr unsigned int Type = GL_FLOAT, Count = 2; static constexpr bool Normalized = false; };
+template<> struct VertexAttributeType<glm::vec3> { static constexpr unsigned int Type = GL_FLOAT, Count = 3; static constexpr bool Normalized = false; };
+template<> struct VertexAttributeType<glm::vec4> { static constexpr unsigned int Type = GL_FLOAT, Count = 4; static constexpr bool Normalized = false; };
+template<> struct VertexAttributeType<unsigned int> { static constexpr unsigned int Type = GL_UNSIGNED_INT, Count = 1; static constexpr bool Normalized = false; };
+// small indices, read as exact floats
+template<> struct VertexAttributeType<unsigned short> { static constexpr unsigned int Type = GL_UNSIGNED_SHORT, Count = 1; static constexpr bool Normalized = false; };
+// packed RGBA8 colour, read as normalised floats
+template<> struct VertexAttributeType<glm::u8vec4> { static constexpr unsigned int Type = GL_UNSIGNED_BYTE, Count = 4; static constexpr bool Normalized = true; };
+
+template<typename T>
+constexpr VertexAttribute MakeVertexAttribute()
+{
+  return { VertexAttributeType<T>::Type, VertexAttributeType<T>::Count, VertexAttributeType<T>::Normalized, (unsigned int)sizeof(T), 0 };
+}
+
+// Fills in the offsets of tightly packed attributes.
+template<size_t N>
+constexpr std::array<VertexAttribute, N> PackVertexAttributes(std::array<VertexAttribute, N> attributes)
+{
+  unsigned int offset = 0;
+  for (size_t i = 0; i < N; i++)
+  {
+    attributes[i].Offset = offset;
+    offset += attributes[i].Size;
+  }
+  return attributes;
+}
+
+template<size_t N>
+constexpr bool VertexOffsetsMatch(const std::array<VertexAttribute, N>& attributes, const std::array<size_t, N>& offsets)
+{
+  for (size_t i = 0; i < N; i++)
+  {
+    if (attributes[i].Offset != offsets[i])
+      return false;
+  }
+  return true;
+}
+
+template<size_t N>
+constexpr size_t VertexStride(const std::array<VertexAttribute, N>& attributes)
+{
+  return N ? attributes[N - 1].Offset + attributes[N - 1].Size : 0;
+}
+
+// Specialised by VERTEX_LAYOUT; provides Attributes() and Stride.
+template<typename Vertex>
+struct VertexLayoutOf;
+
+// Variadic for-each over the member names (up to 8). The EXPAND wrappers
+// keep MSVC's traditional preprocessor from passing __VA_ARGS__ as one token.
+#define VL_EXPAND(x) x
+#define VL_ATTRIBUTE(Vertex, member) MakeVertexAttribute<decltype(Vertex::member)>()
+#define VL_OFFSET(Vertex, member) offsetof(Vertex, member)
+#define VL_FOR_1(F, V, a) F(V, a)
+#define VL_FOR_2(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_1(F, V, __VA_ARGS__))
+#define VL_FOR_3(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_2(F, V, __VA_ARGS__))
+#define VL_FOR_4(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_3(F, V, __VA_ARGS__))
+#define VL_FOR_5(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_4(F, V, __VA_ARGS__))
+#define VL_FOR_6(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_5(F, V, __VA_ARGS__))
+#define VL_FOR_7(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_6(F, V, __VA_ARGS__))
+#define VL_FOR_8(F, V, a, ...) F(V, a), VL_EXPAND(VL_FOR_7(F, V, __VA_ARGS__))
+#define VL_COUNT(...) VL_EXPAND(VL_COUNT_N(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1))
+#define VL_COUNT_N(_1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define VL_CONCAT(a, b) VL_CONCAT_(a, b)
+#define VL_CONCAT_(a, b) a##b
+#define VL_FOR_EACH(F, V, ...) VL_EXPAND(VL_CONCAT(VL_FOR_, VL_COUNT(__VA_ARGS__))(F, V, __VA_ARGS__))
+
+#define VERTEX_LAYOUT(Vertex, ...) \
+  template<> \
+  struct VertexLayoutOf<Vertex> \
+  { \
+    static constexpr size_t Count = VL_COUNT(__VA_ARGS__); \
+    static constexpr std::array<VertexAttribute, Count> Attributes() \
+    { \
+      return PackVertexAttributes(std::array<VertexAttribute, Count>{ { VL_FOR_EACH(VL_ATTRIBUTE, Vertex, __VA_ARGS__) } }); \
+    } \
+    static constexpr std::array<size_t, Count> MemberOffsets() \
+    { \
+      return { { VL_FOR_EACH(VL_OFFSET, Vertex, __VA_ARGS__) } }; \
+    } \
+    static constexpr unsigned int Stride = (unsigned int)sizeof(Vertex); \
+  }; \
+  static_assert(VertexStride(VertexLayoutOf<Vertex>::Attributes()) == sizeof(Vertex), \
+    #Vertex ": layout does not cover the whole struct (missing member or padding)"); \
+  static_assert(VertexOffsetsMatch(VertexLayoutOf<Vertex>::Attributes(), VertexLayoutOf<Vertex>::MemberOffsets()), \
+    #Vertex ": members are not listed in declaration order or are padded")
@@ -1,4 +1,5 @@
 #include "Test.h"
+#include "Renderer.h"
 #include "imgui/imgui.h"
 namespace test {
 
@@ -17,7 +18,8 @@ namespace test {
     for (auto& test:m_Tests)
     {
       if (ImGui::Button(test.first.c_str())) {
-        m_CurrentTest = test.second();
+        // constructors create GL objects, so they have to run on the GL thread
+        Renderer::SubmitAndWait([&]() { m_CurrentTest = test.second(); });
       }
     }
   }
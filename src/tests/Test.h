@@ -12,9 +12,16 @@ public:
   Test() {}
   virtual ~Test(){}
 
+  virtual void OnFixedUpdate(float fixedDeltaTime){}
   virtual void OnUpdate(float deltaTime){}
-  virtual void OnRender(){}
+  // alpha: fraction of a fixed step since the last OnFixedUpdate, for interpolating simulated state
+  virtual void OnRender(float alpha){}
   virtual void OnImGuiRender(){}
+
+  // True when OnRender only issues GL work through Renderer::Submit with
+  // captured state, so the render thread can draw it while the next frame is
+  // simulated. Other tests are rendered synchronously in render thread mode.
+  virtual bool SupportsRenderThread() const { return false; }
 };
 
 
@@ -25,12 +32,14 @@ public:
 	~TestMenu ();
 
    void OnImGuiRender() override;
+   bool SupportsRenderThread() const override { return true; }
 
    template <typename T>
    void RegisterTest(const std::string& name) {
      std::cout << "Register test: " << name << std::endl;
      m_Tests.push_back(std::make_pair(name, []()  {return new T(); }));
    }
+   inline const std::vector < std::pair< std::string, std::function<Test*()>>>& GetTests() const { return m_Tests; }
 private:
   Test*& m_CurrentTest;
   std::vector < std::pair< std::string, std::function<Test*()>>> m_Tests;
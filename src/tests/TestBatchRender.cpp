@@ -7,55 +7,51 @@
 
 namespace test
 {
-  TestBatchRender::TestBatchRender()
-    :m_Proj(glm::ortho(0.0f, 640.0f, 0.0f, 480.0f, -1.0f, 1.0f)),
-    m_View(glm::translate(glm::mat4(1.0f), glm::vec3(-100, 0, 0))),
-    m_Translation(glm::vec3(0, 0, 0))
-  {
-    float positions[] = {
-        100.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
-        200.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f,
-        200.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f,
-        100.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+  static const float s_Positions[] = {
+      100.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+      200.0f, 100.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f,
+      200.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f,
+      100.0f, 200.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
 
-        300.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-        400.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f,
-        400.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
-        300.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+      300.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+      400.0f, 100.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f,
+      400.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+      300.0f, 200.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
 
-    };
+  };
 
-    unsigned int indices[] = {
-        0, 1, 2, 2, 3, 0,
-        4, 5, 6, 6, 7, 4
-    };
+  static const unsigned int s_Indices[] = {
+      0, 1, 2, 2, 3, 0,
+      4, 5, 6, 6, 7, 4
+  };
 
+  TestBatchRender::TestBatchRender()
+    :m_IndexBuffer(s_Indices, 12),
+    m_VertexBuffer(s_Positions, 11 * 8 * sizeof(float)),
+    m_Shader("res/shaders/Batch.shader"),
+    m_Texture{ Texture("res/textures/ChernoLogo.png"), Texture("res/textures/HazelLogo.png") },
+    m_Proj(glm::ortho(0.0f, 640.0f, 0.0f, 480.0f, -1.0f, 1.0f)),
+    m_View(glm::translate(glm::mat4(1.0f), glm::vec3(-100, 0, 0))),
+    m_Translation(glm::vec3(0, 0, 0))
+  {
     GLCall(glEnable(GL_BLEND));
     GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
-    m_VAO = std::make_unique<VertexArray>();
-
-    m_VertexBuffer = std::make_unique<VertexBuffer>(positions, 11 * 8 * sizeof(float));
     VertexBufferLayout layout;
     layout.Push<float>(4); //  x, y, z, w  w , xyz
     layout.Push<float>(4); // ɫ
     layout.Push<float>(2); // 
     layout.Push<float>(1); // 
-    m_VAO->AddBuffer(*m_VertexBuffer, layout);
-
-    m_IndexBuffer = std::make_unique<IndexBuffer>(indices, 12);
+    m_VAO.AddBuffer(m_VertexBuffer, layout);
 
-    m_Shader = std::make_unique<Shader>("res/shaders/Batch.shader");
-    m_Shader->Bind();
+    m_Shader.Bind();
 
-    m_Texture[0] = std::make_unique<Texture>("res/textures/ChernoLogo.png");
-    m_Texture[1] = std::make_unique<Texture>("res/textures/HazelLogo.png");
     for (size_t i = 0; i < 2; i++)
     {
-      m_Texture[i]->Bind(i);
+      m_Texture[i].Bind(i);
     }
     int samplers[2] = { 0, 1 };
-    m_Shader->SetUniform1iv("u_Textures", 2, samplers);
+    m_Shader.SetUniform1iv("u_Textures", 2, samplers);
   }
 
   TestBatchRender::~TestBatchRender()
@@ -66,7 +62,7 @@ namespace test
   {
   }
 
-  void TestBatchRender::OnRender()
+  void TestBatchRender::OnRender(float alpha)
   {
     GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
     GLCall(glClear(GL_COLOR_BUFFER_BIT));
@@ -74,10 +70,10 @@ namespace test
     Renderer renderer; // ÿ֡rendererҪһ
     glm::mat4 mvp = m_Proj * m_View;
 
-    m_Shader->Bind();
-    m_Shader->SetUniformMat4f("u_MVP", mvp);
+    m_Shader.Bind();
+    m_Shader.SetUniformMat4f("u_MVP", mvp);
 
-    renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+    renderer.Draw(m_VAO, m_IndexBuffer, m_Shader);
   }
 
   void TestBatchRender::OnImGuiRender()
@@ -5,19 +5,17 @@
 #include "VertexBufferLayout.h"
 #include "Texture.h"
 
-#include <memory>
-
 namespace test
 {
 
   class TestBatchRender : public Test
   {
   private:
-    std::unique_ptr<VertexArray> m_VAO;
-    std::unique_ptr<IndexBuffer> m_IndexBuffer;
-    std::unique_ptr<VertexBuffer> m_VertexBuffer;
-    std::unique_ptr<Shader> m_Shader;
-    std::unique_ptr<Texture> m_Texture[2];
+    VertexArray m_VAO;
+    IndexBuffer m_IndexBuffer;
+    VertexBuffer m_VertexBuffer;
+    Shader m_Shader;
+    Texture m_Texture[2];
 
     glm::mat4 m_Proj, m_View;
     glm::vec3 m_Translation;
@@ -27,7 +25,7 @@ namespace test
     ~TestBatchRender();
 
     void OnUpdate(float deltaTime) override;
-    void OnRender() override;
+    void OnRender(float alpha) override;
     void OnImGuiRender() override;
   };
 }
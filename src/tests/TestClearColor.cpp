@@ -18,10 +18,13 @@ void TestClearColor::OnUpdate(float deltaTime)
 
 }
 
-void TestClearColor::OnRender()
+void TestClearColor::OnRender(float alpha)
 {
-  glClearColor(m_ClearColor[0], m_ClearColor[1], m_ClearColor[2], m_ClearColor[3]);
-  glClear(GL_COLOR_BUFFER_BIT);
+  float r = m_ClearColor[0], g = m_ClearColor[1], b = m_ClearColor[2], a = m_ClearColor[3];
+  Renderer::Submit([=]() {
+    glClearColor(r, g, b, a);
+    glClear(GL_COLOR_BUFFER_BIT);
+  });
 }
 
 void TestClearColor::OnImGuiRender()
@@ -8,8 +8,9 @@ public:
   TestClearColor();
   ~TestClearColor();
   void OnUpdate(float deltaTime) override;
-  void OnRender()override;
+  void OnRender(float alpha) override;
   void OnImGuiRender() override;
+  bool SupportsRenderThread() const override { return true; }
 
 private:
   float m_ClearColor[4];
@@ -0,0 +1,134 @@
+#include "TestGeometryPool.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+  static const unsigned int s_MaxMeshes = 30000;
+  static const unsigned int s_MaxSides = 24;
+
+  static VertexBufferLayout PositionLayout()
+  {
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    return layout;
+  }
+
+  TestGeometryPool::TestGeometryPool()
+    // sized for the average polygon; heavy churn at the top end will fail some allocations
+    : m_Pool(PositionLayout(), s_MaxMeshes * 16, s_MaxMeshes * 3 * 15, s_MaxMeshes),
+    m_Shader("res/shaders/FlatColor.shader"), m_Random(5), m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 720.0f, -1.0f, 1.0f)),
+    m_MeshCount(2000), m_Churn(20), m_PendingChurn(0), m_MeshCountChanged(false), m_FailedAllocations(0)
+  {
+    SetMeshCount(m_MeshCount);
+  }
+
+  TestGeometryPool::~TestGeometryPool()
+  {
+  }
+
+  bool TestGeometryPool::AddMesh()
+  {
+    std::uniform_int_distribution<unsigned int> sides(3, s_MaxSides);
+    std::uniform_real_distribution<float> x(0.0f, 960.0f), y(0.0f, 720.0f), radius(3.0f, 10.0f), channel(0.2f, 1.0f);
+
+    // triangle fan around a centre vertex
+    unsigned int count = sides(m_Random);
+    glm::vec2 center(x(m_Random), y(m_Random));
+    float r = radius(m_Random);
+    glm::vec2 vertices[s_MaxSides + 1];
+    unsigned int indices[s_MaxSides * 3];
+    vertices[0] = center;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      float angle = 6.2831853f * i / count;
+      vertices[i + 1] = center + r * glm::vec2(glm::cos(angle), glm::sin(angle));
+      indices[i * 3 + 0] = 0;
+      indices[i * 3 + 1] = i + 1;
+      indices[i * 3 + 2] = (i + 1) % count + 1;
+    }
+
+    GeometryHandle handle = m_Pool.Allocate(vertices, count + 1, indices, count * 3);
+    if (!handle.IsValid())
+    {
+      m_FailedAllocations++;
+      return false;
+    }
+    m_Meshes.push_back({ handle, glm::vec4(channel(m_Random), channel(m_Random), channel(m_Random), 1.0f) });
+    return true;
+  }
+
+  void TestGeometryPool::RemoveMesh(size_t index)
+  {
+    m_Pool.Free(m_Meshes[index].Handle);
+    m_Meshes[index] = m_Meshes.back();
+    m_Meshes.pop_back();
+  }
+
+  void TestGeometryPool::SetMeshCount(int count)
+  {
+    while ((int)m_Meshes.size() > count)
+      RemoveMesh(m_Meshes.size() - 1);
+    while ((int)m_Meshes.size() < count && AddMesh())
+      ;
+  }
+
+  void TestGeometryPool::OnUpdate(float deltaTime)
+  {
+    m_PendingChurn += m_Churn;
+  }
+
+  void TestGeometryPool::OnRender(float alpha)
+  {
+    // allocations upload to the pool's buffers, so they happen here rather
+    // than in OnUpdate/OnImGuiRender, which have no context with the render thread on
+    if (m_MeshCountChanged)
+    {
+      SetMeshCount(m_MeshCount);
+      m_MeshCountChanged = false;
+    }
+    for (; m_PendingChurn > 0 && !m_Meshes.empty(); m_PendingChurn--)
+    {
+      RemoveMesh(m_Random() % m_Meshes.size());
+      AddMesh();
+    }
+    m_PendingChurn = 0;
+
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    m_Shader.Bind();
+    m_Shader.SetUniformMat4f("u_MVP", m_Proj);
+    m_Pool.Bind();
+    for (const Mesh& mesh : m_Meshes)
+    {
+      m_Shader.SetUniform4f("u_Color", mesh.Color.r, mesh.Color.g, mesh.Color.b, mesh.Color.a);
+      m_Pool.Draw(mesh.Handle, m_Shader);
+    }
+  }
+
+  void TestGeometryPool::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Meshes", &m_MeshCount, 100, s_MaxMeshes, "%d", ImGuiSliderFlags_Logarithmic))
+      m_MeshCountChanged = true;
+    ImGui::SliderInt("Churn/frame", &m_Churn, 0, 1000, "%d", ImGuiSliderFlags_Logarithmic);
+
+    GeometryPoolStats stats = m_Pool.GetStats();
+    ImGui::Separator();
+    ImGui::Text("Meshes: %u  failed allocations: %u", stats.MeshCount, m_FailedAllocations);
+    ImGui::Text("Vertices: %u / %u (%.1f%%)", stats.UsedVertices, stats.VertexCapacity, 100.0f * stats.UsedVertices / stats.VertexCapacity);
+    ImGui::Text("  free regions %u, largest %u, fragmentation %.1f%%", stats.VertexReport.FreeRegions,
+      stats.VertexReport.LargestFree, 100.0f * stats.VertexReport.GetFragmentation());
+    ImGui::Text("Indices:  %u / %u (%.1f%%)", stats.UsedIndices, stats.IndexCapacity, 100.0f * stats.UsedIndices / stats.IndexCapacity);
+    ImGui::Text("  free regions %u, largest %u, fragmentation %.1f%%", stats.IndexReport.FreeRegions,
+      stats.IndexReport.LargestFree, 100.0f * stats.IndexReport.GetFragmentation());
+
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u, GL buffers: 2, VAOs: 1", renderStats.DrawCalls);
+  }
+}
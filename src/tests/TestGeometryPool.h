@@ -0,0 +1,48 @@
+#pragma once
+#include "Test.h"
+#include "GeometryPool.h"
+#include "Shader.h"
+
+#include "glm/glm.hpp"
+
+#include <random>
+#include <vector>
+
+namespace test
+{
+  // Thousands of small polygon meshes sub-allocated from one GeometryPool and
+  // drawn with base-vertex draws from a single VAO. Churn frees and
+  // re-allocates meshes every frame to show how the allocator fragments.
+  class TestGeometryPool : public Test
+  {
+  public:
+    TestGeometryPool();
+    ~TestGeometryPool();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+  private:
+    struct Mesh
+    {
+      GeometryHandle Handle;
+      glm::vec4 Color;
+    };
+
+    bool AddMesh();
+    void RemoveMesh(size_t index);
+    void SetMeshCount(int count);
+
+    GeometryPool m_Pool;
+    Shader m_Shader;
+    std::vector<Mesh> m_Meshes;
+    std::mt19937 m_Random;
+    glm::mat4 m_Proj;
+    int m_MeshCount;
+    int m_Churn;
+    // applied in OnRender, the only part that runs on the GL thread
+    int m_PendingChurn;
+    bool m_MeshCountChanged;
+    unsigned int m_FailedAllocations;
+  };
+}
@@ -0,0 +1,120 @@
+#include "TestGpuParticles.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+
+namespace test
+{
+  static const glm::vec2 s_ViewSize(960.0f, 720.0f);
+  static const unsigned int s_Capacities[] = { 1u << 22, 1u << 23, 1u << 24, 1u << 25 };
+  static const char* s_CapacityNames[] = { "4M (192 MB)", "8M (384 MB)", "16M (768 MB)", "32M (1.5 GB)" };
+  static const int s_EmitterCount = 8;
+  static const float s_LifetimeMin = 2.5f, s_LifetimeMax = 3.5f;
+
+  TestGpuParticles::TestGpuParticles()
+    : m_Proj(glm::ortho(0.0f, s_ViewSize.x, 0.0f, s_ViewSize.y, -1.0f, 1.0f)), m_CapacityIndex(2), m_TargetCount(10000000),
+    m_Time(0.0f), m_UpdateTime(0.0f)
+  {
+    CreateParticles(s_Capacities[m_CapacityIndex]);
+  }
+
+  TestGpuParticles::~TestGpuParticles()
+  {
+  }
+
+  void TestGpuParticles::CreateParticles(unsigned int capacity)
+  {
+    m_Particles = std::make_unique<GpuParticleSystem>(capacity);
+    for (int i = 0; i < s_EmitterCount; i++)
+    {
+      ParticleEmitter emitter;
+      emitter.Position = { s_ViewSize.x * (i + 0.5f) / s_EmitterCount, 40.0f };
+      emitter.HalfExtent = { 4.0f, 2.0f };
+      emitter.Spread = 0.2f;
+      emitter.SpeedMin = 350.0f;
+      emitter.SpeedMax = 600.0f;
+      emitter.LifetimeMin = s_LifetimeMin;
+      emitter.LifetimeMax = s_LifetimeMax;
+      m_Particles->AddEmitter(emitter);
+    }
+    ParticleModules& modules = m_Particles->GetModules();
+    modules.Gravity = { 0.0f, -220.0f };
+    modules.Drag = 0.4f;
+    modules.StartColor = { 1.0f, 0.7f, 0.25f, 0.5f };
+    modules.EndColor = { 0.6f, 0.1f, 0.4f, 0.0f };
+    modules.StartSize = 0.75f;
+    modules.EndSize = 0.5f;
+    UpdateEmitters();
+  }
+
+  void TestGpuParticles::UpdateEmitters()
+  {
+    // live count = rate * average lifetime once births and deaths balance
+    for (unsigned int i = 0; i < m_Particles->GetEmitterCount(); i++)
+    {
+      ParticleEmitter& emitter = m_Particles->GetEmitter(i);
+      float lifetime = (emitter.LifetimeMin + emitter.LifetimeMax) * 0.5f;
+      emitter.Rate = m_TargetCount / (lifetime * s_EmitterCount);
+    }
+  }
+
+  void TestGpuParticles::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+    for (unsigned int i = 0; i < m_Particles->GetEmitterCount(); i++)
+      m_Particles->GetEmitter(i).Direction = 1.5707963f + 0.4f * glm::sin(m_Time * 0.6f + i * 0.9f);
+
+    auto start = std::chrono::steady_clock::now();
+    m_Particles->Update(deltaTime);
+    m_UpdateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void TestGpuParticles::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.02f, 0.02f, 0.04f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+    m_Particles->Render(m_Proj);
+  }
+
+  void TestGpuParticles::OnImGuiRender()
+  {
+    if (ImGui::Combo("Capacity", &m_CapacityIndex, s_CapacityNames, IM_ARRAYSIZE(s_CapacityNames)))
+    {
+      // on the GL thread, after the commands still using the old buffers
+      Renderer::SubmitAndWait([this]() {
+        m_Particles.reset();
+        CreateParticles(s_Capacities[m_CapacityIndex]);
+      });
+    }
+    // the window spans the longest lifetime, so the live count has to leave room for it
+    int maxTarget = (int)(m_Particles->GetCapacity() * (s_LifetimeMin + s_LifetimeMax) * 0.5f / s_LifetimeMax);
+    if (ImGui::SliderInt("Target particles", &m_TargetCount, 10000, maxTarget, "%d", ImGuiSliderFlags_Logarithmic))
+      UpdateEmitters();
+
+    ParticleModules& modules = m_Particles->GetModules();
+    ImGui::SliderFloat2("Gravity", &modules.Gravity.x, -500.0f, 500.0f);
+    ImGui::SliderFloat("Drag", &modules.Drag, 0.0f, 4.0f);
+    ImGui::ColorEdit4("Start color", &modules.StartColor.x);
+    ImGui::ColorEdit4("End color", &modules.EndColor.x);
+    ImGui::SliderFloat("Start size", &modules.StartSize, 0.25f, 8.0f);
+    ImGui::SliderFloat("End size", &modules.EndSize, 0.25f, 8.0f);
+    if (ImGui::Button("Clear"))
+      m_Particles->Clear();
+
+    GpuParticleStats stats = m_Particles->GetStats();
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("Window: %u / %u slots  (+%u this frame, %u overwritten)", stats.Window, m_Particles->GetCapacity(),
+      stats.Spawned, stats.Overwritten);
+    ImGui::Text("GPU update: %.2f ms  draw: %.2f ms", stats.UpdateGpuTime, stats.RenderGpuTime);
+    ImGui::Text("CPU update: %.3f ms", m_UpdateTime);
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u", renderStats.DrawCalls);
+  }
+}
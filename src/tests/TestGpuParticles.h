@@ -0,0 +1,35 @@
+#pragma once
+#include "Test.h"
+#include "GpuParticleSystem.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+
+namespace test
+{
+  // The CPU particle fountains scaled up to tens of millions of particles
+  // simulated with transform feedback. The CPU only decides how many to
+  // spawn; the capacity can be changed to see where the GPU runs out.
+  class TestGpuParticles : public Test
+  {
+  public:
+    TestGpuParticles();
+    ~TestGpuParticles();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    void CreateParticles(unsigned int capacity);
+    void UpdateEmitters();
+
+    std::unique_ptr<GpuParticleSystem> m_Particles;
+    glm::mat4 m_Proj;
+    int m_CapacityIndex;
+    int m_TargetCount;
+    float m_Time;
+    float m_UpdateTime;
+  };
+}
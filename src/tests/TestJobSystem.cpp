@@ -0,0 +1,95 @@
+#include "TestJobSystem.h"
+#include "JobSystem.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace test
+{
+  TestJobSystem::TestJobSystem()
+    : m_ElementCount(1 << 20), m_ChunkSize(4096), m_Iterations(32)
+  {
+  }
+
+  TestJobSystem::~TestJobSystem()
+  {
+  }
+
+  float TestJobSystem::RunWorkload()
+  {
+    m_Data.resize(m_ElementCount);
+    int iterations = m_Iterations;
+
+    auto start = std::chrono::steady_clock::now();
+    JobSystem::ParallelFor((unsigned int)m_ElementCount, (unsigned int)m_ChunkSize, [this, iterations](unsigned int begin, unsigned int end) {
+      for (unsigned int i = begin; i < end; i++)
+      {
+        float x = (float)i * 0.001f;
+        for (int n = 0; n < iterations; n++)
+          x = std::sin(x) * 0.5f + std::sqrt(x * x + 1.0f);
+        m_Data[i] = x;
+      }
+    });
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void TestJobSystem::RunBenchmark()
+  {
+    // nothing else may use the pool while it is being rebuilt
+    Renderer::SubmitAndWait([]() {});
+
+    m_Results.clear();
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0)
+      maxThreads = 1;
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+      JobSystem::Shutdown();
+      JobSystem::Initialize(threads - 1);
+      if (JobSystem::GetThreadCount() != threads)
+        break;
+
+      RunWorkload(); // warm up
+      float best = RunWorkload();
+      for (int i = 0; i < 2; i++)
+      {
+        float time = RunWorkload();
+        if (time < best)
+          best = time;
+      }
+      m_Results.push_back({ threads, best });
+    }
+
+    JobSystem::Shutdown();
+    JobSystem::Initialize();
+  }
+
+  void TestJobSystem::OnImGuiRender()
+  {
+    ImGui::SliderInt("Elements", &m_ElementCount, 1 << 14, 1 << 24, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderInt("Iterations/element", &m_Iterations, 1, 256, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderInt("Chunk size", &m_ChunkSize, 64, 1 << 18, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::Text("Job system threads: %u", JobSystem::GetThreadCount());
+
+    if (ImGui::Button("Run scaling benchmark"))
+      RunBenchmark();
+
+    if (m_Results.empty())
+      return;
+
+    std::vector<float> speedups;
+    ImGui::Separator();
+    ImGui::Text("Threads      ms   speedup  efficiency");
+    for (const Result& result : m_Results)
+    {
+      float speedup = m_Results[0].Milliseconds / result.Milliseconds;
+      speedups.push_back(speedup);
+      ImGui::Text("%7u %7.2f %8.2fx %10.0f%%", result.Threads, result.Milliseconds, speedup, 100.0f * speedup / result.Threads);
+    }
+    ImGui::PlotHistogram("Speedup", speedups.data(), (int)speedups.size(), 0, nullptr, 0.0f, (float)m_Results.back().Threads, ImVec2(0, 80));
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Test.h"
+
+#include <vector>
+
+namespace test
+{
+  // Microbenchmark for the job system: runs the same ParallelFor workload with
+  // 1..N threads and reports time and speedup per thread count.
+  class TestJobSystem : public Test
+  {
+  public:
+    TestJobSystem();
+    ~TestJobSystem();
+
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    struct Result
+    {
+      unsigned int Threads;
+      float Milliseconds;
+    };
+
+    void RunBenchmark();
+    float RunWorkload();
+
+    std::vector<float> m_Data;
+    int m_ElementCount;
+    int m_ChunkSize;
+    int m_Iterations;
+    std::vector<Result> m_Results;
+  };
+}
@@ -0,0 +1,105 @@
+#include "TestMultiDrawIndirect.h"
+#include "Renderer.h"
+#include "GLCapabilities.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <algorithm>
+
+namespace test
+{
+  static const unsigned int s_MaxObjects = 100000;
+  static const unsigned int s_ShapeCount = 16;
+
+  static VertexBufferLayout PositionLayout()
+  {
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    return layout;
+  }
+
+  TestMultiDrawIndirect::TestMultiDrawIndirect()
+    : m_Pool(PositionLayout(), 1024, 1024 * 3, s_ShapeCount), m_Renderer(m_Pool, s_MaxObjects),
+    m_Random(7), m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 720.0f, -1.0f, 1.0f)),
+    m_ObjectCount(10000), m_UseIndirect(m_Renderer.IsUsingIndirect())
+  {
+    // unit polygons with 3..18 sides, as triangle fans around the origin
+    for (unsigned int shape = 0; shape < s_ShapeCount; shape++)
+    {
+      unsigned int sides = shape + 3;
+      std::vector<glm::vec2> vertices(sides + 1);
+      std::vector<unsigned int> indices(sides * 3);
+      vertices[0] = glm::vec2(0.0f);
+      for (unsigned int i = 0; i < sides; i++)
+      {
+        float angle = 6.2831853f * i / sides;
+        vertices[i + 1] = glm::vec2(glm::cos(angle), glm::sin(angle));
+        indices[i * 3 + 0] = 0;
+        indices[i * 3 + 1] = i + 1;
+        indices[i * 3 + 2] = (i + 1) % sides + 1;
+      }
+      m_Shapes.push_back(m_Pool.Allocate(vertices.data(), sides + 1, indices.data(), sides * 3));
+    }
+    SetObjectCount(m_ObjectCount);
+  }
+
+  TestMultiDrawIndirect::~TestMultiDrawIndirect()
+  {
+  }
+
+  void TestMultiDrawIndirect::SetObjectCount(int count)
+  {
+    std::uniform_int_distribution<unsigned int> shape(0, s_ShapeCount - 1);
+    std::uniform_real_distribution<float> x(0.0f, 960.0f), y(0.0f, 720.0f), scale(2.0f, 8.0f),
+      spin(-3.0f, 3.0f), channel(0.2f, 1.0f);
+
+    m_Objects.resize(std::min<size_t>(count, s_MaxObjects));
+    for (Object& object : m_Objects)
+    {
+      object.Shape = shape(m_Random);
+      object.Spin = spin(m_Random);
+      object.Data.Transform = glm::vec4(x(m_Random), y(m_Random), scale(m_Random), 0.0f);
+      object.Data.Color = glm::vec4(channel(m_Random), channel(m_Random), channel(m_Random), 1.0f);
+    }
+  }
+
+  void TestMultiDrawIndirect::OnUpdate(float deltaTime)
+  {
+    for (Object& object : m_Objects)
+      object.Data.Transform.w += object.Spin * deltaTime;
+  }
+
+  void TestMultiDrawIndirect::OnRender(float alpha)
+  {
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    m_Renderer.Begin();
+    for (const Object& object : m_Objects)
+      m_Renderer.Submit(m_Shapes[object.Shape], object.Data);
+    m_Renderer.End(m_Proj);
+  }
+
+  void TestMultiDrawIndirect::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Objects", &m_ObjectCount, 100, s_MaxObjects, "%d", ImGuiSliderFlags_Logarithmic))
+      SetObjectCount(m_ObjectCount);
+
+    if (!GLCapabilities::HasMultiDrawIndirect())
+    {
+      ImGui::BeginDisabled();
+      ImGui::Checkbox("Multi-draw indirect (needs GL 4.3)", &m_UseIndirect);
+      ImGui::EndDisabled();
+    }
+    else if (ImGui::Checkbox("Multi-draw indirect", &m_UseIndirect))
+      m_Renderer.SetUseIndirect(m_UseIndirect);
+
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u for %u objects (%u meshes)", renderStats.DrawCalls, m_Renderer.GetDrawCount(), s_ShapeCount);
+    ImGui::Text("Objects/sec: %.2f M", m_Renderer.GetDrawCount() * framerate / 1e6f);
+  }
+}
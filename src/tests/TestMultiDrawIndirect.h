@@ -0,0 +1,44 @@
+#pragma once
+#include "Test.h"
+#include "GeometryPool.h"
+#include "MultiDrawRenderer.h"
+
+#include "glm/glm.hpp"
+
+#include <random>
+#include <vector>
+
+namespace test
+{
+  // Tens of thousands of objects using a handful of different pooled meshes,
+  // drawn either with one glMultiDrawElementsIndirect or one base-vertex draw
+  // per object.
+  class TestMultiDrawIndirect : public Test
+  {
+  public:
+    TestMultiDrawIndirect();
+    ~TestMultiDrawIndirect();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+  private:
+    struct Object
+    {
+      unsigned int Shape;
+      float Spin;
+      IndirectDrawData Data;
+    };
+
+    void SetObjectCount(int count);
+
+    GeometryPool m_Pool;
+    MultiDrawRenderer m_Renderer;
+    std::vector<GeometryHandle> m_Shapes;
+    std::vector<Object> m_Objects;
+    std::mt19937 m_Random;
+    glm::mat4 m_Proj;
+    int m_ObjectCount;
+    bool m_UseIndirect;
+  };
+}
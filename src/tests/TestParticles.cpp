@@ -0,0 +1,103 @@
+#include "TestParticles.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+  static const glm::vec2 s_ViewSize(960.0f, 720.0f);
+  static const int s_MaxParticles = 2000000;
+  static const int s_EmitterCount = 4;
+
+  TestParticles::TestParticles()
+    : m_Proj(glm::ortho(0.0f, s_ViewSize.x, 0.0f, s_ViewSize.y, -1.0f, 1.0f)), m_TargetCount(1000000), m_Time(0.0f)
+  {
+    m_Particles = std::make_unique<ParticleSystem>(s_MaxParticles);
+    for (int i = 0; i < s_EmitterCount; i++)
+    {
+      ParticleEmitter emitter;
+      emitter.Position = { s_ViewSize.x * (i + 0.5f) / s_EmitterCount, 40.0f };
+      emitter.HalfExtent = { 6.0f, 2.0f };
+      emitter.Spread = 0.25f;
+      emitter.SpeedMin = 350.0f;
+      emitter.SpeedMax = 550.0f;
+      emitter.LifetimeMin = 2.5f;
+      emitter.LifetimeMax = 3.5f;
+      m_Particles->AddEmitter(emitter);
+    }
+    ParticleModules& modules = m_Particles->GetModules();
+    modules.Gravity = { 0.0f, -220.0f };
+    modules.Drag = 0.4f;
+    modules.StartSize = 2.0f;
+    modules.EndSize = 0.75f;
+    UpdateEmitters();
+  }
+
+  TestParticles::~TestParticles()
+  {
+  }
+
+  void TestParticles::UpdateEmitters()
+  {
+    // live count = rate * average lifetime once births and deaths balance
+    for (unsigned int i = 0; i < m_Particles->GetEmitterCount(); i++)
+    {
+      ParticleEmitter& emitter = m_Particles->GetEmitter(i);
+      float lifetime = (emitter.LifetimeMin + emitter.LifetimeMax) * 0.5f;
+      emitter.Rate = m_TargetCount / (lifetime * s_EmitterCount);
+    }
+  }
+
+  void TestParticles::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+    // the fountains sway so the streams cross
+    for (unsigned int i = 0; i < m_Particles->GetEmitterCount(); i++)
+      m_Particles->GetEmitter(i).Direction = 1.5707963f + 0.35f * glm::sin(m_Time * 0.7f + i * 1.3f);
+    m_Particles->Update(deltaTime);
+  }
+
+  void TestParticles::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.02f, 0.02f, 0.04f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+    m_Particles->Render(m_Proj);
+  }
+
+  void TestParticles::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Target particles", &m_TargetCount, 1000, s_MaxParticles, "%d", ImGuiSliderFlags_Logarithmic))
+      UpdateEmitters();
+
+    ParticleModules& modules = m_Particles->GetModules();
+    ImGui::SliderFloat2("Gravity", &modules.Gravity.x, -500.0f, 500.0f);
+    ImGui::SliderFloat("Drag", &modules.Drag, 0.0f, 4.0f);
+    ImGui::ColorEdit4("Start color", &modules.StartColor.x);
+    ImGui::ColorEdit4("End color", &modules.EndColor.x);
+    ImGui::SliderFloat("Start size", &modules.StartSize, 0.25f, 16.0f);
+    ImGui::SliderFloat("End size", &modules.EndSize, 0.25f, 16.0f);
+
+    bool simd = m_Particles->IsSimd();
+    if (ImGui::Checkbox("SIMD update", &simd))
+      m_Particles->SetSimd(simd);
+    ImGui::SameLine();
+    bool parallel = m_Particles->IsParallel();
+    if (ImGui::Checkbox("Job system", &parallel))
+      m_Particles->SetParallel(parallel);
+    if (ImGui::Button("Clear"))
+      m_Particles->Clear();
+
+    const ParticleStats& stats = m_Particles->GetStats();
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("Live: %u / %u  (+%u -%u this frame)", stats.Live, m_Particles->GetMaxParticles(), stats.Spawned, stats.Died);
+    ImGui::Text("Simulate: %.2f ms  compact: %.3f ms  emit: %.2f ms", stats.SimulateTime, stats.CompactTime, stats.EmitTime);
+    ImGui::Text("Instance write: %.2f ms", stats.WriteTime);
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u", renderStats.DrawCalls);
+  }
+}
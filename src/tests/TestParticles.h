@@ -0,0 +1,32 @@
+#pragma once
+#include "Test.h"
+#include "ParticleSystem.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+
+namespace test
+{
+  // Four fountains feeding one CPU particle system, tuned so the live count
+  // settles at the target (1M by default). Toggles compare the SIMD and
+  // scalar update, and the job system against a single thread.
+  class TestParticles : public Test
+  {
+  public:
+    TestParticles();
+    ~TestParticles();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    void UpdateEmitters();
+
+    std::unique_ptr<ParticleSystem> m_Particles;
+    glm::mat4 m_Proj;
+    int m_TargetCount;
+    float m_Time;
+  };
+}
@@ -0,0 +1,116 @@
+#include "TestRenderTargets.h"
+#include "Renderer.h"
+#include "RenderTargetPool.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace test
+{
+  static const float s_Quad[] = {
+    -0.5f, -0.5f,
+     0.5f, -0.5f,
+     0.5f,  0.5f,
+    -0.5f,  0.5f,
+  };
+  static const unsigned int s_QuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+  static const int s_SampleCounts[] = { 1, 2, 4, 8 };
+
+  static VertexBufferLayout PositionLayout()
+  {
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    return layout;
+  }
+
+  TestRenderTargets::TestRenderTargets()
+    : m_VertexBuffer(s_Quad, (unsigned int)sizeof(s_Quad)), m_IndexBuffer(s_QuadIndices, 6),
+    m_Shader("res/shaders/FlatColor.shader"), m_Time(0.0f), m_SampleIndex(2), m_Scale(1.0f), m_HDR(false),
+    m_TransientTargets(2)
+  {
+    m_VAO.AddBuffer(m_VertexBuffer, PositionLayout());
+  }
+
+  TestRenderTargets::~TestRenderTargets()
+  {
+  }
+
+  void TestRenderTargets::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+  }
+
+  void TestRenderTargets::OnRender(float alpha)
+  {
+    RenderTargetPool& pool = RenderTargetPool::Get();
+
+    // post-processing or dynamic resolution may have bound their scene target
+    GLint output, viewport[4];
+    GLCall(glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &output));
+    GLCall(glGetIntegerv(GL_VIEWPORT, viewport));
+
+    FramebufferSpec spec;
+    spec.ColorFormat = m_HDR ? FramebufferFormat::RGBA16F : FramebufferFormat::RGBA8;
+    spec.Samples = s_SampleCounts[m_SampleIndex];
+    Framebuffer& scene = pool.AcquireWindowSized(spec, m_Scale);
+
+    scene.Bind();
+    GLCall(glClearColor(0.05f, 0.05f, 0.1f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    // thin rotated quads, so the edges show the sample count
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 720.0f, -1.0f, 1.0f);
+    Renderer renderer;
+    m_Shader.Bind();
+    for (int i = 0; i < 64; i++)
+    {
+      glm::vec3 position(120.0f + (i % 8) * 103.0f, 80.0f + (i / 8) * 80.0f, 0.0f);
+      glm::mat4 model = glm::rotate(glm::translate(glm::mat4(1.0f), position), m_Time * 0.3f + i * 0.2f, glm::vec3(0.0f, 0.0f, 1.0f));
+      model = glm::scale(model, glm::vec3(90.0f, 6.0f, 1.0f));
+      float t = i / 63.0f;
+      m_Shader.SetUniformMat4f("u_MVP", proj * model);
+      m_Shader.SetUniform4f("u_Color", t, 1.0f - t, 0.6f, 1.0f);
+      renderer.Draw(m_VAO, m_IndexBuffer, m_Shader);
+    }
+
+    // stand-ins for post-processing passes: half-size scratch targets
+    FramebufferSpec scratchSpec;
+    scratchSpec.ColorFormat = spec.ColorFormat;
+    for (int i = 0; i < m_TransientTargets; i++)
+    {
+      Framebuffer& scratch = pool.AcquireWindowSized(scratchSpec, m_Scale * 0.5f);
+      scratch.Bind();
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    }
+
+    int width = viewport[2], height = viewport[3];
+    if (spec.Samples > 1)
+    {
+      FramebufferSpec resolveSpec = spec;
+      resolveSpec.Samples = 1;
+      Framebuffer& resolved = pool.AcquireWindowSized(resolveSpec, m_Scale);
+      scene.Blit(resolved);
+      resolved.BlitTo(output, width, height);
+    }
+    else
+    {
+      scene.BlitTo(output, width, height);
+    }
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, output));
+    GLCall(glViewport(viewport[0], viewport[1], viewport[2], viewport[3]));
+  }
+
+  void TestRenderTargets::OnImGuiRender()
+  {
+    ImGui::Combo("MSAA", &m_SampleIndex, "Off\0" "2x\0" "4x\0" "8x\0");
+    ImGui::SliderFloat("Resolution scale", &m_Scale, 0.25f, 1.0f, "%.2f");
+    ImGui::Checkbox("RGBA16F", &m_HDR);
+    ImGui::SliderInt("Transient targets", &m_TransientTargets, 0, 8);
+
+    RenderTargetPoolStats stats = RenderTargetPool::Get().GetStats();
+    ImGui::Separator();
+    ImGui::Text("Window: %d x %d", stats.WindowWidth, stats.WindowHeight);
+    ImGui::Text("Pooled targets: %u (%u in use), created so far: %u", stats.Targets, stats.TargetsInUse, stats.Created);
+    ImGui::Text("Render target memory: %.2f MB", stats.MemoryUsage / (1024.0f * 1024.0f));
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Test.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Shader.h"
+
+#include "glm/glm.hpp"
+
+namespace test
+{
+  // Renders spinning quads into a pooled offscreen target (optionally MSAA,
+  // optionally at a fraction of the window size), resolves it and blits it to
+  // the window. Extra transient targets show the pool reusing them frame after
+  // frame instead of reallocating.
+  class TestRenderTargets : public Test
+  {
+  public:
+    TestRenderTargets();
+    ~TestRenderTargets();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+  private:
+    VertexArray m_VAO;
+    VertexBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    Shader m_Shader;
+
+    float m_Time;
+    int m_SampleIndex;
+    float m_Scale;
+    bool m_HDR;
+    int m_TransientTargets;
+  };
+}
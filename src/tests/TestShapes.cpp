@@ -0,0 +1,145 @@
+#include "TestShapes.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+
+namespace test
+{
+  static const glm::vec2 s_ViewSize(960.0f, 720.0f);
+  static const int s_MaxShapes = 100000;
+
+  TestShapes::TestShapes()
+    : m_Random(47), m_Proj(glm::ortho(0.0f, s_ViewSize.x, 0.0f, s_ViewSize.y, -1.0f, 1.0f)),
+    m_ShapeCount(5000), m_PolylineCount(16), m_PolylinePoints(256), m_LineWidth(2.0f), m_ShowGrid(true),
+    m_DrawPerShape(false), m_InterleaveSprites(false), m_Time(0.0f), m_SubmitTime(0.0f)
+  {
+    m_Batch = std::make_unique<BatchRenderer>();
+    SetShapeCount(m_ShapeCount);
+  }
+
+  TestShapes::~TestShapes()
+  {
+  }
+
+  void TestShapes::SetShapeCount(int count)
+  {
+    std::uniform_real_distribution<float> x(0.0f, s_ViewSize.x), y(0.0f, s_ViewSize.y), size(4.0f, 28.0f),
+      rotation(0.0f, 6.2831853f), spin(-2.0f, 2.0f), channel(0.3f, 1.0f), unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> type(1, 3);
+
+    m_Shapes.resize(count < (int)m_Shapes.size() ? count : m_Shapes.size());
+    while ((int)m_Shapes.size() < count)
+    {
+      Shape shape;
+      shape.Type = (ShapeType)type(m_Random);
+      shape.Position = { x(m_Random), y(m_Random) };
+      shape.Size = { size(m_Random), size(m_Random) };
+      shape.Rotation = rotation(m_Random);
+      shape.Spin = spin(m_Random);
+      // every other circle and rect is outlined
+      shape.Stroke = unit(m_Random) < 0.5f ? 1.5f : 0.0f;
+      shape.Color = { channel(m_Random), channel(m_Random), channel(m_Random), 0.8f };
+      m_Shapes.push_back(shape);
+    }
+  }
+
+  void TestShapes::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+    for (Shape& shape : m_Shapes)
+      shape.Rotation += shape.Spin * deltaTime;
+  }
+
+  void TestShapes::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.08f, 0.08f, 0.1f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    m_Batch->Begin(m_Proj);
+    // restarting the batch after every shape is what a draw call per shape costs
+    auto next = [this]() {
+      if (m_DrawPerShape)
+      {
+        m_Batch->End();
+        m_Batch->Begin(m_Proj);
+      }
+    };
+
+    if (m_ShowGrid)
+    {
+      glm::vec4 gridColor(1.0f, 1.0f, 1.0f, 0.08f);
+      for (float x = 0.0f; x <= s_ViewSize.x; x += 40.0f, next())
+        m_Batch->DrawLine({ x, 0.0f }, { x, s_ViewSize.y }, 1.0f, gridColor);
+      for (float y = 0.0f; y <= s_ViewSize.y; y += 40.0f, next())
+        m_Batch->DrawLine({ 0.0f, y }, { s_ViewSize.x, y }, 1.0f, gridColor);
+    }
+
+    for (size_t i = 0; i < m_Shapes.size(); i++, next())
+    {
+      const Shape& shape = m_Shapes[i];
+      switch (shape.Type)
+      {
+      case ShapeType::Segment:
+      {
+        glm::vec2 direction(glm::cos(shape.Rotation), glm::sin(shape.Rotation));
+        m_Batch->DrawLine(shape.Position - direction * shape.Size.x, shape.Position + direction * shape.Size.x, m_LineWidth, shape.Color);
+        break;
+      }
+      case ShapeType::Circle:
+        m_Batch->DrawCircle(shape.Position, shape.Size.x * 0.5f, shape.Color, shape.Stroke);
+        break;
+      case ShapeType::Rect:
+        m_Batch->DrawRect(shape.Position, shape.Size, shape.Color, glm::min(shape.Size.x, shape.Size.y) * 0.25f, shape.Stroke, shape.Rotation);
+        break;
+      default:
+        break;
+      }
+      // a quad between shapes forces a new batch each time
+      if (m_InterleaveSprites && i % 64 == 0)
+        m_Batch->DrawQuad(shape.Position, glm::vec2(6.0f), glm::vec4(1.0f));
+    }
+
+    m_Points.resize(m_PolylinePoints);
+    for (int line = 0; line < m_PolylineCount; line++, next())
+    {
+      float baseline = s_ViewSize.y * (line + 0.5f) / m_PolylineCount;
+      float frequency = 0.01f + 0.002f * line;
+      for (int i = 0; i < m_PolylinePoints; i++)
+      {
+        float x = s_ViewSize.x * i / (m_PolylinePoints - 1);
+        m_Points[i] = { x, baseline + 18.0f * glm::sin(x * frequency + m_Time * (1.0f + 0.1f * line)) };
+      }
+      float hue = (float)line / m_PolylineCount;
+      glm::vec4 color(0.5f + 0.5f * glm::cos(6.2831853f * hue), 0.5f + 0.5f * glm::cos(6.2831853f * (hue + 0.33f)),
+        0.5f + 0.5f * glm::cos(6.2831853f * (hue + 0.67f)), 1.0f);
+      m_Batch->DrawPolyline(m_Points.data(), (unsigned int)m_Points.size(), m_LineWidth, color);
+    }
+    m_Batch->End();
+    m_SubmitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void TestShapes::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Shapes", &m_ShapeCount, 0, s_MaxShapes, "%d", ImGuiSliderFlags_Logarithmic))
+      SetShapeCount(m_ShapeCount);
+    ImGui::SliderInt("Polylines", &m_PolylineCount, 0, 256);
+    ImGui::SliderInt("Points per polyline", &m_PolylinePoints, 2, 4096, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("Line width", &m_LineWidth, 0.5f, 16.0f, "%.1f");
+    ImGui::Checkbox("Grid", &m_ShowGrid);
+    ImGui::Checkbox("One draw per shape", &m_DrawPerShape);
+    ImGui::Checkbox("Interleave sprites", &m_InterleaveSprites);
+
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("Batch submit: %.3f ms", m_SubmitTime);
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u", renderStats.DrawCalls);
+  }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "Test.h"
+#include "BatchRenderer.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace test
+{
+  // Debug-overlay style scene: a grid, thousands of circles, rounded rects
+  // and lines, and animated polylines, all analytic shapes from the batch
+  // renderer. Can fall back to one draw per shape for comparison, or
+  // interleave sprites to show where batches have to break.
+  class TestShapes : public Test
+  {
+  public:
+    TestShapes();
+    ~TestShapes();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    struct Shape
+    {
+      ShapeType Type;
+      glm::vec2 Position;
+      glm::vec2 Size;
+      float Rotation;
+      float Spin;
+      float Stroke;
+      glm::vec4 Color;
+    };
+
+    void SetShapeCount(int count);
+
+    std::unique_ptr<BatchRenderer> m_Batch;
+    std::vector<Shape> m_Shapes;
+    std::vector<glm::vec2> m_Points;
+    std::mt19937 m_Random;
+    glm::mat4 m_Proj;
+
+    int m_ShapeCount;
+    int m_PolylineCount;
+    int m_PolylinePoints;
+    float m_LineWidth;
+    bool m_ShowGrid;
+    bool m_DrawPerShape;
+    bool m_InterleaveSprites;
+    float m_Time;
+
+    float m_SubmitTime;
+  };
+}
@@ -0,0 +1,142 @@
+#include "TestSpatialCulling.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+
+namespace test
+{
+  static const glm::vec2 s_ViewSize(960.0f, 720.0f);
+  static const glm::vec2 s_WorldSize = s_ViewSize * 50.0f;
+  static const int s_MaxSprites = 2000000;
+
+  TestSpatialCulling::TestSpatialCulling()
+    : m_Grid(glm::vec2(0.0f), s_WorldSize, 128.0f), m_Random(40),
+    m_SpriteCount(500000), m_DynamicPercent(10), m_Mode(CullMode::Grid), m_AutoPan(true), m_Time(0.0f),
+    m_Camera(s_WorldSize * 0.5f), m_Zoom(1.0f), m_SubmitTime(0.0f)
+  {
+    m_Batch = std::make_unique<BatchRenderer>();
+    SetSpriteCount(m_SpriteCount);
+  }
+
+  TestSpatialCulling::~TestSpatialCulling()
+  {
+  }
+
+  void TestSpatialCulling::SetSpriteCount(int count)
+  {
+    std::uniform_real_distribution<float> x(0.0f, s_WorldSize.x), y(0.0f, s_WorldSize.y), size(6.0f, 24.0f),
+      rotation(0.0f, 6.2831853f), velocity(-80.0f, 80.0f), channel(0.3f, 1.0f);
+
+    while ((int)m_Sprites.size() > count)
+    {
+      m_Grid.Remove(m_Proxies.back());
+      m_Proxies.pop_back();
+      m_Sprites.pop_back();
+      m_Velocities.pop_back();
+    }
+    while ((int)m_Sprites.size() < count)
+    {
+      Sprite sprite;
+      sprite.Position = { x(m_Random), y(m_Random) };
+      sprite.Size = glm::vec2(size(m_Random));
+      sprite.Rotation = rotation(m_Random);
+      sprite.TextureSlot = 0.0f;
+      sprite.Color = { channel(m_Random), channel(m_Random), channel(m_Random), 1.0f };
+
+      glm::vec2 min, max;
+      GetSpriteBounds(sprite, min, max);
+      m_Proxies.push_back(m_Grid.Insert(min, max, (unsigned int)m_Sprites.size()));
+      m_Sprites.push_back(sprite);
+      m_Velocities.push_back({ velocity(m_Random), velocity(m_Random) });
+    }
+  }
+
+  void TestSpatialCulling::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+    if (m_AutoPan)
+    {
+      // slow Lissajous sweep over most of the world
+      m_Camera = s_WorldSize * (0.5f + 0.4f * glm::vec2(glm::sin(m_Time * 0.05f), glm::sin(m_Time * 0.07f)));
+    }
+
+    // the first m_DynamicPercent of the sprites move and bounce off the world edges
+    unsigned int dynamicCount = (unsigned int)((size_t)m_Sprites.size() * m_DynamicPercent / 100);
+    for (unsigned int i = 0; i < dynamicCount; i++)
+    {
+      Sprite& sprite = m_Sprites[i];
+      sprite.Position += m_Velocities[i] * deltaTime;
+      if (sprite.Position.x < 0.0f || sprite.Position.x > s_WorldSize.x)
+        m_Velocities[i].x = -m_Velocities[i].x;
+      if (sprite.Position.y < 0.0f || sprite.Position.y > s_WorldSize.y)
+        m_Velocities[i].y = -m_Velocities[i].y;
+
+      glm::vec2 min, max;
+      GetSpriteBounds(sprite, min, max);
+      m_Grid.Update(m_Proxies[i], min, max);
+    }
+  }
+
+  void TestSpatialCulling::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+
+    glm::vec2 halfView = s_ViewSize * 0.5f / m_Zoom;
+    glm::mat4 viewProj = glm::ortho(m_Camera.x - halfView.x, m_Camera.x + halfView.x,
+      m_Camera.y - halfView.y, m_Camera.y + halfView.y, -1.0f, 1.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    m_Batch->Begin(viewProj);
+    switch (m_Mode)
+    {
+    case CullMode::None:
+      m_Batch->DrawSprites(m_Sprites.data(), (unsigned int)m_Sprites.size());
+      break;
+    case CullMode::PerQuad:
+      for (const Sprite& sprite : m_Sprites)
+        m_Batch->DrawQuad(sprite.Position, sprite.Size, sprite.Rotation, sprite.Color);
+      break;
+    case CullMode::Grid:
+      m_Batch->DrawSprites(m_Sprites.data(), m_Grid);
+      break;
+    }
+    m_Batch->End();
+    m_SubmitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    m_LastCullStats = m_Batch->GetCullStats();
+  }
+
+  void TestSpatialCulling::OnImGuiRender()
+  {
+    if (ImGui::SliderInt("Sprites", &m_SpriteCount, 1000, s_MaxSprites, "%d", ImGuiSliderFlags_Logarithmic))
+      SetSpriteCount(m_SpriteCount);
+    ImGui::SliderInt("Moving %", &m_DynamicPercent, 0, 100);
+
+    int mode = (int)m_Mode;
+    ImGui::Combo("Culling", &mode, "None (draw all)\0Per quad (DrawQuad)\0Spatial grid\0");
+    m_Mode = (CullMode)mode;
+
+    ImGui::Checkbox("Auto pan", &m_AutoPan);
+    if (!m_AutoPan)
+    {
+      ImGui::SliderFloat("Camera X", &m_Camera.x, 0.0f, s_WorldSize.x);
+      ImGui::SliderFloat("Camera Y", &m_Camera.y, 0.0f, s_WorldSize.y);
+    }
+    ImGui::SliderFloat("Zoom", &m_Zoom, 0.05f, 4.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+
+    SpatialGridStats gridStats = m_Grid.GetStats();
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("Visible: %u  culled: %u", m_LastCullStats.Visible, m_LastCullStats.Culled);
+    ImGui::Text("Grid: %u cells, %u occupied, largest %u", gridStats.CellCount, gridStats.OccupiedCells, gridStats.LargestCell);
+    ImGui::Text("Cull + batch submit: %.3f ms", m_SubmitTime);
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u, quads/frame: %u", renderStats.DrawCalls, renderStats.GetQuadCount());
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "SpatialGrid.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace test
+{
+  // A world 50x the viewport in each direction, filled with static and moving
+  // sprites, viewed through a panning camera. Compares drawing everything,
+  // per-quad culling in the batch renderer, and querying a SpatialGrid.
+  class TestSpatialCulling : public Test
+  {
+  public:
+    TestSpatialCulling();
+    ~TestSpatialCulling();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    enum class CullMode { None, PerQuad, Grid };
+
+    void SetSpriteCount(int count);
+
+    std::unique_ptr<BatchRenderer> m_Batch;
+    SpatialGrid m_Grid;
+    std::vector<Sprite> m_Sprites;
+    std::vector<unsigned int> m_Proxies;
+    std::vector<glm::vec2> m_Velocities;
+    std::mt19937 m_Random;
+
+    int m_SpriteCount;
+    // percentage of sprites that move
+    int m_DynamicPercent;
+    CullMode m_Mode;
+    bool m_AutoPan;
+    float m_Time;
+    glm::vec2 m_Camera;
+    float m_Zoom;
+
+    BatchCullStats m_LastCullStats;
+    float m_SubmitTime;
+  };
+}
@@ -0,0 +1,147 @@
+#include "TestSpriteTransform.h"
+#include "SpriteTransform.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+
+namespace test
+{
+  TestSpriteTransform::TestSpriteTransform()
+    : m_SpriteCount(1 << 20)
+  {
+  }
+
+  TestSpriteTransform::~TestSpriteTransform()
+  {
+  }
+
+  void TestSpriteTransform::Generate()
+  {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(0.0f, 960.0f), scale(4.0f, 32.0f), rotation(-20.0f, 20.0f), pivot(0.0f, 1.0f);
+    std::uniform_real_distribution<float>* distributions[7] = { &position, &position, &scale, &scale, &rotation, &pivot, &pivot };
+    for (int i = 0; i < 7; i++)
+    {
+      m_Input[i].resize(m_SpriteCount);
+      for (float& value : m_Input[i])
+        value = (*distributions[i])(rng);
+    }
+    m_Reference.resize(m_SpriteCount * 8);
+    m_Output.resize(m_SpriteCount * 8);
+  }
+
+  void TestSpriteTransform::RunBenchmark()
+  {
+    Generate();
+
+    unsigned int count = (unsigned int)m_SpriteCount;
+    SpriteTransformInput in = { m_Input[0].data(), m_Input[1].data(), m_Input[2].data(), m_Input[3].data(),
+      m_Input[4].data(), m_Input[5].data(), m_Input[6].data() };
+    auto outputFor = [count](std::vector<float>& buffer) {
+      SpriteTransformOutput out;
+      for (int corner = 0; corner < 4; corner++)
+      {
+        out.X[corner] = buffer.data() + corner * count;
+        out.Y[corner] = buffer.data() + (4 + corner) * count;
+      }
+      return out;
+    };
+    SpriteTransformOutput reference = outputFor(m_Reference);
+    SpriteTransformOutput out = outputFor(m_Output);
+
+    auto measure = [this](const std::function<void()>& run) {
+      float best = 0.0f;
+      for (int i = 0; i < 5; i++)
+      {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || time < best)
+          best = time;
+      }
+      return best;
+    };
+    auto maxError = [this]() {
+      float error = 0.0f;
+      for (size_t i = 0; i < m_Output.size(); i++)
+        error = std::max(error, std::abs(m_Output[i] - m_Reference[i]));
+      return error;
+    };
+
+    m_Results.clear();
+    float scalarTime = measure([&]() { SpriteTransform::TransformScalar(in, 0, count, reference); });
+
+    // what the batch renderer used to do: a full 4x4 model matrix per sprite
+    float glmTime = measure([&]() {
+      static const glm::vec4 corners[4] = { { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 1, 1, 0, 1 }, { 0, 1, 0, 1 } };
+      for (unsigned int i = 0; i < count; i++)
+      {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(in.PositionX[i], in.PositionY[i], 0.0f))
+          * glm::rotate(glm::mat4(1.0f), in.Rotation[i], glm::vec3(0.0f, 0.0f, 1.0f))
+          * glm::scale(glm::mat4(1.0f), glm::vec3(in.ScaleX[i], in.ScaleY[i], 1.0f))
+          * glm::translate(glm::mat4(1.0f), glm::vec3(-in.PivotX[i], -in.PivotY[i], 0.0f));
+        for (int corner = 0; corner < 4; corner++)
+        {
+          glm::vec4 position = transform * corners[corner];
+          out.X[corner][i] = position.x;
+          out.Y[corner][i] = position.y;
+        }
+      }
+    });
+    m_Results.push_back({ "glm::mat4", glmTime, maxError() });
+    m_Results.push_back({ "Scalar", scalarTime, 0.0f });
+
+    const SimdLevel levels[] = { SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON };
+    for (SimdLevel level : levels)
+    {
+      if (!SpriteTransform::IsSupported(level))
+        continue;
+
+      float time = 0.0f;
+      switch (level)
+      {
+      case SimdLevel::SSE2: time = measure([&]() { SpriteTransform::TransformSSE2(in, count, out); }); break;
+      case SimdLevel::AVX2: time = measure([&]() { SpriteTransform::TransformAVX2(in, count, out); }); break;
+      case SimdLevel::NEON: time = measure([&]() { SpriteTransform::TransformNEON(in, count, out); }); break;
+      default: break;
+      }
+      m_Results.push_back({ SpriteTransform::GetName(level), time, maxError() });
+    }
+  }
+
+  void TestSpriteTransform::OnImGuiRender()
+  {
+    const SimdLevel levels[] = { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::NEON };
+    SimdLevel current = SpriteTransform::GetSimdLevel();
+    if (ImGui::BeginCombo("Dispatch", SpriteTransform::GetName(current)))
+    {
+      for (SimdLevel level : levels)
+      {
+        if (SpriteTransform::IsSupported(level) && ImGui::Selectable(SpriteTransform::GetName(level), level == current))
+          SpriteTransform::SetSimdLevel(level);
+      }
+      ImGui::EndCombo();
+    }
+
+    ImGui::SliderInt("Sprites", &m_SpriteCount, 1 << 10, 1 << 22, "%d", ImGuiSliderFlags_Logarithmic);
+    if (ImGui::Button("Run benchmark"))
+      RunBenchmark();
+
+    if (m_Results.empty())
+      return;
+
+    ImGui::Separator();
+    ImGui::Text("%-10s %9s %12s %8s %10s", "Path", "ms", "Msprites/s", "vs glm", "max error");
+    for (const Result& result : m_Results)
+    {
+      ImGui::Text("%-10s %9.3f %12.1f %7.2fx %10.2g", result.Name.c_str(), result.Milliseconds,
+        m_SpriteCount / result.Milliseconds / 1000.0f, m_Results[0].Milliseconds / result.Milliseconds, result.MaxError);
+    }
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Test.h"
+
+#include <string>
+#include <vector>
+
+namespace test
+{
+  // Benchmarks the SIMD sprite transform kernel against the glm::mat4 path
+  // and the scalar reference, and lets the dispatch level be forced.
+  class TestSpriteTransform : public Test
+  {
+  public:
+    TestSpriteTransform();
+    ~TestSpriteTransform();
+
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    struct Result
+    {
+      std::string Name;
+      float Milliseconds;
+      float MaxError;
+    };
+
+    void Generate();
+    void RunBenchmark();
+
+    int m_SpriteCount;
+    std::vector<float> m_Input[7];
+    std::vector<float> m_Reference;
+    std::vector<float> m_Output;
+    std::vector<Result> m_Results;
+  };
+}
@@ -0,0 +1,415 @@
+#include "TestStress.h"
+#include "Renderer.h"
+#include "JobSystem.h"
+#include "GLCapabilities.h"
+#include "VertexFormat.h"
+#include "imgui/imgui.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <random>
+
+namespace test
+{
+  static const float s_WorldWidth = 960.0f;
+  static const float s_WorldHeight = 720.0f;
+
+  TestStress::TestStress(const char* countLabel, int count, int minCount, int maxCount)
+    : m_Count(count), m_Proj(glm::ortho(0.0f, s_WorldWidth, 0.0f, s_WorldHeight, -1.0f, 1.0f)),
+    m_CountLabel(countLabel), m_MinCount(minCount), m_MaxCount(maxCount)
+  {
+  }
+
+  static void ClearToBlack()
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+  }
+
+  void TestStress::OnImGuiRender()
+  {
+    if (ImGui::SliderInt(m_CountLabel, &m_Count, m_MinCount, m_MaxCount, "%d", ImGuiSliderFlags_Logarithmic))
+      OnCountChanged();
+
+    OnStressImGuiRender();
+
+    RenderStats stats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    unsigned int quads = GetQuadsPerFrame();
+    ImGui::Separator();
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u", stats.DrawCalls);
+    ImGui::Text("Quads/frame: %u", quads);
+    ImGui::Text("Quads/sec:   %.2f M", quads * framerate / 1.0e6f);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TestStressSprites::TestStressSprites()
+    : TestStress("Sprites", 10000, 1000, 1000000), m_ParallelVertices(true)
+  {
+    m_Batch = std::make_unique<BatchRenderer>();
+    m_Texture[0] = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+    m_Texture[1] = std::make_unique<Texture>("res/textures/HazelLogo.png");
+    OnCountChanged();
+  }
+
+  TestStressSprites::~TestStressSprites()
+  {
+  }
+
+  void TestStressSprites::OnCountChanged()
+  {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> x(0.0f, s_WorldWidth), y(0.0f, s_WorldHeight);
+    std::uniform_real_distribution<float> velocity(-100.0f, 100.0f), spin(-3.0f, 3.0f), channel(0.3f, 1.0f);
+
+    size_t oldCount = m_Sprites.size();
+    m_Sprites.resize(m_Count);
+    for (size_t i = oldCount; i < m_Sprites.size(); i++)
+    {
+      SpriteState& sprite = m_Sprites[i];
+      sprite.Position = { x(rng), y(rng) };
+      sprite.PreviousPosition = sprite.Position;
+      sprite.Velocity = { velocity(rng), velocity(rng) };
+      sprite.Rotation = 0.0f;
+      sprite.PreviousRotation = 0.0f;
+      sprite.AngularVelocity = spin(rng);
+      sprite.Color = { channel(rng), channel(rng), channel(rng), 1.0f };
+      sprite.TextureIndex = (int)(i % 3) - 1;
+    }
+  }
+
+  void TestStressSprites::OnFixedUpdate(float fixedDeltaTime)
+  {
+    JobSystem::ParallelFor((unsigned int)m_Sprites.size(), 8192, [this, fixedDeltaTime](unsigned int begin, unsigned int end) {
+      for (unsigned int i = begin; i < end; i++)
+      {
+        SpriteState& sprite = m_Sprites[i];
+        sprite.PreviousPosition = sprite.Position;
+        sprite.PreviousRotation = sprite.Rotation;
+        sprite.Position += sprite.Velocity * fixedDeltaTime;
+        sprite.Rotation += sprite.AngularVelocity * fixedDeltaTime;
+
+        if (sprite.Position.x < 0.0f || sprite.Position.x > s_WorldWidth)
+          sprite.Velocity.x = -sprite.Velocity.x;
+        if (sprite.Position.y < 0.0f || sprite.Position.y > s_WorldHeight)
+          sprite.Velocity.y = -sprite.Velocity.y;
+      }
+    });
+  }
+
+  void TestStressSprites::OnRender(float alpha)
+  {
+    ClearToBlack();
+
+    m_Batch->Begin(m_Proj);
+    if (m_ParallelVertices)
+    {
+      m_DrawList.resize(m_Sprites.size());
+      JobSystem::ParallelFor((unsigned int)m_Sprites.size(), 8192, [this, alpha](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; i++)
+        {
+          const SpriteState& state = m_Sprites[i];
+          Sprite& sprite = m_DrawList[i];
+          sprite.Position = glm::mix(state.PreviousPosition, state.Position, alpha);
+          sprite.Size = { 8.0f, 8.0f };
+          sprite.Rotation = glm::mix(state.PreviousRotation, state.Rotation, alpha);
+          sprite.TextureSlot = (float)(state.TextureIndex + 1);
+          sprite.Color = state.Color;
+        }
+      });
+
+      const Texture* textures[2] = { m_Texture[0].get(), m_Texture[1].get() };
+      m_Batch->DrawSprites(m_DrawList.data(), (unsigned int)m_DrawList.size(), textures, 2);
+    }
+    else
+    {
+      for (const SpriteState& sprite : m_Sprites)
+      {
+        const Texture* texture = sprite.TextureIndex >= 0 ? m_Texture[sprite.TextureIndex].get() : nullptr;
+        glm::vec2 position = glm::mix(sprite.PreviousPosition, sprite.Position, alpha);
+        float rotation = glm::mix(sprite.PreviousRotation, sprite.Rotation, alpha);
+        m_Batch->DrawQuad(position, { 8.0f, 8.0f }, rotation, sprite.Color, texture);
+      }
+    }
+    m_Batch->End();
+  }
+
+  void TestStressSprites::OnStressImGuiRender()
+  {
+    ImGui::Checkbox("Parallel vertex generation", &m_ParallelVertices);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TestStressTextureSwitch::TestStressTextureSwitch()
+    : TestStress("Quads", 20000, 1000, 200000), m_TextureCount(32)
+  {
+    m_Batch = std::make_unique<BatchRenderer>();
+
+    // small procedural checkerboards, each with its own tint
+    std::mt19937 rng(99);
+    std::uniform_int_distribution<unsigned int> channel(64, 255);
+    m_Textures.reserve(MaxTextures);
+    for (int t = 0; t < MaxTextures; t++)
+    {
+      unsigned int tint = 0xff000000 | (channel(rng) << 16) | (channel(rng) << 8) | channel(rng);
+      unsigned int pixels[8 * 8];
+      for (int i = 0; i < 8 * 8; i++)
+        pixels[i] = ((i / 8 + i % 8) & 1) ? tint : 0xffffffff;
+      m_Textures.emplace_back(8, 8, pixels);
+    }
+  }
+
+  TestStressTextureSwitch::~TestStressTextureSwitch()
+  {
+  }
+
+  void TestStressTextureSwitch::OnRender(float alpha)
+  {
+    ClearToBlack();
+
+    const int columns = 200;
+    const float cell = s_WorldWidth / columns;
+
+    m_Batch->Begin(m_Proj);
+    for (int i = 0; i < m_Count; i++)
+    {
+      // scatter the texture index so that neighbouring quads rarely share a texture
+      int textureIndex = (int)(((unsigned int)i * 2654435761u) >> 8) % m_TextureCount;
+      glm::vec2 position((i % columns + 0.5f) * cell, (i / columns % columns + 0.5f) * cell);
+      m_Batch->DrawQuad(position, { cell, cell }, 0.0f, glm::vec4(1.0f), &m_Textures[textureIndex]);
+    }
+    m_Batch->End();
+  }
+
+  void TestStressTextureSwitch::OnStressImGuiRender()
+  {
+    ImGui::SliderInt("Textures", &m_TextureCount, 1, MaxTextures);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  static const float s_UnitQuad[] = {
+    -0.5f, -0.5f,
+     0.5f, -0.5f,
+     0.5f,  0.5f,
+    -0.5f,  0.5f
+  };
+
+  static const unsigned int s_UnitQuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+
+  TestStressUniforms::TestStressUniforms()
+    : TestStress("Objects", 2000, 100, 100000)
+  {
+    m_VAO = std::make_unique<VertexArray>();
+    m_VertexBuffer = std::make_unique<VertexBuffer>(s_UnitQuad, (unsigned int)sizeof(s_UnitQuad));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    m_VAO->AddBuffer(*m_VertexBuffer, layout);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(s_UnitQuadIndices, 6);
+
+    m_Shader = std::make_unique<Shader>("res/shaders/FlatColor.shader");
+  }
+
+  TestStressUniforms::~TestStressUniforms()
+  {
+  }
+
+  void TestStressUniforms::OnRender(float alpha)
+  {
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    Renderer renderer;
+    const int columns = 100;
+    const float cell = s_WorldWidth / columns;
+
+    m_Shader->Bind();
+    for (int i = 0; i < m_Count; i++)
+    {
+      glm::vec3 position((i % columns + 0.5f) * cell, (i / columns % columns + 0.5f) * cell, 0.0f);
+      glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(cell * 0.8f));
+      glm::mat4 mvp = m_Proj * model;
+
+      float t = (float)i / m_Count;
+      m_Shader->SetUniformMat4f("u_MVP", mvp);
+      m_Shader->SetUniform4f("u_Color", t, 1.0f - t, 0.5f, 1.0f);
+      renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TestStressSmallDraws::TestStressSmallDraws()
+    : TestStress("Draws", 5000, 100, 100000)
+  {
+    m_Shader = std::make_unique<Shader>("res/shaders/FlatColor.shader");
+    CreateBuffers();
+  }
+
+  TestStressSmallDraws::~TestStressSmallDraws()
+  {
+  }
+
+  void TestStressSmallDraws::OnCountChanged()
+  {
+    // on the GL thread, after the commands still using the old buffers
+    Renderer::SubmitAndWait([this]() { CreateBuffers(); });
+  }
+
+  void TestStressSmallDraws::CreateBuffers()
+  {
+    // every quad lives in one static buffer; only the draw calls differ
+    const int columns = 200;
+    const float cell = s_WorldWidth / columns;
+
+    std::vector<float> vertices(m_Count * 4 * 2);
+    for (int i = 0; i < m_Count; i++)
+    {
+      float x = (i % columns + 0.5f) * cell;
+      float y = (i / columns % columns + 0.5f) * cell;
+      for (int v = 0; v < 4; v++)
+      {
+        vertices[(i * 4 + v) * 2 + 0] = x + s_UnitQuad[v * 2 + 0] * cell * 0.8f;
+        vertices[(i * 4 + v) * 2 + 1] = y + s_UnitQuad[v * 2 + 1] * cell * 0.8f;
+      }
+    }
+    std::vector<unsigned int> indices = BatchRenderer::GenerateQuadIndices(m_Count);
+
+    m_VAO = std::make_unique<VertexArray>();
+    m_VertexBuffer = std::make_unique<VertexBuffer>(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    m_VAO->AddBuffer(*m_VertexBuffer, layout);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), (unsigned int)indices.size());
+  }
+
+  void TestStressSmallDraws::OnRender(float alpha)
+  {
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    Renderer renderer;
+    m_Shader->Bind();
+    m_Shader->SetUniformMat4f("u_MVP", m_Proj);
+    m_Shader->SetUniform4f("u_Color", 0.2f, 0.8f, 0.3f, 1.0f);
+    for (int i = 0; i < m_Count; i++)
+      renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader, 6, i * 6);
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TestStressMeshSwitch::TestStressMeshSwitch()
+    : TestStress("Meshes", 2000, 100, 20000), m_SharedFormat(true)
+  {
+    m_Layout.Push<float>(2);
+    m_IndexBuffer = std::make_unique<IndexBuffer>(s_UnitQuadIndices, 6);
+    m_Shader = std::make_unique<Shader>("res/shaders/FlatColor.shader");
+    CreateMeshes();
+  }
+
+  TestStressMeshSwitch::~TestStressMeshSwitch()
+  {
+  }
+
+  void TestStressMeshSwitch::OnCountChanged()
+  {
+    // on the GL thread, after the commands still using the old meshes
+    Renderer::SubmitAndWait([this]() { CreateMeshes(); });
+  }
+
+  void TestStressMeshSwitch::CreateMeshes()
+  {
+    const int columns = 150;
+    const float cell = s_WorldWidth / columns;
+
+    m_Meshes.clear();
+    m_Meshes.reserve(m_Count);
+    for (int i = 0; i < m_Count; i++)
+    {
+      float x = (i % columns + 0.5f) * cell;
+      float y = (i / columns % columns + 0.5f) * cell;
+      float vertices[8];
+      for (int v = 0; v < 4; v++)
+      {
+        vertices[v * 2 + 0] = x + s_UnitQuad[v * 2 + 0] * cell * 0.8f;
+        vertices[v * 2 + 1] = y + s_UnitQuad[v * 2 + 1] * cell * 0.8f;
+      }
+      m_Meshes.emplace_back(vertices, (unsigned int)sizeof(vertices));
+      m_Meshes.back().VAO.AddBuffer(m_Meshes.back().Buffer, m_Layout);
+    }
+  }
+
+  void TestStressMeshSwitch::OnRender(float alpha)
+  {
+    GLCall(glClearColor(0.0f, 0.0f, 0.0f, 1.0f));
+    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+
+    Renderer renderer;
+    m_Shader->Bind();
+    m_Shader->SetUniformMat4f("u_MVP", m_Proj);
+    m_Shader->SetUniform4f("u_Color", 0.9f, 0.6f, 0.2f, 1.0f);
+    if (m_SharedFormat)
+    {
+      const VertexFormat& format = VertexFormat::Get(m_Layout);
+      for (const Mesh& mesh : m_Meshes)
+      {
+        format.BindVertexBuffer(mesh.Buffer);
+        renderer.Draw(format, *m_IndexBuffer, *m_Shader);
+      }
+    }
+    else
+    {
+      for (const Mesh& mesh : m_Meshes)
+        renderer.Draw(mesh.VAO, *m_IndexBuffer, *m_Shader);
+    }
+  }
+
+  void TestStressMeshSwitch::OnStressImGuiRender()
+  {
+    ImGui::Checkbox("Shared vertex format", &m_SharedFormat);
+    ImGui::Text("Cached vertex formats: %u", VertexFormat::GetCacheSize());
+    ImGui::Text("Buffer switch: %s", GLCapabilities::HasVertexAttribBinding()
+      ? "glBindVertexBuffer" : "glVertexAttribPointer (no ARB_vertex_attrib_binding)");
+  }
+
+  // ---------------------------------------------------------------------------
+
+  TestStressOverdraw::TestStressOverdraw()
+    : TestStress("Layers", 16, 1, 512)
+  {
+    m_Batch = std::make_unique<BatchRenderer>();
+  }
+
+  TestStressOverdraw::~TestStressOverdraw()
+  {
+  }
+
+  void TestStressOverdraw::OnRender(float alpha)
+  {
+    ClearToBlack();
+
+    // full-screen translucent layers: one draw call, cost is all fill rate
+    glm::vec2 center(s_WorldWidth * 0.5f, s_WorldHeight * 0.5f);
+    m_Batch->Begin(m_Proj);
+    for (int i = 0; i < m_Count; i++)
+    {
+      float t = (float)i / m_Count;
+      m_Batch->DrawQuad(center, { s_WorldWidth, s_WorldHeight }, { t, 0.5f, 1.0f - t, 0.05f });
+    }
+    m_Batch->End();
+  }
+
+  void TestStressOverdraw::OnStressImGuiRender()
+  {
+    const ImGuiIO& io = ImGui::GetIO();
+    double pixels = (double)io.DisplaySize.x * io.DisplayFramebufferScale.x
+      * io.DisplaySize.y * io.DisplayFramebufferScale.y * m_Count;
+    ImGui::Text("Fill: %.1f Mpix/frame, %.2f Gpix/sec", pixels / 1.0e6, pixels * ImGui::GetIO().Framerate / 1.0e9);
+  }
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include "Test.h"
+
+#include "BatchRenderer.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+
+#include <memory>
+#include <vector>
+
+namespace test
+{
+  // Common base for the stress scenes: owns the object count slider and the
+  // throughput read-out (ms/frame, draws/frame, quads/sec).
+  class TestStress : public Test
+  {
+  public:
+    TestStress(const char* countLabel, int count, int minCount, int maxCount);
+
+    void OnImGuiRender() override;
+  protected:
+    virtual void OnCountChanged() {}
+    virtual void OnStressImGuiRender() {}
+    virtual unsigned int GetQuadsPerFrame() const { return (unsigned int)m_Count; }
+
+    int m_Count;
+    glm::mat4 m_Proj;
+  private:
+    const char* m_CountLabel;
+    int m_MinCount, m_MaxCount;
+  };
+
+  class TestStressSprites : public TestStress
+  {
+  public:
+    TestStressSprites();
+    ~TestStressSprites();
+
+    void OnFixedUpdate(float fixedDeltaTime) override;
+    void OnRender(float alpha) override;
+    bool SupportsRenderThread() const override { return true; }
+  protected:
+    void OnCountChanged() override;
+    void OnStressImGuiRender() override;
+  private:
+    struct SpriteState
+    {
+      glm::vec2 Position;
+      glm::vec2 PreviousPosition;
+      glm::vec2 Velocity;
+      float Rotation;
+      float PreviousRotation;
+      float AngularVelocity;
+      glm::vec4 Color;
+      int TextureIndex;
+    };
+
+    std::unique_ptr<BatchRenderer> m_Batch;
+    std::unique_ptr<Texture> m_Texture[2];
+    std::vector<SpriteState> m_Sprites;
+    std::vector<Sprite> m_DrawList;
+    bool m_ParallelVertices;
+  };
+
+  class TestStressTextureSwitch : public TestStress
+  {
+  public:
+    TestStressTextureSwitch();
+    ~TestStressTextureSwitch();
+
+    void OnRender(float alpha) override;
+    bool SupportsRenderThread() const override { return true; }
+  protected:
+    void OnStressImGuiRender() override;
+  private:
+    static const int MaxTextures = 64;
+
+    std::unique_ptr<BatchRenderer> m_Batch;
+    std::vector<Texture> m_Textures;
+    int m_TextureCount;
+  };
+
+  class TestStressUniforms : public TestStress
+  {
+  public:
+    TestStressUniforms();
+    ~TestStressUniforms();
+
+    void OnRender(float alpha) override;
+  private:
+    std::unique_ptr<VertexArray> m_VAO;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<Shader> m_Shader;
+  };
+
+  class TestStressSmallDraws : public TestStress
+  {
+  public:
+    TestStressSmallDraws();
+    ~TestStressSmallDraws();
+
+    void OnRender(float alpha) override;
+  protected:
+    void OnCountChanged() override;
+  private:
+    // GL thread only
+    void CreateBuffers();
+
+    std::unique_ptr<VertexArray> m_VAO;
+    std::unique_ptr<VertexBuffer> m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<Shader> m_Shader;
+  };
+
+  // Many small meshes with the same layout, each in its own vertex buffer:
+  // one VAO per mesh versus one shared VertexFormat with buffer rebinding.
+  class TestStressMeshSwitch : public TestStress
+  {
+  public:
+    TestStressMeshSwitch();
+    ~TestStressMeshSwitch();
+
+    void OnRender(float alpha) override;
+  protected:
+    void OnCountChanged() override;
+    void OnStressImGuiRender() override;
+  private:
+    struct Mesh
+    {
+      Mesh(const float* vertices, unsigned int size) : Buffer(vertices, size) {}
+
+      VertexBuffer Buffer;
+      VertexArray VAO;
+    };
+
+    // GL thread only
+    void CreateMeshes();
+
+    VertexBufferLayout m_Layout;
+    std::vector<Mesh> m_Meshes;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    std::unique_ptr<Shader> m_Shader;
+    bool m_SharedFormat;
+  };
+
+  class TestStressOverdraw : public TestStress
+  {
+  public:
+    TestStressOverdraw();
+    ~TestStressOverdraw();
+
+    void OnRender(float alpha) override;
+    bool SupportsRenderThread() const override { return true; }
+  protected:
+    void OnStressImGuiRender() override;
+  private:
+    std::unique_ptr<BatchRenderer> m_Batch;
+  };
+}
@@ -0,0 +1,157 @@
+#include "TestText.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+namespace test
+{
+  static const glm::vec2 s_ViewSize(960.0f, 720.0f);
+  static const int s_MaxLabels = 20000;
+  static const char* s_FontPaths[] = { "C:/Windows/Fonts/segoeui.ttf", "C:/Windows/Fonts/arial.ttf" };
+  static const char* s_Words[] = { "Tree", "Rock", "Enemy", "Chest", "Door", "Torch", "Villager", "Spawn" };
+
+  static void AppendUtf8(std::string& text, int codepoint)
+  {
+    if (codepoint < 0x80)
+    {
+      text += (char)codepoint;
+    }
+    else if (codepoint < 0x800)
+    {
+      text += (char)(0xc0 | (codepoint >> 6));
+      text += (char)(0x80 | (codepoint & 0x3f));
+    }
+    else
+    {
+      text += (char)(0xe0 | (codepoint >> 12));
+      text += (char)(0x80 | ((codepoint >> 6) & 0x3f));
+      text += (char)(0x80 | (codepoint & 0x3f));
+    }
+  }
+
+  TestText::TestText()
+    : m_Random(46), m_LabelCount(2000), m_HeadingSize(64.0f), m_Zoom(1.0f), m_CycleGlyphs(false), m_CycleOffset(0),
+    m_Time(0.0f), m_SubmitTime(0.0f)
+  {
+    for (const char* path : s_FontPaths)
+    {
+      if (std::filesystem::exists(path))
+      {
+        m_Font = std::make_unique<Font>(path);
+        break;
+      }
+    }
+    if (!m_Font)
+    {
+      // ImGui's embedded ProggyClean; blocky, but always there
+      ImFontAtlas* fonts = ImGui::GetIO().Fonts;
+      if (fonts->ConfigData.empty() && !fonts->Locked)
+        fonts->AddFontDefault();
+      if (!fonts->ConfigData.empty())
+        m_Font = std::make_unique<Font>(fonts->ConfigData[0].FontData, (size_t)fonts->ConfigData[0].FontDataSize);
+    }
+
+    m_Batch = std::make_unique<BatchRenderer>(100000);
+    std::strcpy(m_Text, "Sharp at any size.\nKerning: AVA Ty To WAV");
+    SetLabelCount(m_LabelCount);
+  }
+
+  TestText::~TestText()
+  {
+  }
+
+  void TestText::SetLabelCount(int count)
+  {
+    std::uniform_real_distribution<float> x(0.0f, s_ViewSize.x), y(0.0f, s_ViewSize.y), size(9.0f, 22.0f),
+      phase(0.0f, 6.2831853f), channel(0.5f, 1.0f);
+    std::uniform_int_distribution<int> word(0, sizeof(s_Words) / sizeof(s_Words[0]) - 1);
+
+    m_Labels.resize(count < (int)m_Labels.size() ? count : m_Labels.size());
+    while ((int)m_Labels.size() < count)
+    {
+      Label label;
+      label.Text = std::string(s_Words[word(m_Random)]) + " " + std::to_string(m_Labels.size());
+      label.Position = { x(m_Random), y(m_Random) };
+      label.Size = size(m_Random);
+      label.Phase = phase(m_Random);
+      label.Color = { channel(m_Random), channel(m_Random), channel(m_Random), 1.0f };
+      m_Labels.push_back(label);
+    }
+  }
+
+  void TestText::OnUpdate(float deltaTime)
+  {
+    m_Time += deltaTime;
+    if (m_CycleGlyphs)
+      m_CycleOffset = (m_CycleOffset + 4) % (0x250 - 0x100);
+  }
+
+  void TestText::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+    if (!m_Font || !m_Font->IsValid())
+      return;
+
+    glm::vec2 center = s_ViewSize * 0.5f;
+    glm::vec2 halfView = center / m_Zoom;
+    glm::mat4 viewProj = glm::ortho(center.x - halfView.x, center.x + halfView.x, center.y - halfView.y, center.y + halfView.y,
+      -1.0f, 1.0f);
+
+    auto start = std::chrono::steady_clock::now();
+    m_Batch->Begin(viewProj);
+    for (const Label& label : m_Labels)
+    {
+      glm::vec2 position = label.Position + glm::vec2(0.0f, 4.0f * glm::sin(m_Time * 2.0f + label.Phase));
+      m_Batch->DrawString(*m_Font, label.Text, position, label.Size, label.Color);
+    }
+
+    // dark backing so the heading stays readable over the labels
+    glm::vec2 size = m_Font->MeasureText(m_Text, m_HeadingSize);
+    glm::vec2 position(40.0f, s_ViewSize.y - 40.0f - m_Font->GetAscent(m_HeadingSize));
+    glm::vec2 top(position.x, s_ViewSize.y - 40.0f);
+    m_Batch->DrawQuad(top + glm::vec2(size.x * 0.5f, -size.y * 0.5f), size + glm::vec2(24.0f), glm::vec4(0.0f, 0.0f, 0.0f, 0.8f));
+    m_Batch->DrawString(*m_Font, m_Text, position, m_HeadingSize, glm::vec4(1.0f));
+
+    if (m_CycleGlyphs)
+    {
+      m_CycleRow.clear();
+      for (int i = 0; i < 48; i++)
+        AppendUtf8(m_CycleRow, 0x100 + (m_CycleOffset + i) % (0x250 - 0x100));
+      m_Batch->DrawString(*m_Font, m_CycleRow, glm::vec2(20.0f, 30.0f), 24.0f, glm::vec4(1.0f, 0.9f, 0.4f, 1.0f));
+    }
+    m_Batch->End();
+    m_SubmitTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void TestText::OnImGuiRender()
+  {
+    if (!m_Font || !m_Font->IsValid())
+    {
+      ImGui::Text("No font could be loaded");
+      return;
+    }
+
+    if (ImGui::SliderInt("Labels", &m_LabelCount, 0, s_MaxLabels, "%d", ImGuiSliderFlags_Logarithmic))
+      SetLabelCount(m_LabelCount);
+    ImGui::SliderFloat("Heading size", &m_HeadingSize, 8.0f, 256.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("Zoom", &m_Zoom, 0.25f, 16.0f, "%.2f", ImGuiSliderFlags_Logarithmic);
+    ImGui::InputTextMultiline("Text", m_Text, sizeof(m_Text), ImVec2(0, 60));
+    ImGui::Checkbox("Cycle through Latin Extended", &m_CycleGlyphs);
+
+    const FontAtlasStats& atlas = m_Font->GetStats();
+    RenderStats renderStats = Renderer::GetStats();
+    ImGui::Separator();
+    ImGui::Text("Atlas: %u glyphs resident, %u rasterized", atlas.ResidentGlyphs, atlas.RasterizedGlyphs);
+    ImGui::Text("Evicted pages: %u  dropped glyphs: %u", atlas.EvictedPages, atlas.DroppedGlyphs);
+    ImGui::Text("Layout + batch submit: %.3f ms", m_SubmitTime);
+    ImGui::Text("Draws/frame: %u, quads/frame: %u", renderStats.DrawCalls, renderStats.GetQuadCount());
+  }
+}
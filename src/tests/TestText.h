@@ -0,0 +1,57 @@
+#pragma once
+#include "Test.h"
+#include "BatchRenderer.h"
+#include "Font.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace test
+{
+  // Thousands of distance field labels plus a heading that can be scaled and
+  // zoomed, all in one batch. Cycling through Latin Extended needs more
+  // glyphs than the atlas holds and shows the LRU page eviction.
+  class TestText : public Test
+  {
+  public:
+    TestText();
+    ~TestText();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    struct Label
+    {
+      std::string Text;
+      glm::vec2 Position;
+      float Size;
+      float Phase;
+      glm::vec4 Color;
+    };
+
+    void SetLabelCount(int count);
+
+    std::unique_ptr<Font> m_Font;
+    std::unique_ptr<BatchRenderer> m_Batch;
+    std::vector<Label> m_Labels;
+    std::mt19937 m_Random;
+
+    int m_LabelCount;
+    float m_HeadingSize;
+    float m_Zoom;
+    bool m_CycleGlyphs;
+    int m_CycleOffset;
+    // rebuilt every frame; kept so its buffer is reused
+    std::string m_CycleRow;
+    float m_Time;
+    char m_Text[256];
+
+    float m_SubmitTime;
+  };
+}
@@ -0,0 +1,268 @@
+#include "TestTilemap.h"
+#include "JobSystem.h"
+#include "Renderer.h"
+#include "imgui/imgui.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <chrono>
+
+namespace test
+{
+  static const unsigned int s_MapSize = 4096;
+  static const float s_TileSize = 16.0f;
+  static const int s_TilePixels = 16;
+  static const int s_TilesetColumns = 4, s_TilesetRows = 4;
+
+  struct TileInfo
+  {
+    const char* Name;
+    glm::vec3 Color;
+  };
+  // tile i + 1 of the map
+  static const TileInfo s_Tiles[] = {
+    { "Deep water", { 0.09f, 0.23f, 0.47f } },
+    { "Water", { 0.16f, 0.38f, 0.67f } },
+    { "Sand", { 0.84f, 0.77f, 0.55f } },
+    { "Grass", { 0.33f, 0.59f, 0.24f } },
+    { "Forest", { 0.16f, 0.39f, 0.17f } },
+    { "Rock", { 0.46f, 0.44f, 0.41f } },
+    { "Snow", { 0.92f, 0.94f, 0.96f } },
+    { "Brick", { 0.59f, 0.27f, 0.2f } },
+    { "Planks", { 0.59f, 0.43f, 0.26f } },
+    { "Lava", { 0.86f, 0.31f, 0.08f } },
+  };
+  static const int s_TileCount = sizeof(s_Tiles) / sizeof(s_Tiles[0]);
+  enum : unsigned short { DeepWater = 1, Water, Sand, Grass, Forest, Rock, Snow, Brick, Planks, Lava };
+
+  static unsigned int Hash(int x, int y, unsigned int seed)
+  {
+    unsigned int h = (unsigned int)x * 374761393u + (unsigned int)y * 668265263u + seed * 2246822519u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    return h ^ (h >> 16);
+  }
+
+  static float Lattice(int x, int y, unsigned int seed)
+  {
+    return (Hash(x, y, seed) & 0xffffff) / 16777215.0f;
+  }
+
+  static float ValueNoise(float x, float y, unsigned int seed)
+  {
+    int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
+    float tx = x - x0, ty = y - y0;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    ty = ty * ty * (3.0f - 2.0f * ty);
+    float bottom = glm::mix(Lattice(x0, y0, seed), Lattice(x0 + 1, y0, seed), tx);
+    float top = glm::mix(Lattice(x0, y0 + 1, seed), Lattice(x0 + 1, y0 + 1, seed), tx);
+    return glm::mix(bottom, top, ty);
+  }
+
+  // about [0, 1]
+  static float FractalNoise(float x, float y, unsigned int seed)
+  {
+    float value = 0.0f, amplitude = 0.5f;
+    for (int octave = 0; octave < 6; octave++)
+    {
+      value += ValueNoise(x, y, seed + octave) * amplitude;
+      x *= 2.0f;
+      y *= 2.0f;
+      amplitude *= 0.5f;
+    }
+    return value / (1.0f - amplitude * 2.0f);
+  }
+
+  // Flat-coloured tiles with a little per-pixel noise and a pattern for the
+  // built ones, laid out like a tileset image: tile 1 at the top left.
+  static std::unique_ptr<Texture> CreateTileset()
+  {
+    int width = s_TilesetColumns * s_TilePixels, height = s_TilesetRows * s_TilePixels;
+    std::vector<unsigned char> pixels((size_t)width * height * 4, 0);
+    for (int t = 0; t < s_TileCount; t++)
+    {
+      int column = t % s_TilesetColumns, row = t / s_TilesetColumns;
+      for (int py = 0; py < s_TilePixels; py++)
+      {
+        for (int px = 0; px < s_TilePixels; px++)
+        {
+          unsigned short tile = (unsigned short)(t + 1);
+          float shade = 1.0f + ((Hash(px, py, t) & 0xff) / 255.0f - 0.5f) * 0.12f;
+          if (tile == Brick && (py % 8 == 0 || (px + (py / 8 % 2) * 8) % 16 == 0))
+            shade = 1.45f;
+          else if (tile == Planks && py % 4 == 0)
+            shade = 0.75f;
+          else if ((tile == Water || tile == DeepWater) && (px + py * 3) % 16 == 0)
+            shade = 1.25f;
+          else if (tile == Forest && glm::length(glm::vec2(px % 8, py % 8) - 3.5f) < 2.5f)
+            shade = 0.7f;
+
+          // image rows count from the top, texture rows from the bottom
+          int y = height - 1 - (row * s_TilePixels + py);
+          unsigned char* pixel = &pixels[((size_t)y * width + column * s_TilePixels + px) * 4];
+          glm::vec3 color = glm::clamp(s_Tiles[t].Color * shade, 0.0f, 1.0f);
+          pixel[0] = (unsigned char)(color.r * 255.0f);
+          pixel[1] = (unsigned char)(color.g * 255.0f);
+          pixel[2] = (unsigned char)(color.b * 255.0f);
+          pixel[3] = 255;
+        }
+      }
+    }
+    return std::make_unique<Texture>(width, height, pixels.data());
+  }
+
+  TestTilemap::TestTilemap()
+    : m_Random(50), m_Camera(s_MapSize * s_TileSize * 0.5f), m_Zoom(1.0f), m_BrushTile(Brick - 1), m_BrushRadius(2),
+    m_RandomEdits(0), m_RebakeAll(false), m_Seed(1), m_GenerateTime(0.0f)
+  {
+    m_Tileset = CreateTileset();
+    m_Map = std::make_unique<Tilemap>(s_MapSize, s_MapSize, s_TileSize);
+    m_Map->SetTileset(m_Tileset.get(), s_TilesetColumns, s_TilesetRows);
+    GenerateMap(m_Seed);
+  }
+
+  TestTilemap::~TestTilemap()
+  {
+  }
+
+  void TestTilemap::GenerateMap(unsigned int seed)
+  {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<unsigned short> tiles((size_t)s_MapSize * s_MapSize);
+    JobSystem::ParallelFor(s_MapSize, 64, [&tiles, seed](unsigned int begin, unsigned int end) {
+      for (unsigned int y = begin; y < end; y++)
+      {
+        for (unsigned int x = 0; x < s_MapSize; x++)
+        {
+          glm::vec2 position = glm::vec2((float)x, (float)y) / (float)s_MapSize;
+          // an island: sinks towards the edges of the map
+          float falloff = glm::length(position - 0.5f) * 2.0f;
+          float height = FractalNoise(position.x * 12.0f, position.y * 12.0f, seed) - falloff * falloff * 0.6f;
+          float moisture = FractalNoise(position.x * 24.0f, position.y * 24.0f, seed + 101);
+
+          unsigned short tile;
+          if (height < 0.2f)
+            tile = DeepWater;
+          else if (height < 0.3f)
+            tile = Water;
+          else if (height < 0.33f)
+            tile = Sand;
+          else if (height < 0.5f)
+            tile = moisture > 0.55f ? Forest : Grass;
+          else if (height < 0.6f)
+            tile = Rock;
+          else
+            tile = Snow;
+          tiles[(size_t)y * s_MapSize + x] = tile;
+        }
+      }
+    });
+    m_Map->SetTiles(tiles);
+
+    m_GenerateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  static glm::vec2 GetDisplaySize()
+  {
+    ImVec2 size = ImGui::GetIO().DisplaySize;
+    return size.x > 0.0f && size.y > 0.0f ? glm::vec2(size.x, size.y) : glm::vec2(960.0f, 720.0f);
+  }
+
+  glm::vec2 TestTilemap::ScreenToWorld(const glm::vec2& screen) const
+  {
+    glm::vec2 offset = screen - GetDisplaySize() * 0.5f;
+    return m_Camera + glm::vec2(offset.x, -offset.y) / m_Zoom;
+  }
+
+  glm::mat4 TestTilemap::GetViewProj() const
+  {
+    glm::vec2 half = GetDisplaySize() * 0.5f / m_Zoom;
+    return glm::ortho(m_Camera.x - half.x, m_Camera.x + half.x, m_Camera.y - half.y, m_Camera.y + half.y, -1.0f, 1.0f);
+  }
+
+  void TestTilemap::Paint(const glm::ivec2& center)
+  {
+    for (int y = -m_BrushRadius; y <= m_BrushRadius; y++)
+    {
+      for (int x = -m_BrushRadius; x <= m_BrushRadius; x++)
+      {
+        glm::ivec2 tile = center + glm::ivec2(x, y);
+        if (x * x + y * y <= m_BrushRadius * m_BrushRadius && m_Map->Contains(tile))
+          m_Map->SetTile(tile.x, tile.y, (unsigned short)(m_BrushTile + 1));
+      }
+    }
+  }
+
+  void TestTilemap::HandleInput()
+  {
+    ImGuiIO& io = ImGui::GetIO();
+    if (io.WantCaptureMouse)
+      return;
+
+    glm::vec2 mouse(io.MousePos.x, io.MousePos.y);
+    if (io.MouseWheel != 0.0f)
+    {
+      // keep the point under the cursor in place
+      glm::vec2 anchor = ScreenToWorld(mouse);
+      m_Zoom = glm::clamp(m_Zoom * std::pow(1.2f, io.MouseWheel), 1.0f / 64.0f, 8.0f);
+      m_Camera += anchor - ScreenToWorld(mouse);
+    }
+    if (ImGui::IsMouseDown(ImGuiMouseButton_Right) || ImGui::IsMouseDown(ImGuiMouseButton_Middle))
+      m_Camera -= glm::vec2(io.MouseDelta.x, -io.MouseDelta.y) / m_Zoom;
+    if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
+      Paint(m_Map->WorldToTile(ScreenToWorld(mouse)));
+  }
+
+  void TestTilemap::OnUpdate(float deltaTime)
+  {
+    if (m_RandomEdits == 0)
+      return;
+
+    // scattered over the view, so every edit dirties a visible chunk
+    glm::ivec2 a = m_Map->WorldToTile(ScreenToWorld(glm::vec2(0.0f)));
+    glm::ivec2 b = m_Map->WorldToTile(ScreenToWorld(GetDisplaySize()));
+    glm::ivec2 min = glm::clamp(glm::min(a, b), glm::ivec2(0), glm::ivec2(s_MapSize - 1));
+    glm::ivec2 max = glm::clamp(glm::max(a, b), glm::ivec2(0), glm::ivec2(s_MapSize - 1));
+    std::uniform_int_distribution<int> x(min.x, max.x), y(min.y, max.y), tile(1, s_TileCount);
+    for (int i = 0; i < m_RandomEdits; i++)
+      m_Map->SetTile(x(m_Random), y(m_Random), (unsigned short)tile(m_Random));
+  }
+
+  void TestTilemap::OnRender(float alpha)
+  {
+    Renderer::Submit([]() {
+      GLCall(glClearColor(0.05f, 0.05f, 0.08f, 1.0f));
+      GLCall(glClear(GL_COLOR_BUFFER_BIT));
+    });
+    if (m_RebakeAll)
+      m_Map->InvalidateAll();
+    m_Map->Render(GetViewProj());
+  }
+
+  void TestTilemap::OnImGuiRender()
+  {
+    ImGui::Text("Right drag: pan, wheel: zoom, left: paint");
+    ImGui::Combo("Brush", &m_BrushTile, [](void*, int index, const char** name) {
+      *name = s_Tiles[index].Name;
+      return true;
+    }, nullptr, s_TileCount);
+    ImGui::SliderInt("Brush radius", &m_BrushRadius, 0, 32);
+    ImGui::SliderFloat("Zoom", &m_Zoom, 1.0f / 64.0f, 8.0f, "%.3f", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderInt("Random edits/frame", &m_RandomEdits, 0, 10000, "%d", ImGuiSliderFlags_Logarithmic);
+    ImGui::Checkbox("Rebake every visible chunk", &m_RebakeAll);
+    if (ImGui::Button("New map"))
+      GenerateMap(++m_Seed);
+    HandleInput();
+
+    const TilemapStats& stats = m_Map->GetStats();
+    RenderStats renderStats = Renderer::GetStats();
+    float framerate = ImGui::GetIO().Framerate;
+    ImGui::Separator();
+    ImGui::Text("Map: %ux%u tiles in %ux%u chunks", m_Map->GetWidth(), m_Map->GetHeight(), Tilemap::ChunkSize, Tilemap::ChunkSize);
+    ImGui::Text("Visible chunks: %u, tiles drawn: %u", stats.VisibleChunks, stats.DrawnTiles);
+    ImGui::Text("Baked this frame: %u (%u pending)", stats.BakedChunks, stats.PendingChunks);
+    ImGui::Text("Cull + bake: %.3f ms  generate: %.0f ms", stats.BakeTime, m_GenerateTime);
+    ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / framerate, framerate);
+    ImGui::Text("Draws/frame: %u", renderStats.DrawCalls);
+  }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Test.h"
+#include "Tilemap.h"
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+
+#include <memory>
+#include <random>
+
+namespace test
+{
+  // A generated 4096x4096 island map drawn through a chunked Tilemap. Drag
+  // with the right mouse button to pan, scroll to zoom and paint tiles with
+  // the left button; random edits per frame and rebaking every visible chunk
+  // show what the incremental rebuild saves.
+  class TestTilemap : public Test
+  {
+  public:
+    TestTilemap();
+    ~TestTilemap();
+
+    void OnUpdate(float deltaTime) override;
+    void OnRender(float alpha) override;
+    void OnImGuiRender() override;
+    bool SupportsRenderThread() const override { return true; }
+  private:
+    void GenerateMap(unsigned int seed);
+    void HandleInput();
+    void Paint(const glm::ivec2& center);
+    glm::vec2 ScreenToWorld(const glm::vec2& screen) const;
+    glm::mat4 GetViewProj() const;
+
+    std::unique_ptr<Texture> m_Tileset;
+    std::unique_ptr<Tilemap> m_Map;
+    std::mt19937 m_Random;
+
+    glm::vec2 m_Camera;
+    // pixels per world unit
+    float m_Zoom;
+    int m_BrushTile;
+    int m_BrushRadius;
+    int m_RandomEdits;
+    bool m_RebakeAll;
+    unsigned int m_Seed;
+    float m_GenerateTime;
+  };
+}
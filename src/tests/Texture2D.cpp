@@ -4,36 +4,41 @@
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 namespace test{
+  static const float s_Positions[] = {
+        100.0f, 100.0f, 0.0f, 0.0f, // 0
+        200.0f, 100.0f, 1.0f, 0.0f,  // 1
+        200.0f, 200.0f, 1.0f, 1.0f,    // 2
+        100.0f, 200.0f, 0.0f, 1.0f   // 3
+  };
+
+  static const unsigned int s_Indices[] = {
+      0, 1, 2,
+      2, 3, 0
+  };
+
   Texture2D::Texture2D():
+     m_IndexBuffer(s_Indices, 6),
+     m_VertexBuffer(s_Positions, 4 * 4 * sizeof(float)),
+     // one Affine2D per instance, as two vec3 rows
+     m_InstanceBuffer(2 * (unsigned int)sizeof(Affine2D)),
+     m_Shader("res/shaders/Affine.shader"),
+     m_Texture("res/textures/ChernoLogo.png"),
      m_Proj(glm::ortho(0.0f, 960.0f, 0.0f, 720.0f, -1.0f, 1.0f)),
-    m_View(glm::translate(glm::mat4(1.0f), glm::vec3(-100, 0, 0))),
-    m_TranslationA(glm::vec3(200, 200, 0)), m_TranslationB(glm::vec3(400, 200, 0))
+    m_View(Affine2D::Translation(glm::vec2(-100, 0))),
+    m_TranslationA(glm::vec2(200, 200)), m_TranslationB(glm::vec2(400, 200))
   {
-    float positions[] = {
-          100.0f, 100.0f, 0.0f, 0.0f, // 0
-          200.0f, 100.0f, 1.0f, 0.0f,  // 1
-          200.0f, 200.0f, 1.0f, 1.0f,    // 2
-          100.0f, 200.0f, 0.0f, 1.0f   // 3
-    };
-
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0
-    };
-
-    m_VAO = std::make_unique<  VertexArray>(); 
-    m_VertexBuffer =std::make_unique< VertexBuffer>(positions, 4 * 4 * sizeof(float));
     VertexBufferLayout layout;
     layout.Push<float>(2);//vertex
     layout.Push<float>(2);//normal
-    m_VAO->AddBuffer(*m_VertexBuffer, layout);
-   m_IndexBuffer=std::make_unique< IndexBuffer> (indices, 6);
-
-    m_Shader = std::make_unique<Shader>("res/shaders/Basic.shader");
-    m_Shader->Bind();
-    m_Shader->SetUniform1i("u_Texture",0);
-
-    m_Texture = std::make_unique<Texture>("res/textures/ChernoLogo.png");
+    m_VAO.AddBuffer(m_VertexBuffer, layout);
+    VertexBufferLayout instanceLayout;
+    instanceLayout.Push<float>(3);
+    instanceLayout.Push<float>(3);
+    m_VAO.AddBuffer(m_InstanceBuffer, instanceLayout, 1);
+
+    m_Shader.Bind();
+    m_Shader.SetUniform1i("u_Texture",0);
+    m_Shader.SetUniformMat4f("u_ViewProj", m_Proj);
   }
 
   Texture2D::~Texture2D()
@@ -46,33 +51,22 @@ namespace test{
 
   }
 
-  void Texture2D::OnRender()
+  void Texture2D::OnRender(float alpha)
   {
     Renderer renderer;
-    m_Texture->Bind();
-
-    {
-      glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationA);
-      glm::mat4 mvp = m_Proj * m_View * model;
+    m_Texture.Bind();
 
-      m_Shader->Bind();
-      m_Shader->SetUniformMat4f("u_MVP", mvp);
-      renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
-    }
-    {
-      glm::mat4 model = glm::translate(glm::mat4(1.0f), m_TranslationB);
-      glm::mat4 mvp = m_Proj * m_View * model;
+    Affine2D models[2] = { Affine2D::Translation(m_TranslationA), Affine2D::Translation(m_TranslationB) };
+    Affine2D::Compose(m_View, models, models, 2);
+    m_InstanceBuffer.SetData(models, sizeof(models));
 
-      m_Shader->Bind();
-      m_Shader->SetUniformMat4f("u_MVP", mvp);
-      renderer.Draw(*m_VAO, *m_IndexBuffer, *m_Shader);
-    }
+    renderer.DrawInstanced(m_VAO, m_IndexBuffer, m_Shader, 2);
   }
 
   void Texture2D::OnImGuiRender()
   {
-    ImGui::SliderFloat3("m_TranslationA", &m_TranslationA.x, 0.0f, 960.0f);
-    ImGui::SliderFloat3("m_TranslationB", &m_TranslationB.x, 0.0f, 960.0f);
+    ImGui::SliderFloat2("m_TranslationA", &m_TranslationA.x, 0.0f, 960.0f);
+    ImGui::SliderFloat2("m_TranslationB", &m_TranslationB.x, 0.0f, 960.0f);
     ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
   }
 }
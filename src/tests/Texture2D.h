@@ -1,10 +1,10 @@
 #pragma once
 #include "Test.h"
-#include <memory>
 #include "Texture.h"
 #include "VertexBuffer.h"
 #include "VertexBufferLayout.h"
 #include "Renderer.h"
+#include "Affine2D.h"
 
 namespace test{
 class Texture2D :
@@ -15,17 +15,19 @@ public:
   ~Texture2D();
 public:
   void OnUpdate(float deltaTime);
-  void OnRender();
+  void OnRender(float alpha);
   void OnImGuiRender();
 
 private:
-  std::unique_ptr<VertexArray> m_VAO;
-  std::unique_ptr<IndexBuffer> m_IndexBuffer;
-  std::unique_ptr<VertexBuffer> m_VertexBuffer;
- std::unique_ptr< Shader> m_Shader;
- std::unique_ptr< Texture> m_Texture;
+  VertexArray m_VAO;
+  IndexBuffer m_IndexBuffer;
+  VertexBuffer m_VertexBuffer;
+  VertexBuffer m_InstanceBuffer;
+  Shader m_Shader;
+  Texture m_Texture;
 
- glm::mat4 m_Proj, m_View;
-  glm::vec3 m_TranslationA, m_TranslationB;
+ glm::mat4 m_Proj;
+ Affine2D m_View;
+  glm::vec2 m_TranslationA, m_TranslationB;
 };
 }